@@ -5,7 +5,9 @@
 #define _BBLOCK_H_
 
 #include <cassert>
-#include <list>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 #include "ADT/DGContainer.h"
 #include "analysis/legacy/Analysis.h"
@@ -50,7 +52,7 @@ public:
     };
 
     BBlock<NodeT>(NodeT *head = nullptr, DependenceGraphT *dg = nullptr)
-        : key(KeyT()), dg(dg), ipostdom(nullptr), slice_id(0)
+        : key(KeyT()), dg(dg), slice_id(0)
     {
         if (head) {
             append(head);
@@ -90,8 +92,8 @@ public:
     void setDG(DependenceGraphT *d) { dg = d; }
     DependenceGraphT *getDG() const { return dg; }
 
-    const std::list<NodeT *>& getNodes() const { return nodes; }
-    std::list<NodeT *>& getNodes() { return nodes; }
+    const std::vector<NodeT *>& getNodes() const { return nodes; }
+    std::vector<NodeT *>& getNodes() { return nodes; }
     bool empty() const { return nodes.empty(); }
     size_t size() const { return nodes.size(); }
 
@@ -108,7 +110,7 @@ public:
         assert(n && "Cannot add null node to BBlock");
 
         n->setBasicBlock(this);
-        nodes.push_front(n);
+        nodes.insert(nodes.begin(), n);
     }
 
     bool hasControlDependence() const
@@ -241,7 +243,10 @@ public:
         delete this;
     }
 
-    void removeNode(NodeT *n) { nodes.remove(n); }
+    void removeNode(NodeT *n)
+    {
+        nodes.erase(std::remove(nodes.begin(), nodes.end(), n), nodes.end());
+    }
 
     size_t successorsNum() const { return nextBBs.size(); }
     size_t predecessorsNum() const { return prevBBs.size(); }
@@ -350,54 +355,69 @@ public:
         return nodes.back();
     }
 
-    // XXX: do this optional?
-    BBlockContainerT& getPostDomFrontiers() { return postDomFrontiers; }
-    const BBlockContainerT& getPostDomFrontiers() const { return postDomFrontiers; }
+    // The dominance information is allocated only when some
+    // analysis (e.g. the computation of control dependencies
+    // from post-dominance frontiers) stores it into the block.
+    // Until then, the getters return empty containers.
+    const BBlockContainerT& getPostDomFrontiers() const
+    {
+        return domInfo ? domInfo->postDomFrontiers : emptyBlocks();
+    }
 
     bool addPostDomFrontier(BBlock<NodeT> *BB)
     {
-        return postDomFrontiers.insert(BB);
+        return getDomInfo().postDomFrontiers.insert(BB);
     }
 
     bool addDomFrontier(BBlock<NodeT> *DF)
     {
-        return domFrontiers.insert(DF);
+        return getDomInfo().domFrontiers.insert(DF);
     }
 
-    BBlockContainerT& getDomFrontiers() { return domFrontiers; }
-    const BBlockContainerT& getDomFrontiers() const { return domFrontiers; }
+    const BBlockContainerT& getDomFrontiers() const
+    {
+        return domInfo ? domInfo->domFrontiers : emptyBlocks();
+    }
 
     void setIPostDom(BBlock<NodeT> *BB)
     {
-        assert(!ipostdom && "Already has the immedate post-dominator");
-        ipostdom = BB;
-        BB->postDominators.insert(this);
+        assert(!getIPostDom() && "Already has the immedate post-dominator");
+        getDomInfo().ipostdom = BB;
+        BB->getDomInfo().postDominators.insert(this);
     }
 
-    BBlock<NodeT> *getIPostDom() { return ipostdom; }
-    const BBlock<NodeT> *getIPostDom() const { return ipostdom; }
+    BBlock<NodeT> *getIPostDom() const
+    {
+        return domInfo ? domInfo->ipostdom : nullptr;
+    }
 
-    BBlockContainerT& getPostDominators() { return postDominators; }
-    const BBlockContainerT& getPostDominators() const { return postDominators; }
+    const BBlockContainerT& getPostDominators() const
+    {
+        return domInfo ? domInfo->postDominators : emptyBlocks();
+    }
 
     void setIDom(BBlock<NodeT>* BB)
     {
-        assert(!idom && "Already has immediate dominator");
-        idom = BB;
+        assert(!getIDom() && "Already has immediate dominator");
+        getDomInfo().idom = BB;
         BB->addDominator(this);
     }
 
     void addDominator(BBlock<NodeT>* BB)
     {
         assert( BB && "need dominator bblock" );
-        dominators.insert(BB);
+        getDomInfo().dominators.insert(BB);
     }
 
-    BBlock<NodeT> *getIDom() { return idom; }
-    const BBlock<NodeT> *getIDom() const { return idom; }
+    BBlock<NodeT> *getIDom() const
+    {
+        return domInfo ? domInfo->idom : nullptr;
+    }
 
-    BBlockContainerT& getDominators() { return dominators; }
-    const BBlockContainerT& getDominators() const { return dominators; }
+    const BBlockContainerT& getDominators() const
+    {
+        return domInfo ? domInfo->dominators : emptyBlocks();
+    }
 
     unsigned int getDFSOrder() const
     {
@@ -451,7 +471,7 @@ private:
     DependenceGraphT *dg;
 
     // nodes contained in this bblock
-    std::list<NodeT *> nodes;
+    std::vector<NodeT *> nodes;
 
     SuccContainerT nextBBs;
     PredContainerT prevBBs;
@@ -462,19 +482,37 @@ private:
     BBlockContainerT controlDeps;
     BBlockContainerT revControlDeps;
 
-    // post-dominator frontiers
-    BBlockContainerT postDomFrontiers;
-    BBlock<NodeT> *ipostdom;
-    // the post-dominator tree edges
-    // (reverse to immediate post-dominator)
-    BBlockContainerT postDominators;
-
-    // parent of @this in dominator tree
-    BBlock<NodeT> *idom = nullptr;
-    // BB.dominators = all children in dominator tree
-    BBlockContainerT dominators;
-    // dominance frontiers
-    BBlockContainerT domFrontiers;
+    struct DominanceInfo {
+        // post-dominator frontiers
+        BBlockContainerT postDomFrontiers;
+        BBlock<NodeT> *ipostdom{nullptr};
+        // the post-dominator tree edges
+        // (reverse to immediate post-dominator)
+        BBlockContainerT postDominators;
+
+        // parent of @this in dominator tree
+        BBlock<NodeT> *idom{nullptr};
+        // BB.dominators = all children in dominator tree
+        BBlockContainerT dominators;
+        // dominance frontiers
+        BBlockContainerT domFrontiers;
+    };
+
+    // (post-)dominance information, allocated on demand
+    std::unique_ptr<DominanceInfo> domInfo;
+
+    DominanceInfo& getDomInfo()
+    {
+        if (!domInfo)
+            domInfo.reset(new DominanceInfo());
+        return *domInfo;
+    }
+
+    static const BBlockContainerT& emptyBlocks()
+    {
+        static const BBlockContainerT empty;
+        return empty;
+    }
 
     // is this block in some slice?
     uint64_t slice_id;
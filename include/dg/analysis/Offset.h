@@ -1,6 +1,7 @@
 #ifndef _DG_OFFSET_H_
 #define _DG_OFFSET_H_
 
+#include <cassert>
 #include <cstdint>
 
 #ifndef NDEBUG
@@ -13,6 +14,14 @@ namespace analysis {
 // just a wrapper around uint64_t to
 // handle Offset::UNKNOWN somehow easily
 // maybe later we'll make it a range
+//
+// Besides concrete numbers and Offset::UNKNOWN, the offset can be
+// strided: the set of offsets k*stride + elemOffset (k >= 0), i.e.,
+// the offset 'elemOffset' in any element of an array of elements
+// of the size 'stride'. Strided offsets are created by GEPs with
+// variable indices, so that a[i].next and a[i].data are different
+// offsets. For everybody who does not handle strided offsets
+// explicitly, they are just unknown offsets (isUnknown() is true).
 struct Offset
 {
     using type = uint64_t;
@@ -20,6 +29,12 @@ struct Offset
     // the value used for the unknown offset
     static const type UNKNOWN;
 
+    // strided offsets are encoded in the numbers with the two highest
+    // bits '10' (so that they do not collide with negative offsets
+    // that we get from LLVM as huge unsigned numbers):
+    // 2 bits of tag | 30 bits of stride | 32 bits of offset in element
+    static const type MAX_STRIDE = (static_cast<type>(1) << 30) - 1;
+
     static Offset getUnknown() {
         return Offset(Offset::UNKNOWN);
     }
@@ -28,6 +43,24 @@ struct Offset
         return Offset(0);
     }
 
+    // get the offset 'elemOffset' in any element of size 'stride'.
+    // Stride 0 means that there is only one element (the offset is
+    // concrete) and stride 1 means that the offset can be anything.
+    static Offset getStrided(type stride, type elemOffset) {
+        if (stride == 0)
+            return Offset(elemOffset);
+        if (stride == 1 || stride > MAX_STRIDE)
+            return Offset(UNKNOWN);
+
+        return Offset(STRIDED_TAG | (stride << 32) | modulo(elemOffset, stride));
+    }
+
+    // the least strided offset, all strided offsets are greater
+    // than non-negative concrete offsets
+    static Offset getStridedBegin() {
+        return Offset(STRIDED_TAG);
+    }
+
     // cast to type
     //operator type() { return offset; }
 
@@ -36,8 +69,18 @@ struct Offset
 
     Offset operator+(const Offset o) const
     {
-        if (offset == UNKNOWN || o.offset == UNKNOWN ||
-            offset >= UNKNOWN - o.offset) {
+        if (offset == UNKNOWN || o.offset == UNKNOWN)
+            return UNKNOWN;
+
+        // (k*s1 + e1) + (l*s2 + e2) is e1 + e2 modulo gcd(s1, s2)
+        if (isStrided() || o.isStrided()) {
+            type stride = gcd(getStride(), o.getStride());
+            return getStrided(stride, modulo(getValue(), stride) +
+                                      modulo(o.getValue(), stride));
+        }
+
+        if (offset >= UNKNOWN - o.offset ||
+            Offset(offset + o.offset).isStrided()) {
             return UNKNOWN;
         }
 
@@ -46,13 +89,7 @@ struct Offset
 
     Offset& operator+=(const Offset o)
     {
-        if (offset == UNKNOWN || o.offset == UNKNOWN ||
-            offset >= UNKNOWN - o.offset) {
-            offset = UNKNOWN;
-        } else {
-            offset += o.offset;
-        }
-
+        *this = *this + o;
         return *this;
     }
 
@@ -64,7 +101,7 @@ struct Offset
 
     Offset operator-(const Offset& o) const
     {
-        if (offset == UNKNOWN || o.offset == UNKNOWN ||
+        if (isUnknown() || o.isUnknown() ||
             offset < o.offset) {
             return Offset(UNKNOWN);
         }
@@ -74,7 +111,7 @@ struct Offset
 
     Offset& operator-(const Offset& o)
     {
-        if (offset == UNKNOWN || o.offset == UNKNOWN ||
+        if (isUnknown() || o.isUnknown() ||
             offset < o.offset) {
             offset = UNKNOWN;
         } else {
@@ -85,15 +122,13 @@ struct Offset
 
     Offset& operator~()
     {
-        if (offset != UNKNOWN) {
-            offset = ~offset;
-        }
+        offset = isUnknown() ? UNKNOWN : ~offset;
         return *this;
     }
 
     Offset operator~() const
     {
-        if (offset != UNKNOWN) {
+        if (!isUnknown()) {
             return Offset(~offset);
         }
         return Offset::UNKNOWN;
@@ -134,15 +169,42 @@ struct Offset
         return (offset >= from && offset <= to);
     }
 
-    bool isUnknown() const { return offset == UNKNOWN; }
+    // is the offset not a concrete number?
+    // (Offset::UNKNOWN or a strided offset)
+    bool isUnknown() const { return offset == UNKNOWN || isStrided(); }
     bool isZero() const { return offset == 0; }
 
+    bool isStrided() const { return (offset >> 62) == 2; }
+    // the stride of a strided offset, 0 for other offsets
+    type getStride() const {
+        return isStrided() ? (offset >> 32) & MAX_STRIDE : 0;
+    }
+    // the offset in an element of a strided offset
+    type getElementOffset() const {
+        assert(isStrided() && "Not a strided offset");
+        return offset & 0xffffffff;
+    }
+
+    // may the offsets be the same number? This is used
+    // to match accesses with strided offsets to the memory
+    bool mayBeEqual(const Offset& o) const {
+        if (offset == UNKNOWN || o.offset == UNKNOWN)
+            return true;
+        if (!isStrided() && !o.isStrided())
+            return offset == o.offset;
+
+        type stride = gcd(getStride(), o.getStride());
+        return modulo(getValue(), stride) == modulo(o.getValue(), stride);
+    }
+
     type operator*() const { return offset; }
     const type *operator->() const { return &offset; }
 
 #ifndef NDEBUG
     void dump() const {
-        if (isUnknown())
+        if (isStrided())
+            std::cout << "k*" << getStride() << " + " << getElementOffset();
+        else if (isUnknown())
             std::cout << "Offset::UNKNOWN";
         else
             std::cout << offset;
@@ -151,6 +213,32 @@ struct Offset
 
 
     type offset;
+
+private:
+    static const type STRIDED_TAG = static_cast<type>(2) << 62;
+
+    // the offset in element for strided offsets, the number otherwise
+    type getValue() const {
+        return isStrided() ? getElementOffset() : offset;
+    }
+
+    // 'v' modulo 's' where 'v' may be a negative offset
+    // (a huge unsigned number)
+    static type modulo(type v, type s) {
+        if (s == 0)
+            return v;
+        int64_t r = static_cast<int64_t>(v) % static_cast<int64_t>(s);
+        return static_cast<type>(r < 0 ? r + static_cast<int64_t>(s) : r);
+    }
+
+    static type gcd(type a, type b) {
+        while (b != 0) {
+            type t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
 };
 
 } // namespace analysis
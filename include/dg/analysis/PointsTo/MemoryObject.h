@@ -28,6 +28,13 @@ struct MemoryObject
     PSNode *node;
     // possible pointers stored in this memory object
     PointsToMapT pointsTo;
+    // incremented on every change of the points-to map, so that
+    // the analysis can cheaply find out whether the object has
+    // changed since the last time it looked at it.
+    // NOTE: if you modify 'pointsTo' directly, call touch()
+    size_t version{0};
+
+    void touch() { ++version; }
 
     PointsToSetT& getPointsTo(const Offset off) { return pointsTo[off]; }
 
@@ -52,6 +59,8 @@ struct MemoryObject
             changed |= pointsTo[rit.first].add(rit.second);
         }
 
+        if (changed)
+            touch();
         return changed;
     }
 
@@ -60,14 +69,22 @@ struct MemoryObject
         assert(ptr.target != nullptr
                && "Cannot have NULL target, use unknown instead");
 
-        return pointsTo[off].add(ptr);
+        if (pointsTo[off].add(ptr)) {
+            touch();
+            return true;
+        }
+        return false;
     }
 
     bool addPointsTo(const Offset& off, const PointsToSetT& pointers)
     {
         if (pointers.empty())
             return false;
-        return pointsTo[off].add(pointers);
+        if (pointsTo[off].add(pointers)) {
+            touch();
+            return true;
+        }
+        return false;
     }
 
     bool addPointsTo(const Offset& off,
@@ -75,7 +92,11 @@ struct MemoryObject
     {
         if (pointers.size() == 0)
             return false;
-        return pointsTo[off].add(pointers);
+        if (pointsTo[off].add(pointers)) {
+            touch();
+            return true;
+        }
+        return false;
     }
 
 #ifndef NDEBUG
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstdarg>
 #include <string>
+#include <vector>
 #include <iostream>
 
 #ifndef NDEBUG
@@ -365,6 +366,7 @@ public:
 
     // FIXME: maybe get rid of these friendships?
     friend class PointerAnalysis;
+    template <typename AnalysisT> friend class PointerAnalysisSolver;
     friend class PointerGraph;
 
     friend void getNodes(std::set<PSNode *>& cont, PSNode *n, PSNode* exit, unsigned int dfsnum);
@@ -399,6 +401,29 @@ class PSNodeAlloc : public PSNode {
     // is it a temporary value? (its address cannot be taken)
     bool is_temporary = false;
 
+public:
+    // a pointer that is stored in the memory from the beginning
+    // (e.g., from the initializer of a global variable).
+    // The pointer is stored at 'count' offsets starting at 'offset'
+    // and 'stride' bytes apart, so that large tables of the same
+    // pointers take only one entry.
+    struct InitialPointer {
+        Offset offset;
+        Offset stride;
+        uint64_t count;
+        Pointer pointer;
+
+        InitialPointer(Offset off, Offset str, uint64_t cnt, const Pointer& ptr)
+        : offset(off), stride(str), count(cnt), pointer(ptr) {}
+    };
+
+private:
+    std::vector<InitialPointer> initialPointers;
+
+    // the allocation sites that this node represents
+    // (if several allocation sites were merged into one object)
+    std::vector<PSNodeAlloc *> summarizedSites;
+
 public:
     PSNodeAlloc(unsigned id, bool isTemp = false)
     : PSNode(id, PSNodeType::ALLOC), is_temporary(isTemp) {
@@ -423,6 +448,28 @@ public:
 
     void setIsTemporary() { is_temporary = true; }
     bool isTemporary() const { return is_temporary; }
+
+    void addInitialPointer(Offset off, const Pointer& ptr,
+                           Offset stride = 0, uint64_t count = 1) {
+        initialPointers.emplace_back(off, stride, count, ptr);
+    }
+
+    const std::vector<InitialPointer>& getInitialPointers() const {
+        return initialPointers;
+    }
+
+    std::vector<InitialPointer>& getInitialPointers() {
+        return initialPointers;
+    }
+
+    // the object of a summary node stands for more objects
+    // in run-time, so it can not be strongly updated
+    void addSummarizedSite(PSNodeAlloc *site) { summarizedSites.push_back(site); }
+    bool isSummary() const { return !summarizedSites.empty(); }
+
+    const std::vector<PSNodeAlloc *>& getSummarizedSites() const {
+        return summarizedSites;
+    }
 };
 
 #if 0
@@ -3,6 +3,8 @@
 
 #include <cassert>
 #include <vector>
+#include <map>
+#include <tuple>
 
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/PointsTo/MemoryObject.h"
@@ -37,6 +39,22 @@ protected:
 
     const PointerAnalysisOptions options{};
 
+    // add the pointers that are in the memory of the allocation
+    // from the beginning (initializers of global variables)
+    static void addInitialPointers(MemoryObject *mo, const PSNode *node) {
+        const PSNodeAlloc *alloc = PSNodeAlloc::get(node);
+        if (!alloc)
+            return;
+
+        for (const auto& ip : alloc->getInitialPointers()) {
+            Offset off = ip.offset;
+            for (uint64_t i = 0; i < ip.count; ++i) {
+                mo->addPointsTo(off, ip.pointer);
+                off += ip.stride;
+            }
+        }
+    }
+
 public:
 
     PointerAnalysis(PointerGraph *ps,
@@ -50,32 +68,6 @@ public:
 
     virtual ~PointerAnalysis() {}
 
-    // takes a PSNode 'where' and 'what' and reference to a vector
-    // and fills into the vector the objects that are relevant
-    // for the PSNode 'what' (valid memory states for of this PSNode)
-    // on location 'where' in PointerGraph
-    virtual void getMemoryObjects(PSNode *where, const Pointer& pointer,
-                                  std::vector<MemoryObject *>& objects) = 0;
-
-    /*
-    virtual bool addEdge(MemoryObject *from, MemoryObject *to,
-                         Offset off1 = 0, Offset off2 = 0)
-    {
-        return false;
-    }
-    */
-
-    /* hooks for analysis - optional. The analysis may do everything
-     * in getMemoryObjects, but spliting it into before-get-after sequence
-     * is more readable */
-    virtual bool beforeProcessed(PSNode *) {
-        return false;
-    }
-
-    virtual bool afterProcessed(PSNode *) {
-        return false;
-    }
-
     PointerGraph *getPS() const { return PS; }
 
 
@@ -102,21 +94,9 @@ public:
         }
     }
 
-    bool iteration() {
-        assert(changed.empty());
-
-        for (PSNode *cur : to_process) {
-            bool enq = false;
-            enq |= beforeProcessed(cur);
-            enq |= processNode(cur);
-            enq |= afterProcessed(cur);
-
-            if (enq)
-                enqueue(cur);
-        }
-
-        return !changed.empty();
-    }
+    // process the nodes in to_process, return true if some
+    // node has changed. Implemented by PointerAnalysisSolver.
+    virtual bool iteration() = 0;
 
     void queue_changed() {
         unsigned last_processed_num = to_process.size();
@@ -138,6 +118,11 @@ public:
 
     void run();
 
+    // statistics of the last run(): the number of iterations
+    // of the fixpoint loop and the number of processed nodes
+    unsigned getIterationsNum() const { return iterationsNum; }
+    size_t getProcessedNodesNum() const { return processedNodesNum; }
+
     // generic error
     // @msg - message for the user
     // XXX: maybe create some enum that will represent the error
@@ -181,17 +166,81 @@ public:
 
 private:
 
+    unsigned iterationsNum{0};
+    size_t processedNodesNum{0};
+
     // check the sanity of results of pointer analysis
     void sanityCheck();
+};
+
+///
+// The core of the pointer analysis (processing of the nodes).
+// It is parametrized by the analysis that derives from it (CRTP),
+// so that the calls of the methods of the analysis are resolved
+// statically. The analysis must define the method
+//
+//   void getMemoryObjects(PSNode *where, const Pointer& pointer,
+//                         std::vector<MemoryObject *>& objects)
+//
+// that fills into the vector the memory objects that are relevant
+// for the 'pointer' on location 'where' in PointerGraph, and it may
+// define the hooks beforeProcessed() and afterProcessed().
+//
+// The methods are defined in PointerAnalysis.cpp and instantiated
+// there for PointerAnalysisFI, PointerAnalysisFS, PointerAnalysisFSInv
+// and PointerAnalysisHybrid.
+template <typename AnalysisT>
+class PointerAnalysisSolver : public PointerAnalysis
+{
+public:
+    PointerAnalysisSolver(PointerGraph *ps,
+                          const PointerAnalysisOptions& opts)
+    : PointerAnalysis(ps, opts) {}
+
+    PointerAnalysisSolver(PointerGraph *ps) : PointerAnalysis(ps) {}
+
+    /* hooks for analysis - optional. The analysis may do everything
+     * in getMemoryObjects, but spliting it into before-get-after sequence
+     * is more readable */
+    bool beforeProcessed(PSNode *) { return false; }
+    bool afterProcessed(PSNode *) { return false; }
+
+    bool iteration() override;
+
+private:
+    AnalysisT *analysis() { return static_cast<AnalysisT *>(this); }
+
+    // the vectors for memory objects that are reused
+    // in the processing of every node
+    std::vector<MemoryObject *> objects;
+    std::vector<MemoryObject *> srcObjects;
+    std::vector<MemoryObject *> destObjects;
+
+    // (source object, destination object, source offset,
+    //  destination offset, length) of a propagation in memcpy
+    using MemcpyKeyT = std::tuple<const MemoryObject *, const MemoryObject *,
+                                  Offset, Offset, Offset>;
+    // the version of the source object that was completely
+    // propagated in the given memcpy
+    std::map<MemcpyKeyT, size_t> memcpyDone;
+
+    // the number of different offsets that a GEP on a loop
+    // created into the target, see gepWideningThreshold
+    std::map<std::pair<const PSNode *, const PSNode *>, unsigned> gepOffsetsNum;
 
     bool processNode(PSNode *);
     bool processLoad(PSNode *node);
+    bool loadStrided(PSNode *node, MemoryObject *o,
+                     const Offset& offset, PSNodeAlloc *target);
     bool processGep(PSNode *node);
+    Offset getStridedOffset(const Pointer& ptr, const Offset& gepOffset) const;
+    bool widenGep(PSNode *node, PSNode *target) const;
     bool processMemcpy(PSNode *node);
-    bool processMemcpy(std::vector<MemoryObject *>& srcObjects,
-                       std::vector<MemoryObject *>& destObjects,
-                       const Pointer& sptr, const Pointer& dptr,
-                       Offset len);
+    bool processMemcpy(const Pointer& sptr, const Pointer& dptr, Offset len);
+    bool memcpyPointers(MemoryObject *destO,
+                        const MemoryObject *so,
+                        Offset srcOffset, Offset destOffset,
+                        Offset len);
 };
 
 } // namespace pta
@@ -14,7 +14,7 @@ namespace pta {
 ///
 // Flow-insensitive inclusion-based pointer analysis
 //
-class PointerAnalysisFI : public PointerAnalysis
+class PointerAnalysisFI : public PointerAnalysisSolver<PointerAnalysisFI>
 {
     std::vector<std::unique_ptr<MemoryObject>> memory_objects;
 
@@ -24,13 +24,15 @@ class PointerAnalysisFI : public PointerAnalysis
         // then every GEP that is also stored to the same memory afterwards
         // in the loop will end up with Offset::UNKNOWN after some
         // number of iterations (in FI analysis), so we can do that right now
-        // and save iterations
+        // and save iterations. GEPs with strided offsets (variable indices)
+        // do not create new offsets, so these are kept.
 
         assert(getPS() && "Must have PG");
         for (auto& sg : getPS()->getSubgraphs()) {
             for (auto& loop : sg->getLoops()) {
                 for (PSNode *n : loop) {
-                    if (PSNodeGep *gep = PSNodeGep::get(n))
+                    PSNodeGep *gep = PSNodeGep::get(n);
+                    if (gep && !gep->getOffset().isStrided())
                         gep->setOffset(Offset::UNKNOWN);
                 }
             }
@@ -39,7 +41,7 @@ class PointerAnalysisFI : public PointerAnalysis
 
 public:
     PointerAnalysisFI(PointerGraph *ps)
-    : PointerAnalysis(ps) {
+    : PointerAnalysisSolver(ps) {
         memory_objects.reserve(std::max(ps->size() / 100, static_cast<size_t>(8)));
     }
 
@@ -49,7 +51,7 @@ public:
     }
 
     void getMemoryObjects(PSNode *where, const Pointer& pointer,
-                          std::vector<MemoryObject *>& objects) override
+                          std::vector<MemoryObject *>& objects)
     {
         // irrelevant in flow-insensitive
         (void) where;
@@ -74,12 +76,15 @@ public:
             mo = new MemoryObject(n);
             memory_objects.emplace_back(mo);
             n->setData<MemoryObject>(mo);
+            addInitialPointers(mo, n);
         }
 
         objects.push_back(mo);
     }
 };
 
+extern template class PointerAnalysisSolver<PointerAnalysisFI>;
+
 } // namespace pta
 } // namespace analysis
 } // namespace dg
@@ -3,18 +3,23 @@
 
 #include <cassert>
 #include <memory>
+#include <utility>
 
 #include "MemoryObject.h"
 #include "PointerGraph.h"
+#include "PointerAnalysis.h"
 
 namespace dg {
 namespace analysis {
 namespace pta {
 
 ///
-// Flow-sensitive pointer analysis
+// Flow-sensitive pointer analysis. The template parameter
+// is the analysis that derives from this class
+// (PointerAnalysisFS or PointerAnalysisFSInv), see PointerAnalysisSolver.
 //
-class PointerAnalysisFS : public PointerAnalysis
+template <typename AnalysisT>
+class PointerAnalysisFSBase : public PointerAnalysisSolver<AnalysisT>
 {
 public:
     //using MemoryObjectsSetT = std::set<MemoryObject *>;
@@ -22,9 +27,9 @@ public:
 
     // this is an easy but not very efficient implementation,
     // works for testing
-    PointerAnalysisFS(PointerGraph *ps,
-                      PointerAnalysisOptions opts)
-    : PointerAnalysis(ps, opts.setPreprocessGeps(false))
+    PointerAnalysisFSBase(PointerGraph *ps,
+                          PointerAnalysisOptions opts)
+    : PointerAnalysisSolver<AnalysisT>(ps, opts.setPreprocessGeps(false))
     {
         assert(opts.preprocessGeps == false
                && "Preprocessing GEPs does not work correctly for FS analysis");
@@ -32,23 +37,23 @@ public:
         ps->computeLoops();
     }
 
-    PointerAnalysisFS(PointerGraph *ps) : PointerAnalysisFS(ps, {}) {}
+    PointerAnalysisFSBase(PointerGraph *ps) : PointerAnalysisFSBase(ps, {}) {}
 
-    bool beforeProcessed(PSNode *n) override
+    bool beforeProcessed(PSNode *n)
     {
         MemoryMapT *mm = n->getData<MemoryMapT>();
         if (mm)
             return false;
 
         // on these nodes the memory map can change
-        if (needsMerge(n)) {
+        if (AnalysisT::needsMerge(n)) {
             mm = createMM();
 
             // if this is the root of the entry procedure,
             // we must propagate the points-to information
             // from the globals initialization
-            if (n == PS->getEntry()->getRoot()) {
-                mergeGlobalsState(mm, PS->getGlobals());
+            if (n == this->PS->getEntry()->getRoot()) {
+                mergeGlobalsState(mm, this->PS->getGlobals());
             }
         } else {
             // this node can not change the memory map,
@@ -68,7 +73,7 @@ public:
         return true;
     }
 
-    bool afterProcessed(PSNode *n) override
+    bool afterProcessed(PSNode *n)
     {
         bool changed = false;
         PointsToSetT *overwritten = nullptr;
@@ -90,7 +95,7 @@ public:
         // more of them (if there's just one predecessor
         // and this is not a store, the memory map couldn't
         // change, so we don't have to do that)
-        if (needsMerge(n)) {
+        if (AnalysisT::needsMerge(n)) {
             for (PSNode *p : n->getPredecessors()) {
                 if (MemoryMapT *pm = p->getData<MemoryMapT>()) {
                     // merge pm to mm (but only if pm was already created)
@@ -121,12 +126,12 @@ public:
     }
 
     bool functionPointerCall(PSNode *, PSNode *) override {
-        PS->computeLoops();
+        this->PS->computeLoops();
         return false;
     }
 
     void getMemoryObjects(PSNode *where, const Pointer& pointer,
-                          std::vector<MemoryObject *>& objects) override
+                          std::vector<MemoryObject *>& objects)
     {
         MemoryMapT *mm = where->getData<MemoryMapT>();
         assert(mm && "Node does not have memory map");
@@ -179,7 +184,9 @@ protected:
         bool changed = false;
 
         for (auto& fromIt : from->pointsTo) {
-            if (overwritten &&
+            // a store via a strided offset writes only one
+            // of the elements, so it does not overwrite anything
+            if (overwritten && !fromIt.first.isStrided() &&
                 overwritten->count(Pointer(node, fromIt.first)))
                 continue;
 
@@ -188,6 +195,8 @@ protected:
                 changed |= S.add(ptr);
         }
 
+        if (changed)
+            to->touch();
         return changed;
     }
 
@@ -229,6 +238,11 @@ protected:
 
             if (isOnLoop(ptr.target))
                 return true;
+
+            // merged allocation sites are many objects too
+            auto alloc = PSNodeAlloc::get(ptr.target);
+            if (alloc && alloc->isSummary())
+                return true;
         }
         return false;
 
@@ -241,11 +255,23 @@ protected:
                canChangeMM(n);
     }
 
-    void mergeGlobalsState(MemoryMapT *mm, decltype(PS->getGlobals())& globals) {
+    void mergeGlobalsState(MemoryMapT *mm, decltype(std::declval<const PointerGraph&>().getGlobals()) globals) {
         for (auto& glob : globals) {
             if (MemoryMapT *globmm = glob->getData<MemoryMapT>()) {
                 mergeMaps(mm, globmm, nullptr);
             }
+
+            // the pointers from the initializers of globals
+            // are not stored by any node
+            if (auto alloc = PSNodeAlloc::get(glob.get())) {
+                if (alloc->getInitialPointers().empty())
+                    continue;
+
+                std::unique_ptr<MemoryObject>& mo = (*mm)[alloc];
+                if (!mo)
+                    mo.reset(new MemoryObject(alloc));
+                this->addInitialPointers(mo.get(), alloc);
+            }
         }
     }
 
@@ -255,6 +281,17 @@ private:
     std::vector<std::unique_ptr<MemoryMapT>> memoryMaps;
 };
 
+class PointerAnalysisFS : public PointerAnalysisFSBase<PointerAnalysisFS>
+{
+public:
+    PointerAnalysisFS(PointerGraph *ps, PointerAnalysisOptions opts)
+    : PointerAnalysisFSBase(ps, opts) {}
+
+    PointerAnalysisFS(PointerGraph *ps) : PointerAnalysisFSBase(ps) {}
+};
+
+extern template class PointerAnalysisSolver<PointerAnalysisFS>;
+
 } // namespace pta
 } // namespace analysis
 } // namespace dg
@@ -8,8 +8,11 @@ namespace dg {
 namespace analysis {
 namespace pta {
 
-class PointerAnalysisFSInv : public PointerAnalysisFS
+class PointerAnalysisFSInv : public PointerAnalysisFSBase<PointerAnalysisFSInv>
 {
+    using FSBase = PointerAnalysisFSBase<PointerAnalysisFSInv>;
+    friend FSBase;
+
     static bool canInvalidateMM(PSNode *n) {
         return isa<PSNodeType::FREE>(n) ||
                isa<PSNodeType::INVALIDATE_OBJECT>(n) ||
@@ -17,7 +20,7 @@ class PointerAnalysisFSInv : public PointerAnalysisFS
     }
 
     static bool needsMerge(PSNode *n) {
-        return canInvalidateMM(n) || PointerAnalysisFS::needsMerge(n);
+        return canInvalidateMM(n) || FSBase::needsMerge(n);
     }
 
     static MemoryObject *getOrCreateMO(MemoryMapT *mm, PSNode *target) {
@@ -30,19 +33,19 @@ class PointerAnalysisFSInv : public PointerAnalysisFS
     }
 
 public:
-    using MemoryMapT = PointerAnalysisFS::MemoryMapT;
+    using MemoryMapT = FSBase::MemoryMapT;
 
     // this is an easy but not very efficient implementation,
     // works for testing
     PointerAnalysisFSInv(PointerGraph *ps,
                            PointerAnalysisOptions opts)
-    : PointerAnalysisFS(ps, opts.setInvalidateNodes(true)) {}
+    : FSBase(ps, opts.setInvalidateNodes(true)) {}
 
     // default options
     PointerAnalysisFSInv(PointerGraph *ps) : PointerAnalysisFSInv(ps, {}) {}
 
-    // NOTE: we must override this method as it is using our "needsMerge"
-    bool beforeProcessed(PSNode *n) override
+    // NOTE: we must hide this method as it is using our "needsMerge"
+    bool beforeProcessed(PSNode *n)
     {
         MemoryMapT *mm = n->getData<MemoryMapT>();
         if (mm)
@@ -76,7 +79,7 @@ public:
         return true;
     }
 
-    bool afterProcessed(PSNode *n) override
+    bool afterProcessed(PSNode *n)
     {
         if (n->getType() == PSNodeType::INVALIDATE_LOCALS)
             return handleInvalidateLocals(n);
@@ -89,7 +92,7 @@ public:
                n->getType() != PSNodeType::INVALIDATE_OBJECT &&
                n->getType() != PSNodeType::INVALIDATE_LOCALS);
 
-        return PointerAnalysisFS::afterProcessed(n);
+        return FSBase::afterProcessed(n);
     }
 
     static bool isLocal(PSNodeAlloc *alloc, PSNode *where) {
@@ -232,7 +235,8 @@ public:
     // (allocations in loop or recursive calls may have
     // multiple instances)
     bool knownInstance(const PSNode *node) const {
-        return !isOnLoop(node);
+        auto alloc = PSNodeAlloc::get(node);
+        return !isOnLoop(node) && !(alloc && alloc->isSummary());
     }
 
     bool invStrongUpdate(const PSNode *operand) const {
@@ -410,6 +414,8 @@ public:
     }
 };
 
+extern template class PointerAnalysisSolver<PointerAnalysisFSInv>;
+
 } // namespace pta
 } // namespace analysis
 } // namespace dg
@@ -0,0 +1,210 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_HYBRID_H_
+#define _DG_ANALYSIS_POINTS_TO_HYBRID_H_
+
+#include <cassert>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "PointerAnalysisFS.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Pointer analysis that is flow-sensitive only in the given functions
+// (identified by the name in the ENTRY node of their subgraph).
+// The rest of the program (and the globals) share one flow-insensitive
+// state of the memory as in PointerAnalysisFI.
+//
+// The states meet on the boundaries of the flow-sensitive functions:
+// the memory maps of the flow-sensitive part are merged into
+// the flow-insensitive state on calls of flow-insensitive functions
+// and on returns to them, and the flow-insensitive state is merged
+// into the memory maps on the entry of a flow-sensitive function
+// called from the flow-insensitive part and on return from
+// a flow-insensitive function.
+class PointerAnalysisHybrid : public PointerAnalysisFSBase<PointerAnalysisHybrid>
+{
+    using FSBase = PointerAnalysisFSBase<PointerAnalysisHybrid>;
+    friend FSBase;
+
+    const std::set<std::string> fsFunctions;
+    std::unordered_map<const PointerSubgraph *, bool> fsSubgraphs;
+
+    // the memory of the flow-insensitive part, the key is the allocation
+    std::unordered_map<PSNode *, std::unique_ptr<MemoryObject>> fiObjects;
+
+    bool isFlowSensitive(PointerSubgraph *subg) {
+        // globals are not in any subgraph
+        if (!subg)
+            return false;
+
+        auto it = fsSubgraphs.find(subg);
+        if (it != fsSubgraphs.end())
+            return it->second;
+
+        // the subgraphs of functions called via pointers are built
+        // during the analysis, so decide lazily
+        auto entry = PSNodeEntry::get(subg->getRoot());
+        bool fs = entry && fsFunctions.count(entry->getFunctionName()) > 0;
+        fsSubgraphs.emplace(subg, fs);
+        return fs;
+    }
+
+    bool isFlowSensitive(PSNode *n) { return isFlowSensitive(n->getParent()); }
+
+    // the entries of the flow-sensitive functions always have their own
+    // memory map, the flow-insensitive state flows into them also
+    // from a single (e.g., fork) predecessor
+    static bool needsMerge(PSNode *n) {
+        return n->getType() == PSNodeType::ENTRY || FSBase::needsMerge(n);
+    }
+
+    MemoryObject *getFIObject(PSNode *target) {
+        auto& mo = fiObjects[target];
+        if (!mo) {
+            mo.reset(new MemoryObject(target));
+            addInitialPointers(mo.get(), target);
+        }
+        return mo.get();
+    }
+
+    // does the flow-insensitive state flow into the memory map of 'n'?
+    bool readsFIState(PSNode *n) {
+        if (auto E = PSNodeEntry::get(n)) {
+            if (n == PS->getEntry()->getRoot())
+                return true;
+            for (PSNode *caller : E->getCallers()) {
+                if (!isFlowSensitive(caller))
+                    return true;
+            }
+            // e.g., a fork in the flow-insensitive part
+            for (PSNode *pred : n->getPredecessors()) {
+                if (!isFlowSensitive(pred))
+                    return true;
+            }
+        } else if (auto CR = PSNodeCallRet::get(n)) {
+            for (PSNode *ret : CR->getReturns()) {
+                if (!isFlowSensitive(ret))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    // does the memory map of 'n' flow into the flow-insensitive part?
+    bool writesFIState(PSNode *n) {
+        if (auto C = PSNodeCall::get(n)) {
+            for (PointerSubgraph *callee : C->getCallees()) {
+                if (!isFlowSensitive(callee))
+                    return true;
+            }
+        } else if (auto R = PSNodeRet::get(n)) {
+            for (PSNode *site : R->getReturnSites()) {
+                if (!isFlowSensitive(site))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool mergeFIState(MemoryMapT *mm) {
+        bool changed = false;
+        for (auto& it : fiObjects) {
+            std::unique_ptr<MemoryObject>& mo = (*mm)[it.first];
+            if (!mo)
+                mo.reset(new MemoryObject(it.first));
+            changed |= mergeObjects(it.first, mo.get(), it.second.get(), nullptr);
+        }
+        return changed;
+    }
+
+    bool flushToFIState(MemoryMapT *mm) {
+        bool changed = false;
+        for (auto& it : *mm) {
+            changed |= mergeObjects(it.first, getFIObject(it.first),
+                                    it.second.get(), nullptr);
+        }
+        return changed;
+    }
+
+public:
+    PointerAnalysisHybrid(PointerGraph *ps,
+                          const std::set<std::string>& fsFuns,
+                          PointerAnalysisOptions opts)
+    : FSBase(ps, opts), fsFunctions(fsFuns) {}
+
+    PointerAnalysisHybrid(PointerGraph *ps,
+                          const std::set<std::string>& fsFuns)
+    : PointerAnalysisHybrid(ps, fsFuns, {}) {}
+
+    void preprocess() override {
+        // the flow-sensitive part reads the global memory only
+        // through the flow-insensitive state, so it must contain
+        // also the pointers from initializers that are never stored
+        for (auto& glob : PS->getGlobals()) {
+            auto alloc = PSNodeAlloc::get(glob.get());
+            if (alloc && !alloc->getInitialPointers().empty())
+                getFIObject(alloc);
+        }
+    }
+
+    // NOTE: we hide the methods of FSBase, the nodes
+    // of the flow-insensitive part do not have any memory map
+    bool beforeProcessed(PSNode *n) {
+        if (!isFlowSensitive(n))
+            return false;
+        return FSBase::beforeProcessed(n);
+    }
+
+    bool afterProcessed(PSNode *n) {
+        if (!isFlowSensitive(n))
+            return false;
+
+        bool changed = FSBase::afterProcessed(n);
+        MemoryMapT *mm = n->getData<MemoryMapT>();
+        if (readsFIState(n))
+            changed |= mergeFIState(mm);
+        if (writesFIState(n))
+            changed |= flushToFIState(mm);
+
+        return changed;
+    }
+
+    void getMemoryObjects(PSNode *where, const Pointer& pointer,
+                          std::vector<MemoryObject *>& objects)
+    {
+        if (isFlowSensitive(where)) {
+            FSBase::getMemoryObjects(where, pointer, objects);
+            return;
+        }
+
+        // we want to have memory in allocation sites
+        PSNode *n = pointer.target;
+        if (n->getType() == PSNodeType::CAST || n->getType() == PSNodeType::GEP)
+            n = n->getOperand(0);
+        else if (n->getType() == PSNodeType::CONSTANT) {
+            assert(n->pointsTo.size() == 1);
+            n = (*n->pointsTo.begin()).target;
+        }
+
+        if (n->getType() == PSNodeType::FUNCTION)
+            return;
+
+        assert(n->getType() == PSNodeType::ALLOC
+               || n->getType() == PSNodeType::UNKNOWN_MEM);
+
+        objects.push_back(getFIObject(n));
+    }
+};
+
+extern template class PointerAnalysisSolver<PointerAnalysisHybrid>;
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_HYBRID_H_
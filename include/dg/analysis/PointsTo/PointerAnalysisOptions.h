@@ -19,8 +19,17 @@ struct PointerAnalysisOptions : AnalysisOptions {
     // INVALIDATED object.
     bool invalidateNodes{false};
 
+    // If a GEP on a loop creates pointers with more than this
+    // number of different offsets into the same memory,
+    // the offset is widened to UNKNOWN, so that the analysis
+    // does not iterate the loop for every offset.
+    // Used only when the information about loops is computed
+    // (flow-sensitive analysis). 0 turns off the widening.
+    unsigned gepWideningThreshold{8};
+
     PointerAnalysisOptions& setInvalidateNodes(bool b) { invalidateNodes = b; return *this;}
     PointerAnalysisOptions& setPreprocessGeps(bool b)  { preprocessGeps = b; return *this;}
+    PointerAnalysisOptions& setGepWideningThreshold(unsigned t)  { gepWideningThreshold = t; return *this;}
 };
 
 } // namespace analysis
@@ -156,22 +156,29 @@ class PointerGraph
             case PSNodeType::ALLOC:
                 node = new PSNodeAlloc(getNewNodeId());
                 break;
-            case PSNodeType::GEP:
-                node = new PSNodeGep(getNewNodeId(),
-                                     va_arg(args, PSNode *),
-                                     va_arg(args, Offset::type));
+            // NOTE: the order of evaluation of function arguments
+            // is unspecified, so we must read the va_args
+            // before passing them to the constructors
+            case PSNodeType::GEP: {
+                PSNode *src = va_arg(args, PSNode *);
+                Offset::type off = va_arg(args, Offset::type);
+                node = new PSNodeGep(getNewNodeId(), src, off);
                 break;
-            case PSNodeType::MEMCPY:
-                node = new PSNodeMemcpy(getNewNodeId(),
-                                        va_arg(args, PSNode *),
-                                        va_arg(args, PSNode *),
-                                        va_arg(args, Offset::type));
+            }
+            case PSNodeType::MEMCPY: {
+                PSNode *src = va_arg(args, PSNode *);
+                PSNode *dest = va_arg(args, PSNode *);
+                Offset::type len = va_arg(args, Offset::type);
+                node = new PSNodeMemcpy(getNewNodeId(), src, dest, len);
                 break;
-            case PSNodeType::CONSTANT:
+            }
+            case PSNodeType::CONSTANT: {
+                PSNode *target = va_arg(args, PSNode *);
+                Offset::type off = va_arg(args, Offset::type);
                 node = new PSNode(getNewNodeId(), PSNodeType::CONSTANT,
-                                  va_arg(args, PSNode *),
-                                  va_arg(args, Offset::type));
+                                  target, off);
                 break;
+            }
             case PSNodeType::ENTRY:
                 node = new PSNodeEntry(getNewNodeId());
                 break;
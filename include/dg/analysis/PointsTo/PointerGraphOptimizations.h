@@ -1,6 +1,9 @@
 #ifndef _DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 #define _DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 
+#include <unordered_map>
+#include <vector>
+
 #include "PointsToMapping.h"
 
 namespace dg {
@@ -195,6 +198,140 @@ private:
     unsigned merged_nodes_num;
 };
 
+// Merge groups of allocation sites into one abstract object
+// to bound the number of objects (and so the size of points-to sets).
+// Every group is replaced by a new global summary node, so that
+// the object exists even when the functions of the sites are
+// not reachable. The sites stay in the graph (they are referred to
+// from the builders), but nothing uses them anymore.
+class PSAllocationsMerger {
+    using MappingT = PointsToMapping<PSNode *>;
+
+    PointerGraph *PS;
+    MappingT mapping;
+
+    // the merged allocation sites and their summary nodes
+    std::unordered_map<PSNode *, PSNodeAlloc *> summaries;
+
+    PSNodeAlloc *createSummary(const std::vector<PSNodeAlloc *>& sites) {
+        PSNodeAlloc *summary = PSNodeAlloc::get(PS->createGlobal(PSNodeType::ALLOC));
+        // use the first site as the representant for the users
+        // that need the value of the allocation
+        summary->setUserData(sites.front()->getUserData<void>());
+        summary->setSize(sites.front()->getSize());
+
+        for (PSNodeAlloc *site : sites) {
+            assert(!site->isSummary() && "Merging summary nodes");
+            if (site->isHeap())
+                summary->setIsHeap();
+            if (site->isGlobal())
+                summary->setIsGlobal();
+            if (site->isZeroInitialized())
+                summary->setZeroInitialized();
+            if (site->getSize() != summary->getSize())
+                summary->setSize(0);
+
+            summary->addSummarizedSite(site);
+            summaries.emplace(site, summary);
+        }
+
+        // the globals are processed only once and in the order
+        // of creation, so the summary must point to itself
+        // already for the globals created before it
+        summary->addPointsTo(summary, 0);
+        return summary;
+    }
+
+    Pointer mapPointer(const Pointer& ptr) const {
+        auto it = summaries.find(ptr.target);
+        if (it == summaries.end())
+            return ptr;
+        return Pointer(it->second, ptr.offset);
+    }
+
+    // redirect the pointers to the merged sites (e.g. in constants)
+    void mapPointsTo(PSNode *nd) {
+        // the merged sites have no users anymore,
+        // but they are still allocations pointing to themselves
+        if (summaries.count(nd) > 0)
+            return;
+
+        bool hasMerged = false;
+        for (const Pointer& ptr : nd->pointsTo) {
+            if (summaries.count(ptr.target) > 0) {
+                hasMerged = true;
+                break;
+            }
+        }
+
+        if (hasMerged) {
+            PointsToSetT mapped;
+            for (const Pointer& ptr : nd->pointsTo)
+                mapped.add(mapPointer(ptr));
+            nd->pointsTo.swap(mapped);
+        }
+
+        if (auto alloc = PSNodeAlloc::get(nd)) {
+            for (auto& ip : alloc->getInitialPointers())
+                ip.pointer = mapPointer(ip.pointer);
+        }
+    }
+
+public:
+    PSAllocationsMerger(PointerGraph *PS) : PS(PS) {}
+
+    MappingT& getMapping() { return mapping; }
+    const MappingT& getMapping() const { return mapping; }
+
+    // merge every group of allocation sites into one object,
+    // return the number of merged sites
+    unsigned run(const std::vector<std::vector<PSNodeAlloc *>>& groups) {
+        std::vector<PSNodeAlloc *> created;
+        for (const auto& group : groups) {
+            if (group.size() > 1)
+                created.push_back(createSummary(group));
+        }
+
+        if (created.empty())
+            return 0;
+
+        for (PSNodeAlloc *summary : created) {
+            for (PSNodeAlloc *site : summary->getSummarizedSites()) {
+                // merged sites may be operands of the same phi
+                // and phis must not have the same operands twice
+                std::vector<PSNode *> phis;
+                for (PSNode *user : site->getUsers()) {
+                    if (user->getType() == PSNodeType::PHI)
+                        phis.push_back(user);
+                }
+
+                site->replaceAllUsesWith(summary);
+                for (PSNode *phi : phis)
+                    phi->removeDuplicitOperands();
+
+                mapping.add(site, summary);
+
+                // the memory of the summary contains also
+                // the initial pointers of all the sites
+                for (const auto& ip : site->getInitialPointers())
+                    summary->addInitialPointer(ip.offset, ip.pointer,
+                                               ip.stride, ip.count);
+            }
+        }
+
+        for (const auto& nd : PS->getNodes()) {
+            if (nd)
+                mapPointsTo(nd.get());
+        }
+        for (const auto& nd : PS->getGlobals()) {
+            if (nd)
+                mapPointsTo(nd.get());
+        }
+
+        return summaries.size();
+    }
+};
+
 class PointerGraphOptimizer {
     using MappingT = PointsToMapping<PSNode *>;
 
@@ -226,6 +363,15 @@ public:
         }
     }
 
+    // merge the groups of allocation sites (see PSAllocationsMerger)
+    unsigned mergeAllocations(const std::vector<std::vector<PSNodeAlloc *>>& groups) {
+        PSAllocationsMerger merger(PS);
+        auto r = merger.run(groups);
+        if (r > 0)
+            mapping.merge(std::move(merger.getMapping()));
+        return r;
+    }
+
     unsigned run() {
         removeNoops();
         removeEquivalentNodes();
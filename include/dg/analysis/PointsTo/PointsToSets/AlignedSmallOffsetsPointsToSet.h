@@ -126,14 +126,24 @@ public:
         return oddPointers.find(ptr) != oddPointers.end();
     }
 
+    // this set stores strided offsets as unknown offsets,
+    // but the queried pointer may have a strided offset
     bool mayPointTo(const Pointer& ptr) const {
-        return pointsTo(ptr)
-                || pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+        if (pointsTo(Pointer(ptr.target, Offset::UNKNOWN)))
+            return true;
+        if (!ptr.offset.isUnknown())
+            return pointsTo(ptr);
+
+        for (const auto& p : *this) {
+            if (p.target == ptr.target && p.offset.mayBeEqual(ptr.offset))
+                return true;
+        }
+        return false;
     }
 
     bool mustPointTo(const Pointer& ptr) const {
         assert(!ptr.offset.isUnknown() && "Makes no sense");
-        return pointsTo(ptr) && isSingleton();
+        return !ptr.offset.isUnknown() && pointsTo(ptr) && isSingleton();
     }
 
     bool pointsToTarget(PSNode *target) const {
@@ -42,7 +42,8 @@ public:
     OffsetsSetPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
 
     bool add(PSNode *target, Offset off) {
-        if (off.isUnknown())
+        // strided offsets are kept as they are
+        if (off.offset == Offset::UNKNOWN)
             return addWithUnknownOffset(target);
 
         auto it = pointers.find(target);
@@ -121,16 +122,28 @@ public:
     }
 
     // points to the pointer or the the same target
-    // with unknown offset? Note: we do not count
-    // unknown memory here...
+    // with unknown offset or with a strided offset
+    // that may be the offset of the pointer?
+    // Note: we do not count unknown memory here...
     bool mayPointTo(const Pointer& ptr) const {
-        return pointsTo(ptr) ||
-                pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+        auto it = pointers.find(ptr.target);
+        if (it == pointers.end())
+            return false;
+        if (it->second.get(*ptr.offset) || it->second.get(Offset::UNKNOWN))
+            return true;
+
+        for (auto off : it->second) {
+            if (ptr.offset.mayBeEqual(Offset(off)))
+                return true;
+        }
+        return false;
     }
 
+    // a strided offset is not a single offset,
+    // so it can not be pointed to for sure
     bool mustPointTo(const Pointer& ptr) const {
         assert(!ptr.offset.isUnknown() && "Makes no sense");
-        return pointsTo(ptr) && isSingleton();
+        return !ptr.offset.isUnknown() && pointsTo(ptr) && isSingleton();
     }
 
     bool pointsToTarget(PSNode *target) const {
@@ -38,8 +38,10 @@ public:
         if(offsets.get(Offset::UNKNOWN)) {
             return !nodes.set(getNodeID(target));
         }
+        // strided offsets are unknown offsets in this set
         if(off.isUnknown()) {
             offsets.reset();
+            off = Offset::UNKNOWN;
         }
         bool changed = !nodes.set(getNodeID(target));
         return !offsets.set(*off) || changed;
@@ -40,7 +40,8 @@ public:
     using const_iterator = typename ContainerT::const_iterator;
 
     bool add(PSNode *target, Offset off) {
-        if (off.isUnknown())
+        // strided offsets are kept as they are
+        if (off.offset == Offset::UNKNOWN)
             return addWithUnknownOffset(target);
 
         // if we have the same pointer but with unknown offset,
@@ -111,16 +112,26 @@ public:
     }
 
     // points to the pointer or the the same target
-    // with unknown offset? Note: we do not count
-    // unknown memory here...
+    // with unknown offset or with a strided offset
+    // that may be the offset of the pointer?
+    // Note: we do not count unknown memory here...
     bool mayPointTo(const Pointer& ptr) const {
-        return pointsTo(ptr) ||
-                pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+        if (pointsTo(ptr) ||
+            pointsTo(Pointer(ptr.target, Offset::UNKNOWN)))
+            return true;
+
+        for (const auto& p : pointers) {
+            if (p.target == ptr.target && p.offset.mayBeEqual(ptr.offset))
+                return true;
+        }
+        return false;
     }
 
+    // a strided offset is not a single offset,
+    // so it can not be pointed to for sure
     bool mustPointTo(const Pointer& ptr) const {
         assert(!ptr.offset.isUnknown() && "Makes no sense");
-        return pointsTo(ptr) && isSingleton();
+        return !ptr.offset.isUnknown() && pointsTo(ptr) && isSingleton();
     }
 
     bool pointsToTarget(PSNode *target) const {
@@ -16,10 +16,11 @@ class ReachingDefinitionsAnalysis;
 
 template <typename NodeT = RDNode>
 class DefinitionsMap {
-
+public:
     using OffsetsT = DisjunctiveIntervalMap<NodeT *>;
     using IntervalT = typename OffsetsT::IntervalT;
 
+private:
     std::map<NodeT *, OffsetsT> _definitions{};
 
     // transform (offset, lenght) from a DefSite into the interval
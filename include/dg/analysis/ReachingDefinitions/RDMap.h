@@ -67,7 +67,9 @@ struct GenericDefSite
     GenericDefSite(NodeT *t,
                    const Offset& o = Offset::UNKNOWN,
                    const Offset& l = Offset::UNKNOWN)
-        : target(t), offset(o), len(l)
+        // strided offsets are not handled in reaching definitions,
+        // they are just unknown offsets here
+        : target(t), offset(o.isUnknown() ? Offset::UNKNOWN : o), len(l)
     {
         assert((o.isUnknown() || l.isUnknown() ||
                *o + *l > 0) && "Invalid offset and length given");
@@ -2,6 +2,7 @@
 #define DG_RD_NODE_H_
 
 #include <vector>
+#include <algorithm>
 
 #include "dg/analysis/Offset.h"
 #include "dg/analysis/SubgraphNode.h"
@@ -77,6 +78,18 @@ class RDNode : public SubgraphNode<RDNode> {
             return changed;
         }
 
+        // replace 'from' with 'to' (the elements are kept unique)
+        void replace(RDNode *from, RDNode *to) {
+            auto it = std::find(defuse.begin(), defuse.end(), from);
+            if (it == defuse.end())
+                return;
+
+            if (std::find(defuse.begin(), defuse.end(), to) == defuse.end())
+                *it = to;
+            else
+                defuse.erase(it);
+        }
+
         operator std::vector<RDNode *>() { return defuse; }
 
         T::iterator begin() { return defuse.begin(); }
@@ -4,9 +4,13 @@
 #include <vector>
 #include <list>
 #include <set>
+#include <map>
+#include <tuple>
 #include <cassert>
 #include <memory>
+#include <unordered_map>
 
+#include "dg/ADT/Bitvector.h"
 #include "dg/analysis/Offset.h"
 #include "dg/analysis/BFS.h"
 
@@ -75,6 +79,30 @@ public:
         _check();
     }
 
+    // the same as prependAndUpdateCFG, but for a sequence of nodes
+    // (the first node in the vector becomes the first node of the block).
+    // The predecessors of the block are re-linked only once
+    void prependAndUpdateCFG(const std::vector<NodeT *>& nodes) {
+        assert(!_nodes.empty());
+        assert(!nodes.empty());
+
+        for (size_t i = 1; i < nodes.size(); ++i) {
+            assert(nodes[i]->getSuccessors().empty());
+            assert(nodes[i]->getPredecessors().empty());
+            nodes[i - 1]->addSuccessor(nodes[i]);
+        }
+
+        std::pair<NodeT *, NodeT *> seq(nodes.front(), nodes.back());
+        _nodes.front()->insertSequenceBefore(seq);
+
+        for (auto it = nodes.rbegin(), et = nodes.rend(); it != et; ++it) {
+            _nodes.push_front(*it);
+            (*it)->setBBlock(this);
+        }
+
+        _check();
+    }
+
     const NodesT& getNodes() const { return _nodes; }
 
     DefinitionsMap<RDNode> definitions;
@@ -157,6 +185,13 @@ public:
     RDNode *getRoot() const { return root; }
     void setRoot(RDNode *r) { root = r; }
 
+    // the number of nodes created in this graph
+    size_t size() const { return _nodes.size(); }
+    // the greatest ID of a node created in this graph
+    size_t getMaxNodeID() const { return lastNodeID; }
+    // all the nodes of this graph (also the unreachable ones)
+    const NodesT& getNodes() const { return _nodes; }
+
     const std::vector<std::unique_ptr<RDBBlock>>& getBBlocks() const { return _bblocks; }
 
     block_iterator blocks_begin() { return block_iterator(_bblocks.begin()); }
@@ -164,10 +199,15 @@ public:
 
     blocks_range blocks() { return blocks_range(_bblocks); }
 
-    void removeUselessNodes();
+    // Remove the nodes that have no definitions nor uses and no user data
+    // (e.g. the nodes for the calls of pure functions or placeholders)
+    // and connect their predecessors to their successors.
+    // Must be called before building the blocks. Returns the number
+    // of removed nodes.
+    size_t removeUselessNodes();
 
-    void optimize() {
-        removeUselessNodes();
+    size_t optimize() {
+        return removeUselessNodes();
     }
 
     RDNode *create(RDNodeType t) {
@@ -218,6 +258,10 @@ protected:
 
     const ReachingDefinitionsAnalysisOptions options;
 
+private:
+    size_t processedNodesNum{0};
+    size_t mergedMapsNum{0};
+
 public:
     ReachingDefinitionsAnalysis(ReachingDefinitionsGraph&& graph,
                                 const ReachingDefinitionsAnalysisOptions& opts)
@@ -248,6 +292,11 @@ public:
     bool processNode(RDNode *n);
     virtual void run();
 
+    // statistics of the last run(): the number of processed nodes
+    // and the number of the maps merged from the predecessors
+    size_t getProcessedNodesNum() const { return processedNodesNum; }
+    size_t getMergedMapsNum() const { return mergedMapsNum; }
+
     // return the reaching definitions of ('mem', 'off', 'len')
     // at the location 'where'
     virtual std::vector<RDNode *>
@@ -282,16 +331,55 @@ class SSAReachingDefinitionsAnalysis : public ReachingDefinitionsAnalysis {
     // as the definitions).
     std::vector<RDNode *> findDefinitions(RDBBlock *, const DefSite&);
 
+    // Create phi nodes for the uncovered intervals of the memory
+    // at the beginning of the block and add them to 'defs'.
+    void addPhis(RDBBlock *block, RDNode *target,
+                 const std::vector<DefinitionsMap<RDNode>::IntervalT>& intervals,
+                 std::vector<RDNode *>& defs);
+
+    // definitions of the def-site at the end of the block (including the
+    // definitions found in the predecessors), so that we do not walk
+    // the same chains of predecessors again and again in GVN
+    using DefinitionsCacheKeyT = std::tuple<RDBBlock *, RDNode *, Offset, Offset>;
+    std::map<DefinitionsCacheKeyT, std::vector<RDNode *>> _definitionsCache;
+
     /// Finding definitions for unknown memory
     // Must be called after LVN proceeded - ideally only when the client is getting the definitions
     std::vector<RDNode *> findAllReachingDefinitions(RDNode *from);
-    void findAllReachingDefinitions(DefinitionsMap<RDNode>& defs, RDBBlock *from,
-                                    std::set<RDNode *>& nodes,
-                                    std::set<RDBBlock *>& visitedBlocks);
+
+    // Compute the summaries of blocks for finding definitions of unknown
+    // memory: the definitions that may reach the beginning of the block.
+    // The definitions of a target do not flow through a block
+    // that defines the target (the phi nodes of the block stand for them).
+    void computeBlockSummaries();
+
+    // indexed by the ID of the definition node, contains the bit
+    // of the node in the summaries increased by one (0 means no bit)
+    std::vector<unsigned> _defBits;
+    std::vector<RDNode *> _bitDefs;
+    std::unordered_map<RDBBlock *, ADT::SparseBitvector> _blockSummaries;
 
     // all phi nodes added during transformation to SSA
     std::vector<RDNode *> _phis;
 
+    /// Non-phi definitions of phi nodes (computed once after GVN)
+    // Compute the closure of the def-use edges between phi nodes
+    // and replace the phis that have a single non-phi definition
+    // by this definition in the def-use edges.
+    void computePhiDefinitions();
+    // the non-phi definitions of the phi node (sorted)
+    // or nullptr if the phi node was not processed
+    const std::vector<RDNode *> *getPhiDefinitions(RDNode *phi) const;
+    // replace the phi nodes with their non-phi definitions
+    template <typename ContT>
+    std::vector<RDNode *> getNonPhiDefinitions(const ContT& nodes) const;
+
+    // indexed by the ID of the phi node, contains the index to _phiDefs
+    // increased by one (0 means no entry). Phis from the same
+    // strongly connected component share the definitions.
+    std::vector<unsigned> _phiDefsIdx;
+    std::vector<std::vector<RDNode *>> _phiDefs;
+
 public:
     SSAReachingDefinitionsAnalysis(ReachingDefinitionsGraph&& graph,
                                    const ReachingDefinitionsAnalysisOptions& opts)
@@ -308,6 +396,8 @@ public:
 
         performLvn();
         performGvn();
+        computePhiDefinitions();
+        computeBlockSummaries();
 
         DBG_SECTION_END(dda, "Running MemorySSA analysis finished");
     }
@@ -271,7 +271,7 @@ public:
         }
 
         // this node is successors of the last node in sequence
-        seq.second->addSuccessor(this);
+        seq.second->addSuccessor(static_cast<NodeT *>(this));
     }
 
     void isolate() {
@@ -301,11 +301,14 @@ public:
             new_preds.swap(succ->predecessors);
         }
 
-        // Take every predecessor and connect it to every successor.
+        // Take every predecessor and connect it to every successor
+        // (if they are not connected already).
         for (NodeT *pred : predecessors) {
             for (NodeT *succ : successors) {
                 assert(succ != this && "Self-loop");
-                pred->addSuccessor(succ);
+                if (std::find(pred->successors.begin(), pred->successors.end(),
+                              succ) == pred->successors.end())
+                    pred->addSuccessor(succ);
             }
         }
 
@@ -333,6 +336,27 @@ public:
         users.clear();
     }
 
+    bool removeDuplicitOperands() {
+        std::set<NodeT *> ops;
+        bool duplicated = false;
+        for (auto op : getOperands()) {
+            if (!ops.insert(op).second)
+                duplicated = true;
+        }
+
+        if (duplicated) {
+            operands.clear();
+            operands.reserve(ops.size());
+            // just push the new operads,
+            // the users should not change in this case
+            // (as we just remove the duplicated ones)
+            for (auto op : ops)
+                operands.push_back(op);
+        }
+
+        return duplicated;
+    }
+
     size_t predecessorsNum() const {
         return predecessors.size();
     }
@@ -369,27 +393,6 @@ private:
         succ->predecessors.swap(tmp);
     }
 
-    bool removeDuplicitOperands() {
-        std::set<NodeT *> ops;
-        bool duplicated = false;
-        for (auto op : getOperands()) {
-            if (!ops.insert(op).second)
-                duplicated = true;
-        }
-
-        if (duplicated) {
-            operands.clear();
-            operands.reserve(ops.size());
-            // just push the new operads,
-            // the users should not change in this case
-            // (as we just remove the duplicated ones)
-            for (auto op : ops)
-                operands.push_back(op);
-        }
-
-        return duplicated;
-    }
-
     void addUser(NodeT *nd) {
         // do not add duplicate users
         for (auto u : users)
@@ -11,6 +11,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <memory>
 
 #include "dg/llvm/analysis/ThreadRegions/ControlFlowGraph.h"
 
@@ -20,6 +21,8 @@ namespace llvm {
     class Module;
     class Value;
     class Function;
+    class BasicBlock;
+    class Instruction;
 } // namespace llvm
 
 #include "dg/llvm/LLVMNode.h"
@@ -46,7 +49,9 @@ class LLVMPointerAnalysis;
 namespace analysis {
 namespace rd {
     class LLVMReachingDefinitions;
-}};
+}
+    class ExecutionCoverage;
+};
 
 using analysis::rd::LLVMReachingDefinitions;
 
@@ -164,7 +169,17 @@ public:
     LLVMPointerAnalysis *getPTA() const { return PTA; }
     LLVMReachingDefinitions *getRDA() const { return RDA; }
 
+    // build only the blocks that are covered, the CFG edges
+    // to the other blocks are cut off. The slicer then removes
+    // these blocks and redirects the edges to a new exit block.
+    // Must be set before building the graph.
+    void setCoverage(const analysis::ExecutionCoverage *cov) { coverage = cov; }
+    bool isCovered(const llvm::BasicBlock *B) const;
+
     LLVMNode *findNode(llvm::Value *value) const;
+    // get the node of the instruction from this graph or any graph
+    // built together with it (nullptr if the instruction has no node)
+    LLVMNode *findInstruction(const llvm::Instruction *instruction) const;
 
     void addDefUseEdges();
     void computeInterferenceDependentEdges(ControlFlowGraph * controlFlowGraph);
@@ -218,10 +233,18 @@ private:
     LLVMPointerAnalysis *PTA;
     // reaching definitions information (if available)
     LLVMReachingDefinitions *RDA;
+    // the executed code (if we build only that)
+    const analysis::ExecutionCoverage *coverage{nullptr};
 
     // control expression for this graph
     ControlExpression CE;
 
+    // nodes of the instructions of all the graphs built
+    // from one module (shared the same way as global nodes)
+    using InstructionNodesT = std::unordered_map<const llvm::Instruction *, LLVMNode *>;
+    std::shared_ptr<InstructionNodesT> instructionNodes;
+    void setInstructionNode(const llvm::Instruction *I, LLVMNode *node);
+
     // verifier needs access to private elements
     friend class LLVMDGVerifier;
 };
@@ -229,10 +252,6 @@ private:
 const std::map<llvm::Value *,
                LLVMDependenceGraph *>& getConstructedFunctions();
 
-LLVMNode *
-findInstruction(llvm::Instruction * instruction, 
-                const std::map<llvm::Value *, LLVMDependenceGraph *> & constructedFunctions);
-
 llvm::Instruction * castToLLVMInstruction(const llvm::Value * value);
 } // namespace dg
 
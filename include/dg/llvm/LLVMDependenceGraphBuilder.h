@@ -27,10 +27,12 @@
 
 #include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
 #include "dg/llvm/analysis/ReachingDefinitions/ReachingDefinitions.h"
+#include "dg/llvm/analysis/ExecutionCoverage.h"
 
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
+#include "dg/analysis/PointsTo/PointerAnalysisHybrid.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/Offset.h"
 
@@ -60,6 +62,11 @@ struct LLVMDependenceGraphOptions {
 
     std::string entryFunction{"main"};
 
+    // build only the code that is covered (see ExecutionCoverage).
+    // The coverage is loaded once by the user of the builder
+    // and the builder passes it to PTA and RDA.
+    const analysis::ExecutionCoverage *coverage{nullptr};
+
     void addAllocationFunction(const std::string& name,
                                analysis::AllocationFunction F) {
         PTAOptions.addAllocationFunction(name, F);
@@ -100,6 +107,8 @@ class LLVMDependenceGraphBuilder {
             _PTA->run<analysis::pta::PointerAnalysisFI>();
         else if (_options.PTAOptions.isFSInv())
             _PTA->run<analysis::pta::PointerAnalysisFSInv>();
+        else if (_options.PTAOptions.isHybrid())
+            _PTA->run<analysis::pta::PointerAnalysisHybrid>();
         else {
             assert(0 && "Wrong pointer analysis");
             abort();
@@ -154,13 +163,21 @@ class LLVMDependenceGraphBuilder {
         return _dg->verify();
     }
 
+    // all the analyses build only the covered code
+    static LLVMDependenceGraphOptions
+    _shareCoverage(LLVMDependenceGraphOptions opts) {
+        opts.PTAOptions.coverage = opts.coverage;
+        opts.RDAOptions.coverage = opts.coverage;
+        return opts;
+    }
+
 public:
     LLVMDependenceGraphBuilder(llvm::Module *M)
     : LLVMDependenceGraphBuilder(M, {}) {}
 
     LLVMDependenceGraphBuilder(llvm::Module *M,
                                const LLVMDependenceGraphOptions& opts)
-    : _M(M), _options(opts),
+    : _M(M), _options(_shareCoverage(opts)),
       _PTA(new LLVMPointerAnalysis(M, _options.PTAOptions)),
       _RD(new LLVMReachingDefinitions(M, _PTA.get(),
                                       _options.RDAOptions)),
@@ -168,6 +185,7 @@ public:
       _controlFlowGraph(new ControlFlowGraph(_PTA.get())),
       _entryFunction(M->getFunction(_options.entryFunction)) {
         assert(_entryFunction && "The entry function not found");
+        _dg->setCoverage(_options.coverage);
     }
 
     LLVMPointerAnalysis *getPTA() { return _PTA.get(); }
@@ -1,6 +1,9 @@
 #ifndef _LLVM_DG_SLICER_H_
 #define _LLVM_DG_SLICER_H_
 
+#include <set>
+#include <vector>
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -156,6 +159,194 @@ public:
         return sl_id;
     }
 
+    struct CompactionStatistics {
+        // blocks merged into their only predecessor
+        uint32_t blocksMerged{0};
+        // blocks that only jumped to another block
+        uint32_t blocksRemoved{0};
+        // phi nodes with a single incoming value
+        uint32_t phisFolded{0};
+    };
+
+    ///
+    // Make the CFG of the sliced functions smaller: fold phi nodes
+    // that have a single incoming value, remove blocks that only jump
+    // to another block and merge straight-line sequences of blocks.
+    // The removed blocks and instructions still have their nodes
+    // in the dependence graph, so call this only when the graph
+    // is not going to be used anymore.
+    void compactCFG()
+    {
+        extern std::map<const llvm::Value *,
+                        LLVMDependenceGraph *> constructedFunctions;
+        for (auto& it : constructedFunctions) {
+            if (dontTouch(it.first->getName()))
+                continue;
+
+            compactCFG(llvm::cast<llvm::Function>(const_cast<llvm::Value *>(it.first)));
+        }
+    }
+
+    const CompactionStatistics& getCompactionStatistics() const {
+        return compactionStatistics;
+    }
+
+    // compact the CFG of a single function
+    void compactCFG(llvm::Function *F)
+    {
+        using namespace llvm;
+
+        bool changed;
+        do {
+            changed = false;
+            for (auto I = F->begin(); I != F->end();) {
+                BasicBlock *B = &*I;
+                // shift here, we may erase the block
+                ++I;
+
+                changed |= foldTrivialPhis(B);
+                if (removeForwardingBlock(B) || mergeIntoPredecessor(B))
+                    changed = true;
+            }
+        } while (changed);
+    }
+
+    bool foldTrivialPhis(llvm::BasicBlock *B)
+    {
+        using namespace llvm;
+
+        bool changed = false;
+        for (auto I = B->begin(), E = B->end(); I != E;) {
+            PHINode *phi = dyn_cast<PHINode>(&*I);
+            if (!phi)
+                break;
+            ++I;
+
+            if (phi->getNumIncomingValues() == 0)
+                continue;
+
+            // the value that is merged from all predecessors
+            // (ignoring the phi node itself)
+            Value *val = phi->hasConstantValue();
+            if (!val)
+                continue;
+
+            // the value is defined later in this block (on a loop),
+            // it does not dominate the uses of the phi
+            auto Inst = dyn_cast<Instruction>(val);
+            if (Inst && Inst->getParent() == B)
+                continue;
+
+            phi->replaceAllUsesWith(val);
+            phi->eraseFromParent();
+            ++compactionStatistics.phisFolded;
+            changed = true;
+        }
+
+        return changed;
+    }
+
+    // remove a block that contains only an unconditional jump
+    // and redirect its predecessors to the successor
+    bool removeForwardingBlock(llvm::BasicBlock *B)
+    {
+        using namespace llvm;
+
+        if (B == &B->getParent()->getEntryBlock() || B->hasAddressTaken())
+            return false;
+
+        auto BI = dyn_cast_or_null<BranchInst>(B->getTerminator());
+        if (!BI || BI->isConditional() || &B->front() != BI)
+            return false;
+
+        BasicBlock *succ = BI->getSuccessor(0);
+        if (succ == B)
+            return false;
+
+        // one entry for every edge
+        std::vector<BasicBlock *> preds(pred_begin(B), pred_end(B));
+        for (BasicBlock *pred : preds) {
+            auto T = pred->getTerminator();
+            if (!T || (!isa<BranchInst>(T) && !isa<SwitchInst>(T)))
+                return false;
+        }
+
+        bool hasPhis = isa<PHINode>(succ->front());
+        if (hasPhis) {
+            // the phi nodes could need different values
+            // for the same predecessor
+            std::set<BasicBlock *> succPreds(pred_begin(succ), pred_end(succ));
+            for (BasicBlock *pred : preds) {
+                if (succPreds.count(pred) > 0)
+                    return false;
+            }
+
+            for (Instruction& I : *succ) {
+                PHINode *phi = dyn_cast<PHINode>(&I);
+                if (!phi)
+                    break;
+
+                Value *val = phi->getIncomingValueForBlock(B);
+                for (BasicBlock *pred : preds)
+                    phi->addIncoming(val, pred);
+            }
+
+            adjustPhiNodes(succ, B);
+        }
+
+        std::set<BasicBlock *> uniquePreds(preds.begin(), preds.end());
+        for (BasicBlock *pred : uniquePreds)
+            pred->getTerminator()->replaceUsesOfWith(B, succ);
+
+        B->eraseFromParent();
+        ++compactionStatistics.blocksRemoved;
+        return true;
+    }
+
+    // merge the block into its predecessor if it is
+    // the only successor of the predecessor
+    bool mergeIntoPredecessor(llvm::BasicBlock *B)
+    {
+        using namespace llvm;
+
+        BasicBlock *pred = B->getSinglePredecessor();
+        if (!pred || pred == B || B->hasAddressTaken() ||
+            B == &B->getParent()->getEntryBlock())
+            return false;
+
+        auto BI = dyn_cast_or_null<BranchInst>(pred->getTerminator());
+        if (!BI || BI->isConditional())
+            return false;
+
+        // phi nodes with a single predecessor have a single value
+        while (PHINode *phi = dyn_cast<PHINode>(&B->front())) {
+            phi->replaceAllUsesWith(phi->getIncomingValue(0));
+            phi->eraseFromParent();
+            ++compactionStatistics.phisFolded;
+        }
+
+        BI->eraseFromParent();
+        pred->getInstList().splice(pred->end(), B->getInstList());
+        // the phi nodes in successors now get the values from pred
+        // (incoming blocks of phi nodes are not uses of the block)
+        for (auto I = succ_begin(pred), E = succ_end(pred); I != E; ++I) {
+            for (Instruction& Inst : **I) {
+                PHINode *phi = dyn_cast<PHINode>(&Inst);
+                if (!phi)
+                    break;
+
+                for (unsigned i = 0, e = phi->getNumIncomingValues(); i < e; ++i) {
+                    if (phi->getIncomingBlock(i) == B)
+                        phi->setIncomingBlock(i, pred);
+                }
+            }
+        }
+        B->eraseFromParent();
+
+        ++compactionStatistics.blocksMerged;
+        return true;
+    }
+
 private:
         /*
     void sliceCallNode(LLVMNode *callNode,
@@ -300,8 +491,11 @@ private:
             const auto tinst = llvmBB->getTerminator();
             LLVMBBlock *BB = it.second;
 
-            // nothing to do
-            if (BB->successorsNum() == 0)
+            // nothing to do (unless the CFG edges of the terminator
+            // were cut off and the terminator stays in the slice)
+            if (BB->successorsNum() == 0 &&
+                (tinst->getNumSuccessors() == 0 ||
+                 BB->getLastNode()->getSlice() != slice_id))
                 continue;
 
             // if the BB has two successors and one is self-loop and
@@ -431,8 +625,45 @@ private:
         }
     }
 
+    // remove the blocks that were not built into the graph,
+    // that is, the code that was not executed when the graph
+    // was built with coverage (see LLVMDependenceGraph::setCoverage).
+    // The CFG edges to these blocks were cut off in the graph,
+    // adjustBBlocksSucessors reconnects them to the new exit block.
+    void removeUncoveredBlocks(LLVMDependenceGraph *graph)
+    {
+        using namespace llvm;
+
+        Function *F = cast<Function>(graph->getEntry()->getKey());
+        const auto& blocks = graph->getBlocks();
+
+        std::vector<BasicBlock *> uncovered;
+        for (BasicBlock& B : *F) {
+            if (blocks.find(&B) == blocks.end())
+                uncovered.push_back(&B);
+        }
+
+        for (BasicBlock *B : uncovered) {
+            for (succ_iterator S = succ_begin(B), SE = succ_end(B); S != SE; ++S) {
+                if (*S != B)
+                    adjustPhiNodes(*S, B);
+            }
+
+            for (Instruction& I : *B)
+                I.replaceAllUsesWith(UndefValue::get(I.getType()));
+        }
+
+        for (BasicBlock *B : uncovered) {
+            dropAllUses(B);
+            B->eraseFromParent();
+        }
+    }
+
     void sliceGraph(LLVMDependenceGraph *graph, uint32_t slice_id)
     {
+        // remove the code that was not executed
+        removeUncoveredBlocks(graph);
+
         // first slice away bblocks that should go away
         sliceBBlocks(graph, slice_id);
 
@@ -609,6 +840,8 @@ private:
 
     // do not slice these functions at all
     std::set<const char *> dont_touch;
+
+    CompactionStatistics compactionStatistics;
 };
 } // namespace dg
 
@@ -0,0 +1,132 @@
+#ifndef _DG_LLVM_EXECUTION_COVERAGE_H_
+#define _DG_LLVM_EXECUTION_COVERAGE_H_
+
+#include <set>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <unordered_map>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/Support/raw_ostream.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+namespace dg {
+namespace analysis {
+
+///
+// Basic blocks that were executed by some runs of the program
+// (e.g. the test suite) -- the coverage is given by a text file
+// where every line has the form
+//
+//   <function name> <block index> <block index> ...
+//
+// The blocks are indexed from 0 in the order in which they are
+// in the function (the entry block has index 0 and is covered always).
+// Empty lines and lines starting with '#' are skipped.
+// Only the functions that are in the file are restricted, the functions
+// that are not there (e.g. the code that was not instrumented)
+// are considered to be covered whole.
+//
+// Analyses built with the coverage build only the covered blocks
+// and cut the CFG edges to the other blocks.
+class ExecutionCoverage {
+    // the covered blocks of the functions from the file
+    std::unordered_map<const llvm::Function *,
+                       std::set<const llvm::BasicBlock *>> _functions;
+
+public:
+    // load the coverage of the module 'M' from the file,
+    // return false (and report the error) if the file is not valid
+    bool load(const llvm::Module *M, const std::string& file) {
+        std::ifstream in(file);
+        if (!in.is_open()) {
+            llvm::errs() << "Cannot open the coverage file '" << file << "'\n";
+            return false;
+        }
+
+        return load(M, in, file);
+    }
+
+    // load the coverage from the stream, 'file' is the name
+    // of the input used in the error messages
+    bool load(const llvm::Module *M, std::istream& in, const std::string& file) {
+        std::string line;
+        unsigned lineNum = 0;
+        while (std::getline(in, line)) {
+            ++lineNum;
+
+            std::istringstream ss(line);
+            std::string fun;
+            if (!(ss >> fun) || fun[0] == '#')
+                continue;
+
+            std::vector<long> indices;
+            long idx;
+            while (ss >> idx)
+                indices.push_back(idx);
+
+            if (!ss.eof()) {
+                llvm::errs() << file << ":" << lineNum
+                             << ": invalid block index\n";
+                return false;
+            }
+
+            // the coverage may be gathered for the whole program,
+            // skip the functions that are not defined in this module
+            const llvm::Function *F = M->getFunction(fun);
+            if (!F || F->isDeclaration())
+                continue;
+
+            std::vector<const llvm::BasicBlock *> blocks;
+            blocks.reserve(F->size());
+            for (const llvm::BasicBlock& B : *F)
+                blocks.push_back(&B);
+
+            auto& covered = _functions[F];
+            covered.insert(blocks.front());
+            for (long i : indices) {
+                if (i < 0 || static_cast<size_t>(i) >= blocks.size()) {
+                    llvm::errs() << file << ":" << lineNum
+                                 << ": function '" << fun << "' has no block "
+                                 << i << "\n";
+                    return false;
+                }
+
+                covered.insert(blocks[i]);
+            }
+        }
+
+        return true;
+    }
+
+    bool empty() const { return _functions.empty(); }
+
+    bool isCovered(const llvm::BasicBlock *B) const {
+        auto it = _functions.find(B->getParent());
+        return it == _functions.end() || it->second.count(B) > 0;
+    }
+};
+
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_LLVM_EXECUTION_COVERAGE_H_
@@ -0,0 +1,159 @@
+#ifndef _DG_LLVM_IMMUTABLE_GLOBALS_H_
+#define _DG_LLVM_IMMUTABLE_GLOBALS_H_
+
+#include <set>
+#include <vector>
+#include <iterator>
+#include <unordered_set>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+namespace dg {
+namespace analysis {
+
+///
+// Global variables whose memory can never contain a pointer
+// and can never be modified -- typically string literals
+// and constant lookup tables. A global is immutable if
+//
+//  - it is constant and has a definitive initializer,
+//  - its type contains no pointers, and
+//  - its address is never stored to memory (and so it can not
+//    be written through some pointer that we do not see).
+//
+// The analyses do not need to model such globals as memory:
+// no pointer is ever loaded from them and no definition
+// other than the initializer ever reaches their uses.
+class ImmutableGlobals {
+    std::unordered_set<const llvm::Value *> _globals;
+
+    static bool typeContainsPointer(llvm::Type *Ty) {
+        if (Ty->isPtrOrPtrVectorTy())
+            return true;
+
+        for (auto I = Ty->subtype_begin(), E = Ty->subtype_end(); I != E; ++I) {
+            if (typeContainsPointer(*I))
+                return true;
+        }
+        return false;
+    }
+
+    // can the address of 'GV' (or of its part) get to memory
+    // or be used to write to the global?
+    static bool addressEscapes(const llvm::GlobalVariable *GV) {
+        using namespace llvm;
+
+        std::vector<const Value *> queue{GV};
+        std::set<const Value *> visited{GV};
+        while (!queue.empty()) {
+            const Value *val = queue.back();
+            queue.pop_back();
+
+            for (auto I = val->use_begin(), E = val->use_end(); I != E; ++I) {
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 5))
+                const Value *use = *I;
+#else
+                const Value *use = I->getUser();
+#endif
+                if (auto CE = dyn_cast<ConstantExpr>(use)) {
+                    // the pointer arithmetic on the address
+                    if (CE->getOpcode() != Instruction::GetElementPtr &&
+                        CE->getOpcode() != Instruction::BitCast)
+                        return true;
+                } else if (isa<Constant>(use)) {
+                    // the address is in an initializer of some global
+                    return true;
+                } else if (isa<StoreInst>(use)) {
+                    // storing the address or storing to the global
+                    return true;
+                } else if (auto CI = dyn_cast<CallInst>(use)) {
+                    // the analyses do not model undefined functions
+                    // as storing their arguments either (memcpy and such
+                    // only read the memory), but pthread_create passes
+                    // its argument to the thread function
+                    const Function *F = CI->getCalledFunction();
+                    if (!F || F->getName() == "pthread_create")
+                        return true;
+                    if (F->isDeclaration())
+                        continue;
+
+                    for (unsigned i = 0, e = CI->getNumArgOperands(); i < e; ++i) {
+                        if (CI->getArgOperand(i) != val)
+                            continue;
+                        // passed as a variadic argument
+                        if (i >= F->arg_size())
+                            return true;
+
+                        const Value *arg = &*std::next(F->arg_begin(), i);
+                        if (visited.insert(arg).second)
+                            queue.push_back(arg);
+                    }
+                    continue;
+                } else if (isa<LoadInst>(use) || isa<ICmpInst>(use)) {
+                    // reading the memory or comparing the address is fine
+                    continue;
+                } else if (!isa<GetElementPtrInst>(use) &&
+                           !isa<BitCastInst>(use) &&
+                           !isa<PHINode>(use) &&
+                           !isa<SelectInst>(use)) {
+                    // anything else (returning the address, casting it
+                    // to an integer) may make the address reach the memory
+                    return true;
+                }
+
+                if (visited.insert(use).second)
+                    queue.push_back(use);
+            }
+        }
+
+        return false;
+    }
+
+public:
+    // classify the globals of the module 'M'
+    void compute(const llvm::Module *M) {
+        _globals.clear();
+        for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I) {
+            const llvm::GlobalVariable *GV = &*I;
+            if (!GV->isConstant() || !GV->hasDefinitiveInitializer())
+                continue;
+            if (typeContainsPointer(GV->getType()->getContainedType(0)))
+                continue;
+            if (addressEscapes(GV))
+                continue;
+
+            _globals.insert(GV);
+        }
+    }
+
+    bool empty() const { return _globals.empty(); }
+    size_t size() const { return _globals.size(); }
+
+    bool isImmutable(const llvm::Value *val) const {
+        return _globals.count(val) > 0;
+    }
+};
+
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_LLVM_IMMUTABLE_GLOBALS_H_
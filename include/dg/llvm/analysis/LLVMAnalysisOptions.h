@@ -7,10 +7,21 @@
 namespace dg {
 namespace analysis {
 
+class ExecutionCoverage;
+
 struct LLVMAnalysisOptions {
     // Number of bytes in objects to track precisely
     std::string entryFunction{"main"};
 
+    // Do not model local variables that are only loaded and stored
+    // (their address is not taken) as memory, see PromotableAllocas
+    bool promoteLocals{false};
+
+    // Build only the code that is covered, see ExecutionCoverage
+    // (no restriction if nullptr). The coverage is not owned
+    // by the options and must outlive the analysis.
+    const ExecutionCoverage *coverage{nullptr};
+
     LLVMAnalysisOptions& setEntryFunction(const std::string& e) {
         entryFunction = e; return *this;
     }
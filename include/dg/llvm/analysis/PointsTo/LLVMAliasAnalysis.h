@@ -0,0 +1,96 @@
+#ifndef _LLVM_DG_ALIAS_ANALYSIS_H_
+#define _LLVM_DG_ALIAS_ANALYSIS_H_
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/MemoryLocation.h>
+#include <llvm/Pass.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
+
+#if LLVM_VERSION_MAJOR < 4
+#error "The alias analysis adapter needs LLVM 4 or newer"
+#endif
+
+namespace dg {
+
+///
+// Adapter of LLVMPointerAnalysis::alias() to the alias analysis interface
+// of LLVM. Add it to AAResults (or use createDGAAWrapperPass)
+// so that LLVM passes can use the results of dg's pointer analysis.
+// The pointer analysis must have finished before the first query.
+class DGAAResult : public llvm::AAResultBase<DGAAResult>
+{
+    friend llvm::AAResultBase<DGAAResult>;
+
+    LLVMPointerAnalysis *PTA;
+
+    static uint64_t getSize(const llvm::MemoryLocation& Loc) {
+#if LLVM_VERSION_MAJOR < 7
+        return Loc.Size == llvm::MemoryLocation::UnknownSize ?
+                    Offset::UNKNOWN : Loc.Size;
+#else
+        return Loc.Size.hasValue() ? Loc.Size.getValue() : Offset::UNKNOWN;
+#endif
+    }
+
+public:
+    DGAAResult(LLVMPointerAnalysis *pta) : PTA(pta) {}
+
+#if LLVM_VERSION_MAJOR < 9
+    llvm::AliasResult alias(const llvm::MemoryLocation& LocA,
+                            const llvm::MemoryLocation& LocB) {
+#else
+    llvm::AliasResult alias(const llvm::MemoryLocation& LocA,
+                            const llvm::MemoryLocation& LocB,
+                            llvm::AAQueryInfo&) {
+#endif
+        switch (PTA->alias(LocA.Ptr, getSize(LocA), LocB.Ptr, getSize(LocB))) {
+#if LLVM_VERSION_MAJOR < 13
+            case LLVMPointerAnalysis::AliasResult::NoAlias:
+                return llvm::NoAlias;
+            case LLVMPointerAnalysis::AliasResult::MustAlias:
+                return llvm::MustAlias;
+            default:
+                return llvm::MayAlias;
+#else
+            case LLVMPointerAnalysis::AliasResult::NoAlias:
+                return llvm::AliasResult::NoAlias;
+            case LLVMPointerAnalysis::AliasResult::MustAlias:
+                return llvm::AliasResult::MustAlias;
+            default:
+                return llvm::AliasResult::MayAlias;
+#endif
+        }
+    }
+};
+
+///
+// Create a legacy pass that adds 'result' to the alias analyses
+// used by the passes in the same pass manager.
+inline llvm::ImmutablePass *createDGAAWrapperPass(DGAAResult& result)
+{
+    return llvm::createExternalAAWrapperPass(
+        [&result](llvm::Pass&, llvm::Function&, llvm::AAResults& AAR) {
+            AAR.addAAResult(result);
+        });
+}
+
+} // namespace dg
+
+#endif // _LLVM_DG_ALIAS_ANALYSIS_H_
@@ -1,6 +1,9 @@
 #ifndef _DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 #define _DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 
+#include <set>
+#include <string>
+
 #include "dg/llvm/analysis/LLVMAnalysisOptions.h"
 #include "dg/analysis/PointsTo/PointerAnalysisOptions.h"
 
@@ -9,12 +12,35 @@ namespace analysis {
 
 struct LLVMPointerAnalysisOptions : public LLVMAnalysisOptions, PointerAnalysisOptions
 {
-    enum class AnalysisType { fi, fs, inv } analysisType{AnalysisType::fi};
+    enum class AnalysisType { fi, fs, inv, hybrid } analysisType{AnalysisType::fi};
 
     bool threads;
+
+    // The functions that are analyzed flow-sensitively
+    // by the hybrid analysis (see PointerAnalysisHybrid):
+    // the functions given by name,
+    std::set<std::string> fsFunctions{};
+    // the functions that are at most 'fsCriteriaDistance' calls
+    // far in the call graph from a call of some of 'fsCriteria'
+    // (e.g. the slicing criteria)
+    std::set<std::string> fsCriteria{};
+    unsigned fsCriteriaDistance{0};
+    // and the functions that store a pointer at least
+    // 'fsStoresThreshold' times (0 turns this off)
+    unsigned fsStoresThreshold{0};
+
+    // Merge the allocation sites into coarser abstract objects:
+    // the sites with the same allocated type in one function
+    // (globals are not in any function and are not merged then)
+    // or the sites with the same allocated type in the whole module.
+    // Only the groups of more than 'coarseningThreshold' sites are merged.
+    enum class AllocCoarsening { none, function, type } allocCoarsening{AllocCoarsening::none};
+    unsigned coarseningThreshold{1};
+
     bool isFS() const { return analysisType == AnalysisType::fs; }
     bool isFSInv() const { return analysisType == AnalysisType::inv; }
     bool isFI() const { return analysisType == AnalysisType::fi; }
+    bool isHybrid() const { return analysisType == AnalysisType::hybrid; }
 };
 
 } // namespace analysis
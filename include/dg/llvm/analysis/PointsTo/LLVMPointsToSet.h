@@ -1,6 +1,8 @@
 #ifndef _LLVM_DG_POINTS_TO_SET_H_
 #define _LLVM_DG_POINTS_TO_SET_H_
 
+#include <vector>
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -19,6 +21,7 @@
 #endif
 
 #include "dg/analysis/PointsTo/PointsToSet.h"
+#include "dg/analysis/PointsTo/PSNode.h"
 
 namespace dg {
 
@@ -46,14 +49,26 @@ struct LLVMPointer {
 // hasUnknown() and hasNull() to express these properties.
 // This also means that it is possible that iterating over the
 // set yields no elements, but empty() == false
-// (the set contains only unknown or null elements)
+// (the set contains only unknown or null elements).
+// A pointer to an object that summarizes several allocation sites
+// is yielded once for every allocation site.
 class LLVMPointsToSet {
     const PointsToSetT& PTSet;
 
+    static const std::vector<analysis::pta::PSNodeAlloc *> *
+    getSummarizedSites(const analysis::pta::Pointer& ptr) {
+        auto alloc = analysis::pta::PSNodeAlloc::get(ptr.target);
+        if (alloc && alloc->isSummary())
+            return &alloc->getSummarizedSites();
+        return nullptr;
+    }
+
 public:
     class const_iterator {
         const PointsToSetT& PTSet;
         PointsToSetT::const_iterator it;
+        // the index of the site if 'it' points to a summary
+        size_t site{0};
 
         const_iterator(const PointsToSetT& S, bool end = false)
         : PTSet(S), it(end ? S.end() : S.begin())  {
@@ -69,6 +84,11 @@ public:
 
     public:
         const_iterator& operator++() {
+            auto sites = getSummarizedSites(*it);
+            if (sites && ++site < sites->size())
+                return *this;
+
+            site = 0;
             ++it;
             _find_valid();
             return *this;
@@ -81,12 +101,18 @@ public:
         }
 
         LLVMPointer operator*() const {
-            auto value = (*it).target->getUserData<llvm::Value>();
+            PSNode *target = (*it).target;
+            if (auto sites = getSummarizedSites(*it))
+                target = (*sites)[site];
+
+            auto value = target->getUserData<llvm::Value>();
             assert(value && "PSNode has associated nullptr as value");
             return LLVMPointer(value, (*it).offset);
         }
 
-        bool operator==(const const_iterator& rhs) const { return it == rhs.it; }
+        bool operator==(const const_iterator& rhs) const {
+            return it == rhs.it && site == rhs.site;
+        }
         bool operator!=(const const_iterator& rhs) const { return !operator==(rhs);}
 
         friend class LLVMPointsToSet;
@@ -100,7 +126,16 @@ public:
     bool hasNull() const { return PTSet.hasNull(); }
     bool hasInvalidated() const { return PTSet.hasInvalidated(); }
     bool empty() const { return PTSet.empty(); }
-    size_t size() const { return PTSet.size(); }
+
+    // the summaries are counted once for every allocation site
+    size_t size() const {
+        size_t num = 0;
+        for (const auto& ptr : PTSet) {
+            auto sites = getSummarizedSites(ptr);
+            num += sites ? sites->size() : 1;
+        }
+        return num;
+    }
 
     bool isSingleton() const { return size() == 1; }
     bool isKnownSingleton() const { return isSingleton()
@@ -109,9 +144,7 @@ public:
 
     LLVMPointer getKnownSingleton() const {
         assert(isKnownSingleton());
-        auto ptr = (*(PTSet.begin()));
-        return LLVMPointer(ptr.target->getUserData<llvm::Value>(),
-                           ptr.offset);
+        return *begin();
     }
 
     const_iterator begin() const { return const_iterator(PTSet);}
@@ -20,10 +20,15 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <map>
+#include <tuple>
+#include <utility>
+
 #include "dg/analysis/PointsTo/PointerGraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysis.h"
 #include "dg/analysis/PointsTo/PointerGraphOptimizations.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
+#include "dg/analysis/PointsTo/PointerAnalysisHybrid.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 
 #include "dg/llvm/analysis/PointsTo/LLVMPointerAnalysisOptions.h"
@@ -46,8 +51,11 @@ class LLVMPointerAnalysisImpl : public PTType
     LLVMPointerGraphBuilder *builder;
 
 public:
-    LLVMPointerAnalysisImpl(PointerGraph *PS, LLVMPointerGraphBuilder *b)
-    : PTType(PS), builder(b) {}
+    // the rest of the arguments is passed to the analysis
+    template <typename... Args>
+    LLVMPointerAnalysisImpl(PointerGraph *PS, LLVMPointerGraphBuilder *b,
+                            Args&&... args)
+    : PTType(PS, std::forward<Args>(args)...), builder(b) {}
 
     // build new subgraphs on calls via pointer
     bool functionPointerCall(PSNode *callsite, PSNode *called) override {
@@ -128,9 +136,19 @@ public:
 
 class LLVMPointerAnalysis
 {
+public:
+    enum class AliasResult { NoAlias, MayAlias, MustAlias };
+
+private:
     PointerGraph *PS = nullptr;
     std::unique_ptr<LLVMPointerGraphBuilder> _builder;
 
+    // results of alias queries, the key is the canonical
+    // (ordered by the pointer) pair of nodes with the sizes
+    using AliasQueryT = std::tuple<const PSNode *, uint64_t,
+                                   const PSNode *, uint64_t>;
+    std::map<AliasQueryT, AliasResult> _aliasCache;
+
     LLVMPointerAnalysisOptions createOptions(const char *entry_func,
                                              uint64_t field_sensitivity,
                                              bool threads = false)
@@ -195,6 +213,17 @@ public:
             return {false, LLVMPointsToSet(getUnknownPTSet())};
     }
 
+    ///
+    // Can the 'size1' bytes of memory pointed by 'V1' overlap
+    // with the 'size2' bytes of memory pointed by 'V2'?
+    // Use Offset::UNKNOWN if the size is not known.
+    // The answers are cached, so ask only after the analysis has finished.
+    AliasResult alias(const llvm::Value *V1, uint64_t size1,
+                      const llvm::Value *V2, uint64_t size2);
+
+    // the number of different alias queries answered so far
+    size_t getNumOfCachedAliasQueries() const { return _aliasCache.size(); }
+
     std::vector<const llvm::Function *>
     getPointsToFunctions(const llvm::Value *calledValue) const
     {
@@ -226,6 +255,14 @@ public:
         return _builder->getFunctionNodes(F);
     }
 
+    ///
+    // The globals that can never contain a pointer and can never
+    // be modified. They are not modelled as memory, the pointers
+    // to them are still in the points-to sets.
+    const analysis::ImmutableGlobals& getImmutableGlobals() const {
+        return _builder->getImmutableGlobals();
+    }
+
     PointerGraph *getPS() { return PS; }
     const PointerGraph *getPS() const { return PS; }
 
@@ -234,12 +271,15 @@ public:
         // run the analysis itself
         assert(_builder && "Incorrectly constructed PTA, missing builder");
 
+        _aliasCache.clear();
         PS = _builder->buildLLVMPointerGraph();
         if (!PS) {
             llvm::errs() << "Pointer Subgraph was not built, aborting\n";
             abort();
         }
 
+        _builder->coarsenAllocations();
+
 /*
         analysis::pta::PointerGraphOptimizer optimizer(PS);
         optimizer.run();
@@ -307,6 +347,25 @@ inline analysis::pta::PointerAnalysis *LLVMPointerAnalysis::createPTA<analysis::
     return new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv>(PS, _builder.get());
 }
 
+template <>
+inline void LLVMPointerAnalysis::run<analysis::pta::PointerAnalysisHybrid>()
+{
+    buildSubgraph();
+
+    LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisHybrid>
+        PTA(PS, _builder.get(), _builder->getFlowSensitiveFunctions());
+    PTA.run();
+}
+
+template <>
+inline analysis::pta::PointerAnalysis *LLVMPointerAnalysis::createPTA<analysis::pta::PointerAnalysisHybrid>()
+{
+    buildSubgraph();
+
+    return new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisHybrid>(
+                    PS, _builder.get(), _builder->getFlowSensitiveFunctions());
+}
+
 } // namespace dg
 
 #endif // _LLVM_DG_POINTS_TO_ANALYSIS_H_
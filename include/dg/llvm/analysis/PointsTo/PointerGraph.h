@@ -1,6 +1,8 @@
 #ifndef _LLVM_DG_POINTER_SUBGRAPH_H_
 #define _LLVM_DG_POINTER_SUBGRAPH_H_
 
+#include <set>
+#include <string>
 #include <unordered_map>
 
 // ignore unused parameters in LLVM libraries
@@ -16,8 +18,10 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/DataLayout.h>
+#include <llvm/IR/GetElementPtrTypeIterator.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/Module.h>
+#include <llvm/ADT/DenseMap.h>
 
 #if (__clang__)
 #pragma clang diagnostic pop // ignore -Wunused-parameter
@@ -26,6 +30,9 @@
 #endif
 
 #include "dg/llvm/analysis/PointsTo/LLVMPointerAnalysisOptions.h"
+#include "dg/llvm/analysis/PromotableAllocas.h"
+#include "dg/llvm/analysis/ExecutionCoverage.h"
+#include "dg/llvm/analysis/ImmutableGlobals.h"
 
 #include "dg/analysis/PointsTo/PointerGraph.h"
 #include "dg/analysis/PointsTo/PointsToMapping.h"
@@ -58,6 +65,22 @@ class LLVMPointerGraphBuilder
 
     bool threads_ = false;
 
+    // local variables that we do not model as memory
+    PromotableAllocas promotable;
+
+    bool isPromotedAccess(const llvm::Instruction *I) {
+        return _options.promoteLocals && promotable.isPromotedAccess(I);
+    }
+
+    // was the block executed? (if we build only the executed code)
+    bool isCovered(const llvm::BasicBlock *B) const {
+        return !_options.coverage || _options.coverage->isCovered(B);
+    }
+
+    // the globals that we do not build as memory, their nodes
+    // are created only when they are used as pointer targets
+    ImmutableGlobals immutableGlobals;
+
     class PSNodesSeq {
         using NodesT = std::vector<PSNode *>;
         NodesT _nodes;
@@ -123,7 +146,8 @@ class LLVMPointerGraphBuilder
 
         void blockAddSuccessors(std::set<const llvm::BasicBlock *>& found_blocks,
                                 LLVMPointerGraphBuilder::PSNodesBlock& blk,
-                                const llvm::BasicBlock& block);
+                                const llvm::BasicBlock& block,
+                                const ExecutionCoverage *coverage);
     };
 
     // helper function that add CFG edges between instructions
@@ -171,6 +195,7 @@ class LLVMPointerGraphBuilder
                         PointerSubgraph *parent);
     PSNodesBlock buildArgumentsStructure(const llvm::Function& F);
     void buildGlobals();
+    PSNode *createImmutableGlobal(const llvm::GlobalVariable *GV);
 
     // add edges that are derived from CFG to the subgraph
     void addProgramStructure();
@@ -189,12 +214,20 @@ class LLVMPointerGraphBuilder
     // map of all built subgraphs - the value type is a pair (root, return)
     std::unordered_map<const llvm::Function *, PointerSubgraph *> subgraphs_map;
 
+    // memoized values of constant expressions
+    llvm::DenseMap<const llvm::ConstantExpr *, Pointer> _constantExprPointers;
+
+    // cached results of typeContainsPointer()
+    std::unordered_map<const llvm::Type *, bool> _containsPointer;
+
     std::vector<PSNodeFork *> forkNodes;
     std::vector<PSNodeJoin *> joinNodes;
 
 public:
     const PointerGraph *getPS() const { return &PS; }
 
+    const ImmutableGlobals& getImmutableGlobals() const { return immutableGlobals; }
+
     inline bool threads() const { return threads_; }
 
     LLVMPointerGraphBuilder(const llvm::Module *m, const LLVMPointerAnalysisOptions& opts)
@@ -238,6 +271,16 @@ public:
 
     std::vector<PSNode *> getFunctionNodes(const llvm::Function *F) const;
 
+    // the names of the functions that should be analyzed
+    // flow-sensitively by the hybrid analysis (see the options)
+    std::set<std::string> getFlowSensitiveFunctions() const;
+
+    // merge the allocation sites into coarser objects as given
+    // by the options (see LLVMPointerAnalysisOptions::allocCoarsening).
+    // Must be called after building the graph, returns the number
+    // of merged allocation sites.
+    unsigned coarsenAllocations();
+
     // this is the same as the getNode, but it
     // creates ConstantExpr
     // FIXME: make this return the points-to set
@@ -266,6 +309,14 @@ public:
     }
 
     void composeMapping(PointsToMapping<PSNode *>&& rhs) {
+        // the values whose nodes were replaced by other nodes
+        for (auto& it : nodes_map) {
+            if (mapping.get(it.first))
+                continue;
+            if (PSNode *nd = rhs.get(it.second.getRepresentant()))
+                mapping.add(it.first, nd);
+        }
+
         mapping.compose(std::move(rhs));
     }
 
@@ -329,6 +380,7 @@ private:
                                    AllocationFunction type);
     PSNodesSeq& createStore(const llvm::Instruction *Inst);
     PSNodesSeq& createLoad(const llvm::Instruction *Inst);
+    PSNodesSeq& createPromotedLoad(const llvm::Instruction *Inst);
     PSNodesSeq& createGEP(const llvm::Instruction *Inst);
     PSNodesSeq& createSelect(const llvm::Instruction *Inst);
     PSNodesSeq& createPHI(const llvm::Instruction *Inst);
@@ -355,16 +407,16 @@ private:
     PSNode *getOperand(const llvm::Value *val);
     PSNode *tryGetOperand(const llvm::Value *val);
     PSNode *getConstant(const llvm::Value *val);
-    Pointer handleConstantGep(const llvm::GetElementPtrInst *GEP);
-    Pointer handleConstantBitCast(const llvm::BitCastInst *BC);
-    Pointer handleConstantPtrToInt(const llvm::PtrToIntInst *P2I);
-    Pointer handleConstantIntToPtr(const llvm::IntToPtrInst *I2P);
-    Pointer handleConstantAdd(const llvm::Instruction *Inst);
-    Pointer handleConstantArithmetic(const llvm::Instruction *Inst);
+    Pointer handleConstantGep(const llvm::ConstantExpr *CE);
+    Pointer handleConstantIntToPtr(const llvm::ConstantExpr *CE);
+    Pointer handleConstantAdd(const llvm::ConstantExpr *CE);
+    Pointer handleConstantArithmetic(const llvm::ConstantExpr *CE);
+    Pointer getConstantOperandPointer(const llvm::Value *val);
     Pointer getConstantExprPointer(const llvm::ConstantExpr *CE);
 
     void checkMemSet(const llvm::Instruction *Inst);
     void addPHIOperands(PSNode *node, const llvm::PHINode *PHI);
+    void addPromotedLoadOperands(PSNode *node, const llvm::LoadInst *LI);
     void addPHIOperands(const llvm::Function& F);
     void addArgumentOperands(const llvm::Function *F, PSNode *arg, int idx);
     void addArgumentOperands(const llvm::CallInst *CI, PSNode *arg, int idx);
@@ -400,9 +452,15 @@ private:
                                            const llvm::CallInst *CInst,
                                            PSNode *callNode);
 
+    // add the pointers from the initializer to the initial contents
+    // of the global. The initializer is stored 'count' times,
+    // 'stride' bytes apart (for repeated elements of arrays)
     void handleGlobalVariableInitializer(const llvm::Constant *C,
                                          PSNodeAlloc *node,
-                                         uint64_t offset = 0);
+                                         uint64_t offset = 0,
+                                         uint64_t stride = 0,
+                                         uint64_t count = 1);
+    bool typeContainsPointer(llvm::Type *Ty);
 
     PSNodesSeq& createMemTransfer(const llvm::IntrinsicInst *Inst);
     PSNodesSeq& createMemSet(const llvm::Instruction *);
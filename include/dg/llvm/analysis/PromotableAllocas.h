@@ -0,0 +1,271 @@
+#ifndef _DG_LLVM_PROMOTABLE_ALLOCAS_H_
+#define _DG_LLVM_PROMOTABLE_ALLOCAS_H_
+
+#include <cassert>
+#include <vector>
+#include <set>
+#include <map>
+#include <unordered_map>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 5))
+ #include <llvm/Support/CFG.h>
+#else
+ #include <llvm/IR/CFG.h>
+#endif
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/analysis/ExecutionCoverage.h"
+
+namespace dg {
+namespace analysis {
+
+///
+// Find allocas that could be promoted to registers -- allocas of scalars
+// whose address does not escape and that are only loaded and stored
+// as a whole. On unoptimized code, these are the most of local variables.
+// Such allocas do not need to be modelled as memory in pointer analysis
+// and reaching definitions: every load of such alloca reads the values
+// of the stores (to this alloca) that reach the load in the CFG.
+// The information is computed lazily, once for every function.
+class PromotableAllocas {
+    struct FunctionInfo {
+        std::set<const llvm::AllocaInst *> allocas;
+        std::unordered_map<const llvm::LoadInst *,
+                           std::vector<const llvm::StoreInst *>> reachingStores;
+    };
+
+    std::unordered_map<const llvm::Function *, FunctionInfo> _functions;
+
+    // the blocks that are not covered are not executed,
+    // so their stores do not reach any load
+    const ExecutionCoverage *_coverage{nullptr};
+
+    bool isCovered(const llvm::BasicBlock *B) const {
+        return !_coverage || _coverage->isCovered(B);
+    }
+
+    static bool isPromotable(const llvm::AllocaInst *AI) {
+        using namespace llvm;
+
+        // vectors are modelled as memory even when they are in registers
+        llvm::Type *Ty = AI->getAllocatedType();
+        if (AI->isArrayAllocation() ||
+            !Ty->isSingleValueType() || Ty->isVectorTy())
+            return false;
+
+        for (auto I = AI->use_begin(), E = AI->use_end(); I != E; ++I) {
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 5))
+            const llvm::Value *use = *I;
+#else
+            const llvm::Value *use = I->getUser();
+#endif
+            if (auto LI = dyn_cast<LoadInst>(use)) {
+                if (LI->isVolatile() || LI->getType() != AI->getAllocatedType())
+                    return false;
+            } else if (auto SI = dyn_cast<StoreInst>(use)) {
+                // storing the address of the alloca makes it escape
+                if (SI->isVolatile() || SI->getValueOperand() == AI ||
+                    SI->getValueOperand()->getType() != AI->getAllocatedType())
+                    return false;
+            } else {
+                // casts, GEPs, calls, ...
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static const llvm::AllocaInst *getPromotedAlloca(const FunctionInfo& info,
+                                                     const llvm::Value *ptr) {
+        auto AI = llvm::dyn_cast<llvm::AllocaInst>(ptr);
+        if (AI && info.allocas.count(AI) > 0)
+            return AI;
+        return nullptr;
+    }
+
+    // compute the stores that reach the loads of the promotable allocas
+    // by a simple data-flow analysis over basic blocks
+    void computeReachingStores(const llvm::Function *F, FunctionInfo& info) {
+        using namespace llvm;
+        using StoresT = std::map<const AllocaInst *, std::set<const StoreInst *>>;
+
+        // the last store to each alloca in every block
+        std::map<const BasicBlock *, std::map<const AllocaInst *,
+                                              const StoreInst *>> lastStores;
+        for (const BasicBlock& B : *F) {
+            if (!isCovered(&B))
+                continue;
+
+            auto& last = lastStores[&B];
+            for (const Instruction& I : B) {
+                if (auto SI = dyn_cast<StoreInst>(&I)) {
+                    if (auto AI = getPromotedAlloca(info, SI->getPointerOperand()))
+                        last[AI] = SI;
+                }
+            }
+        }
+
+        std::map<const BasicBlock *, StoresT> out;
+        std::vector<const BasicBlock *> queue;
+        std::set<const BasicBlock *> queued;
+        for (const BasicBlock& B : *F) {
+            if (!isCovered(&B))
+                continue;
+
+            queue.push_back(&B);
+            queued.insert(&B);
+        }
+
+        auto getIn = [this, &out](const BasicBlock *B) {
+            StoresT in;
+            for (auto P = pred_begin(B), E = pred_end(B); P != E; ++P) {
+                if (!isCovered(*P))
+                    continue;
+
+                for (auto& it : out[*P])
+                    in[it.first].insert(it.second.begin(), it.second.end());
+            }
+            return in;
+        };
+
+        while (!queue.empty()) {
+            const BasicBlock *B = queue.back();
+            queue.pop_back();
+            queued.erase(B);
+
+            StoresT newOut = getIn(B);
+            for (auto& it : lastStores[B]) {
+                auto& stores = newOut[it.first];
+                stores.clear();
+                stores.insert(it.second);
+            }
+
+            auto& oldOut = out[B];
+            if (newOut == oldOut)
+                continue;
+
+            oldOut.swap(newOut);
+            for (auto S = succ_begin(B), E = succ_end(B); S != E; ++S) {
+                if (isCovered(*S) && queued.insert(*S).second)
+                    queue.push_back(*S);
+            }
+        }
+
+        // map the stores to the loads
+        for (const BasicBlock& B : *F) {
+            if (!isCovered(&B))
+                continue;
+
+            std::map<const AllocaInst *, const StoreInst *> last;
+            StoresT in;
+            bool haveIn = false;
+
+            for (const Instruction& I : B) {
+                if (auto SI = dyn_cast<StoreInst>(&I)) {
+                    if (auto AI = getPromotedAlloca(info, SI->getPointerOperand()))
+                        last[AI] = SI;
+                } else if (auto LI = dyn_cast<LoadInst>(&I)) {
+                    auto AI = getPromotedAlloca(info, LI->getPointerOperand());
+                    if (!AI)
+                        continue;
+
+                    auto& stores = info.reachingStores[LI];
+                    auto it = last.find(AI);
+                    if (it != last.end()) {
+                        stores.push_back(it->second);
+                        continue;
+                    }
+
+                    if (!haveIn) {
+                        in = getIn(&B);
+                        haveIn = true;
+                    }
+
+                    auto& reaching = in[AI];
+                    stores.assign(reaching.begin(), reaching.end());
+                }
+            }
+        }
+    }
+
+    const FunctionInfo& getInfo(const llvm::Function *F) {
+        auto it = _functions.find(F);
+        if (it != _functions.end())
+            return it->second;
+
+        auto& info = _functions[F];
+        for (const llvm::BasicBlock& B : *F) {
+            for (const llvm::Instruction& I : B) {
+                if (auto AI = llvm::dyn_cast<llvm::AllocaInst>(&I)) {
+                    if (isPromotable(AI))
+                        info.allocas.insert(AI);
+                }
+            }
+        }
+
+        if (!info.allocas.empty())
+            computeReachingStores(F, info);
+
+        return info;
+    }
+
+public:
+    // compute the reaching stores only on the covered blocks.
+    // Must be called before any query.
+    void setCoverage(const ExecutionCoverage *coverage) {
+        assert(_functions.empty() && "Already computed some information");
+        _coverage = coverage;
+    }
+
+    // is the value an alloca that is promoted to a register?
+    bool isPromoted(const llvm::Value *val) {
+        auto AI = llvm::dyn_cast<llvm::AllocaInst>(val);
+        if (!AI)
+            return false;
+        return getInfo(AI->getParent()->getParent()).allocas.count(AI) > 0;
+    }
+
+    // is the instruction a load or store of a promoted alloca?
+    bool isPromotedAccess(const llvm::Instruction *I) {
+        if (auto LI = llvm::dyn_cast<llvm::LoadInst>(I))
+            return isPromoted(LI->getPointerOperand());
+        if (auto SI = llvm::dyn_cast<llvm::StoreInst>(I))
+            return isPromoted(SI->getPointerOperand());
+        return false;
+    }
+
+    // get the stores that write the value read by the load
+    // of a promoted alloca (empty if the alloca may be uninitialized
+    // on every path to the load)
+    const std::vector<const llvm::StoreInst *>&
+    getReachingStores(const llvm::LoadInst *LI) {
+        static const std::vector<const llvm::StoreInst *> empty;
+        const auto& info = getInfo(LI->getParent()->getParent());
+        auto it = info.reachingStores.find(LI);
+        return it == info.reachingStores.end() ? empty : it->second;
+    }
+};
+
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_LLVM_PROMOTABLE_ALLOCAS_H_
@@ -91,10 +91,10 @@ public:
     RDNode *getMapping(const llvm::Value *val);
     const RDNode *getMapping(const llvm::Value *val) const;
 
-    bool isUse(const llvm::Value *val) const {
-        auto nd = getNode(val);
-        return nd && !nd->getUses().empty();
-    }
+    // loads of promoted local variables have no node,
+    // but they are uses too (see LLVMAnalysisOptions::promoteLocals),
+    // and so are the reads of immutable globals (see ImmutableGlobals)
+    bool isUse(const llvm::Value *val) const;
 
     bool isDef(const llvm::Value *val) const {
         auto nd = getNode(val);
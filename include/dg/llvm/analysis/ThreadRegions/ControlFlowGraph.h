@@ -42,7 +42,8 @@ private:
     std::unique_ptr<CriticalSectionsBuilder>    criticalSectionsBuilder;
 
 public:
-    ControlFlowGraph(dg::LLVMPointerAnalysis * pointsToAnalysis);
+    // 'workers' is the number of threads that build the graphs of functions
+    ControlFlowGraph(dg::LLVMPointerAnalysis * pointsToAnalysis, unsigned workers = 1);
 
     ~ControlFlowGraph();
 
@@ -54,7 +55,7 @@ public:
 
     std::set<const llvm::CallInst *> getCorrespongingUnlocks(const llvm::CallInst * callInst) const;
 
-    std::set<const llvm::Instruction *> getCorrespondingCriticalSection(const llvm::CallInst * callInst) const;
+    const std::set<const llvm::Instruction *> & getCorrespondingCriticalSection(const llvm::CallInst * callInst) const;
 
     void buildFunction(const llvm::Function *function);
 
@@ -2,6 +2,10 @@
 #include "dg/analysis/PointsTo/PointsToSet.h"
 #include "dg/analysis/PointsTo/PointerGraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysis.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
+#include "dg/analysis/PointsTo/PointerAnalysisHybrid.h"
 
 #include "dg/util/debug.h"
 
@@ -36,7 +40,8 @@ static inline bool canBeDereferenced(const Pointer& ptr)
     return true;
 }
 
-bool PointerAnalysis::processLoad(PSNode *node)
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::processLoad(PSNode *node)
 {
     bool changed = false;
     PSNode *operand = node->getOperand(0);
@@ -56,8 +61,8 @@ bool PointerAnalysis::processLoad(PSNode *node)
 
         // find memory objects holding relevant points-to
         // information
-        std::vector<MemoryObject *> objects;
-        getMemoryObjects(node, ptr, objects);
+        objects.clear();
+        analysis()->getMemoryObjects(node, ptr, objects);
 
         PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
         assert(target && "Target is not memory allocation");
@@ -76,6 +81,13 @@ bool PointerAnalysis::processLoad(PSNode *node)
         }
 
         for (MemoryObject *o : objects) {
+            // the offset into any element of an array, we may read
+            // every offset that is the same offset in some element
+            if (ptr.offset.isStrided()) {
+                changed |= loadStrided(node, o, ptr.offset, target);
+                continue;
+            }
+
             // is the offset to the memory unknown?
             // In that case everything can be referenced,
             // so we need to copy the whole points-to
@@ -100,6 +112,17 @@ bool PointerAnalysis::processLoad(PSNode *node)
                 continue;
             }
 
+            // the pointers written via strided offsets
+            // that can be written to this offset
+            bool hasStrided = false;
+            for (auto S = o->pointsTo.lower_bound(Offset::getStridedBegin());
+                 S != o->pointsTo.end() && S->first.isStrided(); ++S) {
+                if (S->first.mayBeEqual(ptr.offset)) {
+                    changed |= node->addPointsTo(S->second);
+                    hasStrided = true;
+                }
+            }
+
             // load from empty points-to set
             // - that is load from unknown memory
             auto it = o->pointsTo.find(ptr.offset);
@@ -111,7 +134,7 @@ bool PointerAnalysis::processLoad(PSNode *node)
                 // if we don't have a definition even with unknown offset
                 // it is an error
                 // FIXME: don't triplicate the code!
-                else if (!o->pointsTo.count(Offset::UNKNOWN))
+                else if (!hasStrided && !o->pointsTo.count(Offset::UNKNOWN))
                     changed |= errorEmptyPointsTo(node, target);
             } else {
                 // we have pointers on that memory, so we can
@@ -131,16 +154,40 @@ bool PointerAnalysis::processLoad(PSNode *node)
     return changed;
 }
 
-bool PointerAnalysis::processMemcpy(PSNode *node)
+// load from a strided offset: read the pointers from all the offsets
+// that can be the offset in some element of the memory
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::loadStrided(PSNode *node, MemoryObject *o,
+                                                    const Offset& offset,
+                                                    PSNodeAlloc *target)
+{
+    bool changed = false;
+    bool found = false;
+    for (auto& it : o->pointsTo) {
+        if (offset.mayBeEqual(it.first)) {
+            changed |= node->addPointsTo(it.second);
+            found = true;
+        }
+    }
+
+    // some elements may have not been written, if the memory
+    // is zero initialized, we can read the null from them
+    if (target->isZeroInitialized())
+        changed |= node->addPointsTo(NullPointer);
+    else if (!found)
+        changed |= errorEmptyPointsTo(node, target);
+
+    return changed;
+}
+
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::processMemcpy(PSNode *node)
 {
     bool changed = false;
     PSNodeMemcpy *memcpy = PSNodeMemcpy::get(node);
     PSNode *srcNode = memcpy->getSource();
     PSNode *destNode = memcpy->getDestination();
 
-    std::vector<MemoryObject *> srcObjects;
-    std::vector<MemoryObject *> destObjects;
-
     // gather srcNode pointer objects
     for (const Pointer& ptr : srcNode->pointsTo) {
         assert(ptr.target && "Got nullptr as target");
@@ -149,7 +196,7 @@ bool PointerAnalysis::processMemcpy(PSNode *node)
             continue;
 
         srcObjects.clear();
-        getMemoryObjects(node, ptr, srcObjects);
+        analysis()->getMemoryObjects(node, ptr, srcObjects);
 
         if (srcObjects.empty()){
             abort();
@@ -164,26 +211,24 @@ bool PointerAnalysis::processMemcpy(PSNode *node)
                 continue;
 
             destObjects.clear();
-            getMemoryObjects(node, dptr, destObjects);
+            analysis()->getMemoryObjects(node, dptr, destObjects);
 
             if (destObjects.empty()) {
                 abort();
                 return changed;
             }
 
-            changed |= processMemcpy(srcObjects, destObjects,
-                                     ptr, dptr,
-                                     memcpy->getLength());
+            changed |= processMemcpy(ptr, dptr, memcpy->getLength());
         }
     }
 
     return changed;
 }
 
-bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *>& srcObjects,
-                                    std::vector<MemoryObject *>& destObjects,
-                                    const Pointer& sptr, const Pointer& dptr,
-                                    Offset len)
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::processMemcpy(const Pointer& sptr,
+                                                      const Pointer& dptr,
+                                                      Offset len)
 {
     bool changed = false;
     Offset srcOffset = sptr.offset;
@@ -223,53 +268,187 @@ bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *>& srcObjects,
         // copy every pointer from srcObjects that is in
         // the range to destination's objects
         for (MemoryObject *so : srcObjects) {
-            for (auto& src : so->pointsTo) { // src.first is offset,
-                                             // src.second is a PointToSet
-
-                // if the offset is inbound of the copied memory
-                // or we copy from unknown offset, or this pointer
-                // is on unknown offset, copy this pointer
-                if (src.first.isUnknown() ||
-                    srcOffset.isUnknown() ||
-                    (srcOffset <= src.first &&
-                     (len.isUnknown() ||
-                      *src.first - *srcOffset < *len))) {
-
-                    // copy the pointer, but shift it by the offsets
-                    // we are working with
-                    if (!src.first.isUnknown() && !srcOffset.isUnknown() &&
-                        !destOffset.isUnknown()) {
-                        // check that new offset does not overflow Offset::UNKNOWN
-                        if (Offset::UNKNOWN - *destOffset <= *src.first - *srcOffset) {
-                            changed |= destO->addPointsTo(Offset::UNKNOWN, src.second);
-                            continue;
-                        }
+            // with invalidated nodes the memory objects do not
+            // only grow (they can be overwritten by INVALIDATED),
+            // so we cannot rely on the versions
+            if (options.invalidateNodes) {
+                changed |= memcpyPointers(destO, so, srcOffset,
+                                          destOffset, len);
+                continue;
+            }
 
-                        Offset newOff = *src.first - *srcOffset + *destOffset;
-                        if (newOff >= destO->node->getSize() ||
-                            newOff >= options.fieldSensitivity) {
-                            changed |= destO->addPointsTo(Offset::UNKNOWN, src.second);
-                        } else {
-                            changed |= destO->addPointsTo(newOff, src.second);
-                        }
-                    } else {
-                        changed |= destO->addPointsTo(Offset::UNKNOWN, src.second);
-                    }
-                }
+            // if the source object did not change since the last time
+            // we copied it to this destination, there is nothing new
+            // to copy (the destination object can only grow)
+            size_t version = so->version;
+            auto& done = memcpyDone[MemcpyKeyT(so, destO, srcOffset,
+                                               destOffset, len)];
+            if (done == version + 1)
+                continue;
+
+            changed |= memcpyPointers(destO, so, srcOffset,
+                                      destOffset, len);
+            // store the version that we had before copying, so that
+            // memcpy to the same object is processed again
+            done = version + 1;
+        }
+    }
+
+    return changed;
+}
+
+// Is the mapping of offsets from the source to the destination
+// the identity? That is, we copy from offset 0 to offset 0 and
+// all the pointers in the source fit into the copied range
+// and into the destination object.
+static bool copiesWholeObject(const MemoryObject *destO,
+                              const MemoryObject *so,
+                              Offset srcOffset, Offset destOffset,
+                              Offset len, Offset fieldSensitivity)
+{
+    if (*srcOffset != 0 || *destOffset != 0)
+        return false;
+
+    // Offset::UNKNOWN is the greatest offset, so find the greatest
+    // known offset in the source object
+    auto it = so->pointsTo.lower_bound(Offset::UNKNOWN);
+    if (it == so->pointsTo.begin())
+        return true; // only unknown offset (or no pointers at all)
+
+    Offset maxOff = (--it)->first;
+    return (len.isUnknown() || maxOff < len) &&
+           maxOff < destO->node->getSize() &&
+           maxOff < fieldSensitivity;
+}
+
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::memcpyPointers(MemoryObject *destO,
+                                                       const MemoryObject *so,
+                                                       Offset srcOffset,
+                                                       Offset destOffset,
+                                                       Offset len)
+{
+    if (copiesWholeObject(destO, so, srcOffset, destOffset,
+                          len, options.fieldSensitivity)) {
+        return destO->merge(*so);
+    }
+
+    bool changed = false;
+    // copy the pointer from srcOff, but shift it by the offsets
+    // we are working with
+    auto copy = [&](Offset srcOff, const PointsToSetT& S) {
+        if (!srcOff.isUnknown() && !srcOffset.isUnknown() &&
+            !destOffset.isUnknown()) {
+            // check that new offset does not overflow Offset::UNKNOWN
+            if (Offset::UNKNOWN - *destOffset <= *srcOff - *srcOffset) {
+                changed |= destO->addPointsTo(Offset::UNKNOWN, S);
+                return;
+            }
+
+            Offset newOff = *srcOff - *srcOffset + *destOffset;
+            if (newOff >= destO->node->getSize() ||
+                newOff >= options.fieldSensitivity) {
+                changed |= destO->addPointsTo(Offset::UNKNOWN, S);
+            } else {
+                changed |= destO->addPointsTo(newOff, S);
             }
+        } else {
+            changed |= destO->addPointsTo(Offset::UNKNOWN, S);
         }
+    };
+
+    // if we copy from unknown offset, copy everything
+    if (srcOffset.isUnknown()) {
+        for (auto& src : so->pointsTo)
+            copy(src.first, src.second);
+        return changed;
+    }
+
+    // copy only the pointers that are inbound of the copied memory.
+    // If the copied memory ends on unknown offset (or the end overflows),
+    // the range contains also the pointers on unknown offset
+    // (Offset::UNKNOWN is the greatest offset)
+    Offset rangeEnd = srcOffset + len;
+    auto I = so->pointsTo.lower_bound(srcOffset);
+    auto E = rangeEnd.isUnknown() ? so->pointsTo.end()
+                                  : so->pointsTo.lower_bound(rangeEnd);
+    for (; I != E; ++I)
+        copy(I->first, I->second);
+
+    // the pointers on unknown and strided offsets are copied always
+    if (!rangeEnd.isUnknown()) {
+        for (auto S = so->pointsTo.lower_bound(Offset::getStridedBegin());
+             S != so->pointsTo.end() && S->first.isStrided(); ++S)
+            copy(S->first, S->second);
+
+        auto U = so->pointsTo.find(Offset::UNKNOWN);
+        if (U != so->pointsTo.end())
+            copy(U->first, U->second);
     }
 
     return changed;
 }
 
-bool PointerAnalysis::processGep(PSNode *node) {
+// Did the GEP on a loop create too many offsets into the target?
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::widenGep(PSNode *node,
+                                                 PSNode *target) const {
+    auto it = gepOffsetsNum.find({node, target});
+    return it != gepOffsetsNum.end() &&
+           it->second >= options.gepWideningThreshold;
+}
+
+// Add the offset of a GEP to the pointer when one of them is strided.
+// Strided offsets do not grow (the stride can only get smaller),
+// so these need not be widened on loops.
+template <typename AnalysisT>
+Offset
+PointerAnalysisSolver<AnalysisT>::getStridedOffset(const Pointer& ptr,
+                                                   const Offset& gepOffset) const {
+    Offset new_offset = ptr.offset + gepOffset;
+    if (!new_offset.isStrided())
+        return new_offset;
+
+    // if the object is not greater than the stride, there is
+    // only one element that the pointer can point into
+    Offset::type size = ptr.target->getSize();
+    if (size > 0 && new_offset.getStride() >= size)
+        new_offset = new_offset.getElementOffset();
+
+    if (!new_offset.isStrided() &&
+        (new_offset == 0 || new_offset < size) &&
+        new_offset < options.fieldSensitivity)
+        return new_offset;
+
+    if (new_offset.isStrided() &&
+        new_offset.getElementOffset() < *options.fieldSensitivity)
+        return new_offset;
+
+    return Offset::UNKNOWN;
+}
+
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::processGep(PSNode *node) {
     bool changed = false;
 
     PSNodeGep *gep = PSNodeGep::get(node);
     assert(gep && "Non-GEP given");
 
+    // GEPs on loops (e.g., incrementing a pointer) may create a new offset
+    // in every iteration, so count the offsets and widen them
+    // to UNKNOWN after a while. Other GEPs create only finitely
+    // many offsets, so these are left precise
+    auto subg = node->getParent();
+    bool onLoop = options.gepWideningThreshold > 0 &&
+                  subg && subg->computedLoops() && subg->getLoop(node);
+
     for (const Pointer& ptr : gep->getSource()->pointsTo) {
+        if (ptr.offset.isStrided() || gep->getOffset().isStrided()) {
+            changed |= node->addPointsTo(ptr.target,
+                                         getStridedOffset(ptr, gep->getOffset()));
+            continue;
+        }
+
         Offset::type new_offset;
         if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
             // set it like this to avoid overflow when adding
@@ -281,19 +460,24 @@ bool PointerAnalysis::processGep(PSNode *node) {
         // will have unknown offset with the exception that it points
         // to the begining of the memory - therefore make 0 exception
         if ((new_offset == 0 || new_offset < ptr.target->getSize())
-            && new_offset < *options.fieldSensitivity)
-            changed |= node->addPointsTo(ptr.target, new_offset);
-        else
+            && new_offset < *options.fieldSensitivity
+            && !(onLoop && widenGep(node, ptr.target))) {
+            if (node->addPointsTo(ptr.target, new_offset)) {
+                if (onLoop)
+                    ++gepOffsetsNum[{node, ptr.target}];
+                changed = true;
+            }
+        } else
             changed |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
     }
 
     return changed;
 }
 
-bool PointerAnalysis::processNode(PSNode *node)
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::processNode(PSNode *node)
 {
     bool changed = false;
-    std::vector<MemoryObject *> objects;
 
 #ifdef DEBUG_ENABLED
     size_t prev_size = node->pointsTo.size();
@@ -311,7 +495,7 @@ bool PointerAnalysis::processNode(PSNode *node)
                     continue;
 
                 objects.clear();
-                getMemoryObjects(node, ptr, objects);
+                analysis()->getMemoryObjects(node, ptr, objects);
                 for (MemoryObject *o : objects) {
                     changed |= o->addPointsTo(ptr.offset,
                                               node->getOperand(0)->pointsTo);
@@ -440,6 +624,24 @@ bool PointerAnalysis::processNode(PSNode *node)
     return changed;
 }
 
+template <typename AnalysisT>
+bool PointerAnalysisSolver<AnalysisT>::iteration() {
+    assert(changed.empty());
+
+    AnalysisT *A = analysis();
+    for (PSNode *cur : to_process) {
+        bool enq = false;
+        enq |= A->beforeProcessed(cur);
+        enq |= processNode(cur);
+        enq |= A->afterProcessed(cur);
+
+        if (enq)
+            enqueue(cur);
+    }
+
+    return !changed.empty();
+}
+
 void PointerAnalysis::sanityCheck() {
 #ifndef NDEBUG
     assert(NULLPTR->pointsTo.size() == 1
@@ -486,6 +688,9 @@ void PointerAnalysis::run() {
     
     initialize_queue();
 
+    iterationsNum = 0;
+    processedNodesNum = 0;
+
 #if DEBUG_ENABLED
     int n = 0;
 #endif
@@ -498,6 +703,9 @@ void PointerAnalysis::run() {
         ++n;
 #endif
 
+        ++iterationsNum;
+        processedNodesNum += to_process.size();
+
         iteration();
         queue_changed();
     } while (!to_process.empty());
@@ -520,6 +728,12 @@ void PointerAnalysis::run() {
     DBG_SECTION_END(pta, "Running pointer analysis done");
 }
 
+// instantiate the solver for our analyses
+template class PointerAnalysisSolver<PointerAnalysisFI>;
+template class PointerAnalysisSolver<PointerAnalysisFS>;
+template class PointerAnalysisSolver<PointerAnalysisFSInv>;
+template class PointerAnalysisSolver<PointerAnalysisHybrid>;
+
 
 } // namespace pta
 } // namespace analysis
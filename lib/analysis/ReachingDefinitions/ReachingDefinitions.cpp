@@ -1,5 +1,7 @@
 #include <set>
+#include <map>
 #include <vector>
+#include <algorithm>
 
 #include "dg/analysis/ReachingDefinitions/RDMap.h"
 #include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
@@ -39,7 +41,55 @@ void ReachingDefinitionsGraph::buildBBlocks(bool dce) {
 }
 
 
-void ReachingDefinitionsGraph::removeUselessNodes() {
+// The node does not take part in the data-flow (it has no definitions
+// nor uses) and nobody refers to it (it has no user data).
+static bool isUseless(const RDNode *n) {
+    switch (n->getType()) {
+        // allocations are targets of def-sites
+        case RDNodeType::ALLOC:
+        case RDNodeType::DYN_ALLOC:
+        case RDNodeType::FORK:
+        case RDNodeType::JOIN:
+            return false;
+        default:
+            break;
+    }
+
+    return n->getUserData<void>() == nullptr &&
+           n->defs.empty() && n->overwrites.empty() && n->uses.empty();
+}
+
+size_t ReachingDefinitionsGraph::removeUselessNodes() {
+    assert(getRoot() && "No root node");
+    assert(_bblocks.empty() && "Removing nodes after building the blocks");
+
+    size_t removed = 0;
+    for (auto& nd : _nodes) {
+        if (!nd || nd.get() == root || !isUseless(nd.get()))
+            continue;
+
+        // do not create a quadratic number of edges
+        // (and keep the self-loops)
+        if (nd->predecessorsNum() > 1 && nd->successorsNum() > 1)
+            continue;
+        if (std::find(nd->getSuccessors().begin(), nd->getSuccessors().end(),
+                      nd.get()) != nd->getSuccessors().end())
+            continue;
+
+        // connect the predecessors to the successors, so chains
+        // of useless nodes are spliced out one node at a time
+        // and the blocks built later are longer
+        nd->isolate();
+        nd.reset();
+        ++removed;
+    }
+
+    _nodes.erase(std::remove(_nodes.begin(), _nodes.end(), nullptr),
+                 _nodes.end());
+
+    DBG(dda, "Removed " << removed << " useless nodes, "
+                        << _nodes.size() << " nodes left");
+    return removed;
 }
 
 
@@ -48,6 +98,7 @@ bool ReachingDefinitionsAnalysis::processNode(RDNode *node)
     bool changed = false;
 
     // merge maps from predecessors
+    mergedMapsNum += node->predecessorsNum();
     for (RDNode *n : node->getPredecessors())
         changed |= node->def_map.merge(&n->def_map,
                                        &node->overwrites /* strong update */,
@@ -67,6 +118,9 @@ void ReachingDefinitionsAnalysis::run()
     std::vector<RDNode *> to_process = getNodes(getRoot());
     std::vector<RDNode *> changed;
 
+    processedNodesNum = 0;
+    mergedMapsNum = 0;
+
 #ifdef DEBUG_ENABLED
     int n = 0;
 #endif
@@ -80,6 +134,7 @@ void ReachingDefinitionsAnalysis::run()
         ++n;
 #endif
         unsigned last_processed_num = to_process.size();
+        processedNodesNum += to_process.size();
         changed.clear();
 
         for (RDNode *cur : to_process) {
@@ -145,6 +200,38 @@ ReachingDefinitionsAnalysis::getReachingDefinitions(RDNode *use) {
     return std::vector<RDNode *>(ret.begin(), ret.end());
 }
 
+void SSAReachingDefinitionsAnalysis::addPhis(RDBBlock *block, RDNode *target,
+                                             const std::vector<DefinitionsMap<RDNode>::IntervalT>& intervals,
+                                             std::vector<RDNode *>& defs) {
+    if (intervals.empty())
+        return;
+
+    std::vector<RDNode *> phis;
+    phis.reserve(intervals.size());
+    for (auto& interval : intervals) {
+        RDNode *phi = graph.create(RDNodeType::PHI);
+        phi->addOverwrites(target, interval.start, interval.length());
+        // update definitions in the block -- this
+        // phi node defines previously uncovered memory
+        assert(block->definitions.get({target, interval.start, interval.length()}).empty());
+        block->definitions.update({target, interval.start, interval.length()}, phi);
+
+        // this represents the sought definition
+        defs.push_back(phi);
+        phis.push_back(phi);
+        _phis.push_back(phi);
+    }
+
+    // Inserting at the beginning of the block should not
+    // invalidate the iterator
+    block->prependAndUpdateCFG(phis);
+
+    // phis for unknown memory change the definitions of every
+    // memory in this block, so the cached definitions may be outdated
+    if (target->isUnknown())
+        _definitionsCache.clear();
+}
+
 ///
 // Find the nodes that define the given def-site.
 // Create PHI nodes if needed.
@@ -162,6 +249,11 @@ SSAReachingDefinitionsAnalysis::findDefinitions(RDBBlock *block,
 
     assert(ds.target && "Target is null");
 
+    auto key = DefinitionsCacheKeyT(block, ds.target, ds.offset, ds.len);
+    auto cached = _definitionsCache.find(key);
+    if (cached != _definitionsCache.end())
+        return cached->second;
+
     // Find known definitions.
     auto defSet = block->definitions.get(ds);
     std::vector<RDNode *> defs(defSet.begin(), defSet.end());
@@ -172,34 +264,20 @@ SSAReachingDefinitionsAnalysis::findDefinitions(RDBBlock *block,
 
     // Find definitions that are not in this block (if any).
     auto uncovered = block->definitions.undefinedIntervals(ds);
-    for (auto& interval : uncovered) {
-        // if we have a unique predecessor, try finding definitions
-        // and creating the new PHI nodes there.
-        if (auto pred = block->getSinglePredecessor()) {
-            auto pdefs = findDefinitions(pred, ds);
-            defs.insert(defs.end(), pdefs.begin(), pdefs.end());
-        } else {
-            // Several predecessors -- we must create a PHI.
-            // This phi is the definition that we are looking for.
-            _phis.emplace_back(graph.create(RDNodeType::PHI));
-            _phis.back()->addOverwrites(ds.target,
-                                       interval.start,
-                                       interval.length());
-            // update definitions in the block -- this
-            // phi node defines previously uncovered memory
-            assert(block->definitions.get({ds.target,
-                                           interval.start, interval.length()}
-                                         ).empty());
-            block->definitions.update({ds.target, interval.start, interval.length()},
-                                      _phis.back());
-
-            // Inserting at the beginning of the block should not
-            // invalidate the iterator
-            block->prependAndUpdateCFG(_phis.back());
-
-            // this represents the sought definition
-            defs.push_back(_phis.back());
-        }
+    if (uncovered.empty())
+        return defs;
+
+    // if we have a unique predecessor, try finding definitions
+    // and creating the new PHI nodes there.
+    // Several predecessors -- we must create PHIs.
+    // These phis are the definitions that we are looking for.
+    if (auto pred = block->getSinglePredecessor()) {
+        auto pdefs = findDefinitions(pred, ds);
+        defs.insert(defs.end(), pdefs.begin(), pdefs.end());
+        // the search in predecessors is what takes the time, remember it
+        _definitionsCache.emplace(key, defs);
+    } else {
+        addPhis(block, ds.target, uncovered, defs);
     }
 
     return defs;
@@ -221,24 +299,7 @@ SSAReachingDefinitionsAnalysis::findDefinitionsInBlock(RDBBlock *block,
 
     // find out which bytes are not covered yet
     // and create phi nodes for these intervals
-    auto uncovered = block->definitions.undefinedIntervals(ds);
-    for (auto& interval : uncovered) {
-        _phis.emplace_back(graph.create(RDNodeType::PHI));
-        _phis.back()->addOverwrites(ds.target,
-                                    interval.start,
-                                    interval.length());
-        // update definitions in the block -- this
-        // phi node defines previously uncovered memory
-        assert(block->definitions.get({ds.target, interval.start, interval.length()}).empty());
-        block->definitions.update({ds.target, interval.start, interval.length()},
-                                  _phis.back());
-
-        // Inserting at the beginning of the block should not
-        // invalidate the iterator
-        block->prependAndUpdateCFG(_phis.back());
-
-        defs.push_back(_phis.back());
-    }
+    addPhis(block, ds.target, block->definitions.undefinedIntervals(ds), defs);
 
     return defs;
 }
@@ -292,12 +353,57 @@ void SSAReachingDefinitionsAnalysis::performLvn() {
     DBG_SECTION_END(dda, "LVN finished");
 }
 
+// number the blocks in reverse post-order
+static std::map<RDBBlock *, unsigned> computeRPO(RDBBlock *entry) {
+    std::map<RDBBlock *, unsigned> order;
+    std::vector<RDBBlock *> postorder;
+    // (block, the index of the next successor to visit)
+    std::vector<std::pair<RDBBlock *, unsigned>> stack;
+    std::set<RDBBlock *> visited;
+
+    visited.insert(entry);
+    stack.emplace_back(entry, 0);
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        RDBBlock *block = top.first;
+        auto& succs = block->getLast()->getSuccessors();
+        if (top.second < succs.size()) {
+            RDBBlock *succ = succs[top.second++]->getBBlock();
+            if (succ && visited.insert(succ).second)
+                stack.emplace_back(succ, 0);
+        } else {
+            postorder.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    unsigned num = 0;
+    for (auto it = postorder.rbegin(), et = postorder.rend(); it != et; ++it)
+        order.emplace(*it, num++);
+
+    return order;
+}
+
 void SSAReachingDefinitionsAnalysis::performGvn() {
     DBG_SECTION_BEGIN(dda, "Starting GVN");
-    std::set<RDNode *> phis(_phis.begin(), _phis.end());
-
+    auto rpo = computeRPO(graph.getRoot()->getBBlock());
+
+    // process the phis in the order of their blocks in RPO,
+    // so that the definitions in predecessors are usually
+    // found (and cached) before their successors ask for them.
+    // The second element is the index of the phi in _phis.
+    std::set<std::pair<unsigned, size_t>> phis;
+    auto queuePhis = [&](size_t from) {
+        for (auto i = from; i < _phis.size(); ++i)
+            phis.emplace(rpo[_phis[i]->getBBlock()], i);
+    };
+
+    _definitionsCache.clear();
+    queuePhis(0);
+
+    std::vector<RDBBlock *> preds;
     while(!phis.empty()) {
-        RDNode *phi = *(phis.begin());
+        RDNode *phi = _phis[phis.begin()->second];
         phis.erase(phis.begin());
 
         // get the definition from the PHI node
@@ -306,21 +412,24 @@ void SSAReachingDefinitionsAnalysis::performGvn() {
 
         auto block = phi->getBBlock();
 
-        for (auto I = block->pred_begin(), E = block->pred_end(); I != E; ++I) {
+        // creating phis may re-link the predecessors of the block
+        preds.clear();
+        for (auto I = block->pred_begin(), E = block->pred_end(); I != E; ++I)
+            preds.push_back(*I);
+        for (RDBBlock *pred : preds) {
             auto old_phis_size = _phis.size();
 
             // find definitions of this memory in the predecessor blocks
-            phi->defuse.add(findDefinitions(*I, ds));
+            phi->defuse.add(findDefinitions(pred, ds));
 
             // Queue the new phi (if any) for processing.
             if (_phis.size() != old_phis_size) {
                 assert(_phis.size() > old_phis_size);
-                for (auto i = old_phis_size; i < _phis.size(); ++i) {
-                    phis.insert(_phis[i]);
-                }
+                queuePhis(old_phis_size);
             }
         }
     }
+    _definitionsCache.clear();
     DBG_SECTION_END(dda, "GVN finished");
 }
 
@@ -355,12 +464,282 @@ std::vector<RDNode *> gatherNonPhisDefs(const ContT& nodes) {
     return std::vector<RDNode *>(ret.begin(), ret.end());
 }
 
+void SSAReachingDefinitionsAnalysis::computePhiDefinitions() {
+    DBG_SECTION_BEGIN(dda, "Computing definitions of phi nodes");
+
+    std::vector<RDNode *> phis;
+    for (RDBBlock *block : graph.blocks()) {
+        for (RDNode *n : block->getNodes()) {
+            if (n->getType() == RDNodeType::PHI)
+                phis.push_back(n);
+        }
+    }
+
+    const size_t idsNum = graph.getMaxNodeID() + 1;
+    _phiDefsIdx.assign(idsNum, 0);
+    _phiDefs.clear();
+
+    // Tarjan's algorithm on the def-use edges between phi nodes.
+    // The SCCs are finished in reverse topological order, so the definitions
+    // of the phis that the SCC uses are always computed before the SCC.
+    std::vector<unsigned> index(idsNum, 0); // 0 means not visited
+    std::vector<unsigned> lowlink(idsNum, 0);
+    std::vector<bool> onStack(idsNum, false);
+    std::vector<RDNode *> sccStack;
+    // (phi, the next def-use edge to follow)
+    std::vector<std::pair<RDNode *, decltype(phis[0]->defuse.begin())>> stack;
+    unsigned counter = 0;
+
+    auto visit = [&](RDNode *phi) {
+        assert(phi->getID() < idsNum && "Phi from a different graph");
+        index[phi->getID()] = lowlink[phi->getID()] = ++counter;
+        onStack[phi->getID()] = true;
+        sccStack.push_back(phi);
+        stack.emplace_back(phi, phi->defuse.begin());
+    };
+
+    for (RDNode *root : phis) {
+        if (index[root->getID()] != 0)
+            continue;
+
+        visit(root);
+        while (!stack.empty()) {
+            RDNode *phi = stack.back().first;
+            auto id = phi->getID();
+            if (stack.back().second != phi->defuse.end()) {
+                RDNode *n = *(stack.back().second++);
+                if (n->getType() != RDNodeType::PHI)
+                    continue;
+
+                if (index[n->getID()] == 0)
+                    visit(n);
+                else if (onStack[n->getID()])
+                    lowlink[id] = std::min(lowlink[id], index[n->getID()]);
+                continue;
+            }
+
+            stack.pop_back();
+            if (!stack.empty()) {
+                auto parent = stack.back().first->getID();
+                lowlink[parent] = std::min(lowlink[parent], lowlink[id]);
+            }
+
+            if (lowlink[id] != index[id])
+                continue;
+
+            // 'phi' is the root of an SCC, pop the SCC
+            std::vector<RDNode *> scc;
+            RDNode *member;
+            do {
+                member = sccStack.back();
+                sccStack.pop_back();
+                onStack[member->getID()] = false;
+                scc.push_back(member);
+            } while (member != phi);
+
+            _phiDefs.emplace_back();
+            const unsigned sccIdx = _phiDefs.size();
+            for (RDNode *m : scc)
+                _phiDefsIdx[m->getID()] = sccIdx;
+
+            std::vector<RDNode *> defs;
+            for (RDNode *m : scc) {
+                for (RDNode *n : m->defuse) {
+                    if (n->getType() != RDNodeType::PHI) {
+                        defs.push_back(n);
+                    } else if (_phiDefsIdx[n->getID()] != sccIdx) {
+                        const auto& ndefs = _phiDefs[_phiDefsIdx[n->getID()] - 1];
+                        defs.insert(defs.end(), ndefs.begin(), ndefs.end());
+                    }
+                }
+            }
+
+            std::sort(defs.begin(), defs.end());
+            defs.erase(std::unique(defs.begin(), defs.end()), defs.end());
+            _phiDefs[sccIdx - 1].swap(defs);
+        }
+    }
+
+    // the trivial phis are not needed anymore, use directly
+    // their only definition
+    size_t replaced = 0;
+    for (RDBBlock *block : graph.blocks()) {
+        for (RDNode *n : block->getNodes()) {
+            std::vector<std::pair<RDNode *, RDNode *>> trivial;
+            for (RDNode *d : n->defuse) {
+                if (d->getType() != RDNodeType::PHI)
+                    continue;
+                auto defs = getPhiDefinitions(d);
+                if (defs && defs->size() == 1)
+                    trivial.emplace_back(d, defs->front());
+            }
+
+            for (auto& it : trivial)
+                n->defuse.replace(it.first, it.second);
+            replaced += trivial.size();
+        }
+    }
+
+    DBG(dda, "Phi nodes: " << phis.size() << ", SCCs: " << _phiDefs.size()
+             << ", replaced trivial phis: " << replaced);
+    DBG_SECTION_END(dda, "Computing definitions of phi nodes finished");
+}
+
+const std::vector<RDNode *> *
+SSAReachingDefinitionsAnalysis::getPhiDefinitions(RDNode *phi) const {
+    assert(phi->getType() == RDNodeType::PHI);
+    if (phi->getID() >= _phiDefsIdx.size() || _phiDefsIdx[phi->getID()] == 0)
+        return nullptr;
+
+    return &_phiDefs[_phiDefsIdx[phi->getID()] - 1];
+}
+
+template <typename ContT>
+std::vector<RDNode *>
+SSAReachingDefinitionsAnalysis::getNonPhiDefinitions(const ContT& nodes) const {
+    std::vector<RDNode *> ret;
+    for (RDNode *n : nodes) {
+        if (n->getType() != RDNodeType::PHI) {
+            ret.push_back(n);
+            continue;
+        }
+
+        auto defs = getPhiDefinitions(n);
+        if (!defs) {
+            // the phi was not in any block when computing
+            // the definitions of phis, expand it the slow way
+            return gatherNonPhisDefs(nodes);
+        }
+        ret.insert(ret.end(), defs->begin(), defs->end());
+    }
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
 std::vector<RDNode *>
 SSAReachingDefinitionsAnalysis::getReachingDefinitions(RDNode *use) {
     if (use->usesUnknown())
         return findAllReachingDefinitions(use);
 
-    return gatherNonPhisDefs(use->defuse);
+    return getNonPhiDefinitions(use->defuse);
+}
+
+// are all the targets that 'n' defines defined also in 'defs'?
+static bool definesAllTargets(const DefinitionsMap<RDNode>& defs, RDNode *n) {
+    for (const auto& ds : n->defs) {
+        if (!defs.definesTarget(ds.target))
+            return false;
+    }
+    for (const auto& ds : n->overwrites) {
+        if (!defs.definesTarget(ds.target))
+            return false;
+    }
+    return true;
+}
+
+void SSAReachingDefinitionsAnalysis::computeBlockSummaries() {
+    _defBits.clear();
+    _bitDefs.clear();
+    _blockSummaries.clear();
+
+    bool hasUnknownUses = false;
+    for (RDBBlock *block : graph.blocks()) {
+        for (RDNode *n : block->getNodes()) {
+            if (n->usesUnknown()) {
+                hasUnknownUses = true;
+                break;
+            }
+        }
+        if (hasUnknownUses)
+            break;
+    }
+
+    // the summaries are used only for the uses of unknown memory
+    if (!hasUnknownUses)
+        return;
+
+    DBG_SECTION_BEGIN(dda, "Computing summaries of blocks");
+
+    // number the definitions and compute what definitions
+    // are generated and killed by the blocks
+    _defBits.assign(graph.getMaxNodeID() + 1, 0);
+    std::map<RDNode *, std::vector<unsigned>> targetDefs;
+    auto getBit = [&](RDNode *n) -> unsigned {
+        assert(n->getID() < _defBits.size() && "Node from a different graph");
+        auto& bit = _defBits[n->getID()];
+        if (bit == 0) {
+            _bitDefs.push_back(n);
+            bit = _bitDefs.size();
+            for (const auto& ds : n->defs)
+                targetDefs[ds.target].push_back(bit - 1);
+            for (const auto& ds : n->overwrites)
+                targetDefs[ds.target].push_back(bit - 1);
+        }
+        return bit - 1;
+    };
+
+    std::unordered_map<RDBBlock *, ADT::SparseBitvector> gen, kill, out;
+    std::vector<RDBBlock *> queue;
+    for (RDBBlock *block : graph.blocks()) {
+        auto& bgen = gen[block];
+        for (auto& it : block->definitions) {
+            for (auto& nds : it.second) {
+                for (RDNode *n : nds.second)
+                    bgen.set(getBit(n));
+            }
+        }
+        queue.push_back(block);
+    }
+
+    // all the definitions are numbered now
+    for (RDBBlock *block : graph.blocks()) {
+        auto& bkill = kill[block];
+        for (auto& it : block->definitions) {
+            for (unsigned bit : targetDefs[it.first]) {
+                if (definesAllTargets(block->definitions, _bitDefs[bit]))
+                    bkill.set(bit);
+            }
+        }
+    }
+
+    // in(B) = U out(P), out(B) = gen(B) U (in(B) \ kill(B))
+    std::set<RDBBlock *> queued(queue.begin(), queue.end());
+    while (!queue.empty()) {
+        RDBBlock *block = queue.back();
+        queue.pop_back();
+        queued.erase(block);
+
+        auto& in = _blockSummaries[block];
+        for (auto I = block->pred_begin(), E = block->pred_end(); I != E; ++I) {
+            // predecessors from the eliminated dead code
+            if (*I == nullptr)
+                continue;
+            in.set(out[*I]);
+        }
+
+        auto& bout = out[block];
+        bool changed = bout.set(gen[block]);
+        const auto& bkill = kill[block];
+        for (auto bit : in) {
+            // set() returns the previous value of the bit
+            if (!bkill.get(bit))
+                changed |= !bout.set(bit);
+        }
+
+        if (!changed)
+            continue;
+
+        for (auto I = block->succ_begin(), E = block->succ_end(); I != E; ++I) {
+            if (*I != nullptr && queued.insert(*I).second)
+                queue.push_back(*I);
+        }
+    }
+
+    DBG(dda, "Summaries of " << _blockSummaries.size() << " blocks over "
+             << _bitDefs.size() << " definitions");
+    DBG_SECTION_END(dda, "Computing summaries of blocks finished");
 }
 
 std::vector<RDNode *>
@@ -406,69 +785,18 @@ SSAReachingDefinitionsAnalysis::findAllReachingDefinitions(RDNode *from) {
     ///
     // get the definitions from predecessors
     ///
-    std::set<RDBBlock *> visitedBlocks; // for terminating the search
-    // NOTE: do not add block to visitedBlocks, it may be its own predecessor,
-    // in which case we want to process it
-    if (auto singlePred = block->getSinglePredecessor()) {
-        findAllReachingDefinitions(defs, singlePred, foundDefs, visitedBlocks);
-    } else {
-        // for multiple predecessors, we must create a copy of the
-        // definitions that we have not found yet
-        for (auto I = block->pred_begin(), E = block->pred_end(); I != E; ++I) {
-            auto tmpDefs = defs;
-            findAllReachingDefinitions(tmpDefs, *I, foundDefs, visitedBlocks);
-        }
+    assert(_blockSummaries.count(block) > 0 && "No summary of the block");
+    for (auto bit : _blockSummaries[block]) {
+        RDNode *n = _bitDefs[bit];
+        if (!definesAllTargets(defs, n))
+            foundDefs.insert(n);
     }
 
     ///
     // Gather all the defintions
     ///
     DBG_SECTION_END(dda, "MemorySSA - finding all definitions done");
-    return gatherNonPhisDefs(foundDefs);
-}
-
-void
-SSAReachingDefinitionsAnalysis::findAllReachingDefinitions(DefinitionsMap<RDNode>& defs,
-                                                           RDBBlock *from,
-                                                           std::set<RDNode *>& foundDefs,
-                                                           std::set<RDBBlock *>& visitedBlocks) {
-    if (!from)
-        return;
-
-    if (!visitedBlocks.insert(from).second)
-        return;
-
-    // get the definitions from this block
-    for (auto& it : from->definitions) {
-        if (!defs.definesTarget(it.first)) {
-            // just copy the definitions
-            defs.add(it.first, it.second);
-            for (auto& nds : it.second) {
-                foundDefs.insert(nds.second.begin(), nds.second.end());
-            }
-            continue;
-        }
-
-        for (auto& it2 : it.second) {
-            auto& interv = it2.first;
-            auto uncovered
-                = defs.undefinedIntervals({it.first, interv.start, interv.length()});
-            for (auto& undefInterv : uncovered) {
-                // we still do not have definitions for these bytes, add it
-                defs.add({it.first, undefInterv.start, undefInterv.length()}, it2.second);
-            }
-        }
-    }
-
-    // recurs into predecessors
-    if (auto singlePred = from->getSinglePredecessor()) {
-        findAllReachingDefinitions(defs, singlePred, foundDefs, visitedBlocks);
-    } else {
-        for (auto I = from->pred_begin(), E = from->pred_end(); I != E; ++I) {
-            auto tmpDefs = defs;
-            findAllReachingDefinitions(tmpDefs, *I, foundDefs, visitedBlocks);
-        }
-    }
+    return getNonPhiDefinitions(foundDefs);
 }
 
 
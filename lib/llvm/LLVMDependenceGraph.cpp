@@ -8,6 +8,7 @@
 
 #include <utility>
 #include <unordered_map>
+#include <vector>
 #include <set>
 
 // ignore unused parameters in LLVM libraries
@@ -43,6 +44,7 @@
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/llvm/LLVMNode.h"
 #include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
+#include "dg/llvm/analysis/ExecutionCoverage.h"
 #include "../lib/llvm/analysis/ControlDependence/NonTerminationSensitiveControlDependencyAnalysis.h"
 
 #include "llvm/LLVMDGVerifier.h"
@@ -74,13 +76,48 @@ const std::map<llvm::Value *,
     return constructedFunctions;
 }
 
+LLVMNode *LLVMDependenceGraph::findInstruction(const llvm::Instruction *instruction) const
+{
+    if (!instructionNodes)
+        return nullptr;
+
+    auto it = instructionNodes->find(instruction);
+    if (it == instructionNodes->end())
+        return nullptr;
+
+    return it->second;
+}
+
+void LLVMDependenceGraph::setInstructionNode(const llvm::Instruction *I, LLVMNode *node)
+{
+    // graphs built directly from a function have no table yet
+    if (!instructionNodes)
+        instructionNodes = std::make_shared<InstructionNodesT>();
+
+    (*instructionNodes)[I] = node;
+}
+
 LLVMDependenceGraph::~LLVMDependenceGraph()
 {
+    // do not leave the dangling graph in the constructed functions
+    if (LLVMNode *entry = getEntry()) {
+        auto it = constructedFunctions.find(entry->getKey());
+        if (it != constructedFunctions.end() && it->second == this)
+            constructedFunctions.erase(it);
+    }
+
     // delete nodes
     for (auto I = begin(), E = end(); I != E; ++I) {
         LLVMNode *node = I->second;
 
         if (node) {
+            // do not leave dangling nodes in the table of instructions.
+            // The value may have been already erased (e.g., by the slicer),
+            // so we must not look at it, just use it as a key
+            auto inst = static_cast<const llvm::Instruction *>(node->getValue());
+            if (findInstruction(inst) == node)
+                instructionNodes->erase(inst);
+
             for (LLVMDependenceGraph *subgraph : node->getSubgraphs()) {
                 // graphs are referenced, once the refcount is 0
                 // the graph will be deleted
@@ -165,6 +202,9 @@ bool LLVMDependenceGraph::build(llvm::Module *m, llvm::Function *entry)
 
     module = m;
 
+    // the table of nodes of instructions, shared with subgraphs
+    instructionNodes = std::make_shared<InstructionNodesT>();
+
     // add global nodes. These will be shared across subgraphs
     addGlobals(m, this);
 
@@ -277,8 +317,10 @@ LLVMDependenceGraph::buildSubgraph(LLVMNode *node, llvm::Function *callFunc, boo
         // set global nodes to this one, so that
         // we'll share them
         subgraph->setGlobalNodes(getGlobalNodes());
+        subgraph->instructionNodes = instructionNodes;
         subgraph->module = module;
         subgraph->PTA = PTA;
+        subgraph->coverage = coverage;
         subgraph->threads = this->threads;
         // make subgraphs gather the call-sites too
         subgraph->gatherCallsites(gather_callsites, gatheredCallsites);
@@ -550,6 +592,7 @@ LLVMBBlock *LLVMDependenceGraph::build(llvm::BasicBlock& llvmBB)
 
         // add new node to this dependence graph
         addNode(node);
+        setInstructionNode(&Inst, node);
 
         // add the node to our basic block
         BB->append(node);
@@ -642,7 +685,14 @@ addControlDepsToPHI(LLVMDependenceGraph *graph,
         if (B == this_block)
             continue;
 
-        LLVMBBlock *our = CB[B];
+        // the value comes from the code that was not executed
+        auto it = CB.find(B);
+        if (it == CB.end()) {
+            assert(!graph->isCovered(B) && "Don't have block constructed for PHI node");
+            continue;
+        }
+
+        LLVMBBlock *our = it->second;
         assert(our && "Don't have block constructed for PHI node");
         our->getLastNode()->addControlDependence(node);
     }
@@ -705,6 +755,11 @@ bool LLVMDependenceGraph::build(llvm::Function *func)
     // iterate over basic blocks
     BBlocksMapT& blocks = getBlocks();
     for (llvm::BasicBlock& llvmBB : *func) {
+        // we build only the code that was executed
+        // (the entry block is covered always)
+        if (!isCovered(&llvmBB))
+            continue;
+
         LLVMBBlock *BB = build(llvmBB);
         blocks[&llvmBB] = BB;
 
@@ -713,7 +768,7 @@ bool LLVMDependenceGraph::build(llvm::Function *func)
             setEntryBB(BB);
     }
 
-    assert(blocks.size() == func->size()
+    assert((coverage || blocks.size() == func->size())
             && "Did not created all blocks");
 
     // add CFG edges
@@ -725,6 +780,14 @@ bool LLVMDependenceGraph::build(llvm::Function *func)
         int idx = 0;
         for (succ_iterator S = succ_begin(llvmBB), SE = succ_end(llvmBB);
              S != SE; ++S) {
+            // cut off the edges to the code that was not executed,
+            // the label of the edge stays missing (as when the successor
+            // is sliced away, see LLVMSlicer::adjustBBlocksSucessors)
+            if (!isCovered(*S)) {
+                ++idx;
+                continue;
+            }
+
             LLVMBBlock *succ = blocks[*S];
             assert(succ && "Missing basic block");
 
@@ -762,6 +825,11 @@ bool LLVMDependenceGraph::build(llvm::Function *func)
     return true;
 }
 
+bool LLVMDependenceGraph::isCovered(const llvm::BasicBlock *B) const
+{
+    return !coverage || coverage->isCovered(B);
+}
+
 bool LLVMDependenceGraph::build(llvm::Module *m,
                                 LLVMPointerAnalysis *pts,
                                 LLVMReachingDefinitions *rda,
@@ -962,7 +1030,11 @@ void LLVMDependenceGraph::computeControlExpression(bool addCDs)
             auto& our_blocks = F.second->getBlocks();
 
             for (llvm::BasicBlock& B : *func) {
-                LLVMBBlock *B1 = our_blocks[&B];
+                auto it = our_blocks.find(&B);
+                if (it == our_blocks.end())
+                    continue;
+
+                LLVMBBlock *B1 = it->second;
 
                 // if this block is a predicate block,
                 // we compute the control deps for it
@@ -975,8 +1047,9 @@ void LLVMDependenceGraph::computeControlExpression(bool addCDs)
                     for (auto cs : CS) {
                         assert(cs->isa(CENodeType::LABEL));
                         auto lab = static_cast<CELabel<llvm::BasicBlock *> *>(cs);
-                        LLVMBBlock *B2 = our_blocks[lab->getLabel()];
-                        B1->addControlDependence(B2);
+                        auto it2 = our_blocks.find(lab->getLabel());
+                        if (it2 != our_blocks.end())
+                            B1->addControlDependence(it2->second);
                     }
                 }
             }
@@ -991,11 +1064,10 @@ void LLVMDependenceGraph::computeNonTerminationControlDependencies() {
 
     for (const auto & node : dependencies) {
         if (!node.first->isArtificial()) {
-            auto lastInstruction = findInstruction(castToLLVMInstruction(node.first->lastInstruction()),
-                                                   getConstructedFunctions());
+            auto lastInstruction = findInstruction(castToLLVMInstruction(node.first->lastInstruction()));
             for (const auto dependant : node.second) {
                 for (const auto instruction : dependant->llvmInstructions()) {
-                    auto dgInstruction = findInstruction(castToLLVMInstruction(instruction), getConstructedFunctions());
+                    auto dgInstruction = findInstruction(castToLLVMInstruction(instruction));
                     if (lastInstruction && dgInstruction) {
                         lastInstruction->addControlDependence(dgInstruction);
                     } else {
@@ -1045,9 +1117,9 @@ void LLVMDependenceGraph::computeInterferenceDependentEdges(ControlFlowGraph * c
 void LLVMDependenceGraph::computeForkJoinDependencies(ControlFlowGraph *controlFlowGraph) {
     auto joins = controlFlowGraph->getJoins();
     for (const auto &join : joins) {
-        auto joinNode = findInstruction(castToLLVMInstruction(join), constructedFunctions);
+        auto joinNode = findInstruction(castToLLVMInstruction(join));
         for (const auto &fork : controlFlowGraph->getCorrespondingForks(join)) {
-            auto forkNode = findInstruction(castToLLVMInstruction(fork), constructedFunctions);
+            auto forkNode = findInstruction(castToLLVMInstruction(fork));
             joinNode->addControlDependence(forkNode);
         }
     }
@@ -1057,16 +1129,16 @@ void LLVMDependenceGraph::computeCriticalSections(ControlFlowGraph *controlFlowG
     auto locks = controlFlowGraph->getLocks();
     for (auto lock : locks) {
         auto callLockInst = castToLLVMInstruction(lock);
-        auto lockNode = findInstruction(callLockInst, constructedFunctions);
-        auto correspondingNodes = controlFlowGraph->getCorrespondingCriticalSection(lock);
+        auto lockNode = findInstruction(callLockInst);
+        const auto & correspondingNodes = controlFlowGraph->getCorrespondingCriticalSection(lock);
         for (auto correspondingNode : correspondingNodes) {
             auto node = castToLLVMInstruction(correspondingNode);
-            auto dependentNode = findInstruction(node, constructedFunctions);
+            auto dependentNode = findInstruction(node);
             if (dependentNode) {
                 lockNode->addControlDependence(dependentNode);
             } else {
                 llvm::errs() << "Instruction "
-                             << *dependentNode->getValue()
+                             << *node
                              << " was not found, cannot setup"
                              << " control depency on lock\n";
             }
@@ -1075,7 +1147,7 @@ void LLVMDependenceGraph::computeCriticalSections(ControlFlowGraph *controlFlowG
         auto correspondingUnlocks = controlFlowGraph->getCorrespongingUnlocks(lock);
         for (auto unlock : correspondingUnlocks) {
             auto node = castToLLVMInstruction(unlock);
-            auto unlockNode = findInstruction(node, constructedFunctions);
+            auto unlockNode = findInstruction(node);
             if (unlockNode) {
                 unlockNode->addControlDependence(lockNode);
             }
@@ -1085,31 +1157,20 @@ void LLVMDependenceGraph::computeCriticalSections(ControlFlowGraph *controlFlowG
 
 void LLVMDependenceGraph::computeInterferenceDependentEdges(const std::set<const llvm::Instruction *> &loads,
                                                             const std::set<const llvm::Instruction *> &stores) {
+    const llvm::DataLayout& DL = module->getDataLayout();
     for (const auto &load :loads) {
+        auto loadSize = DL.getTypeStoreSize(load->getType());
         for (const auto &store : stores) {
-            auto loadOperand = PTA->getPointsTo(load->getOperand(0));
-            auto storeOperand = PTA->getPointsTo(store->getOperand(1));
-            if (loadOperand && storeOperand) { // if storeOperand does not have pointsTo, expect it can write anywhere??
-                for (const auto pointerLoad : loadOperand->pointsTo) {
-                    for (const auto pointerStore : storeOperand->pointsTo) {
-                        if (pointerLoad.target == pointerStore.target &&
-                            (pointerLoad.offset.isUnknown()  ||
-                             pointerStore.offset.isUnknown() ||
-                             pointerLoad.offset == pointerStore.offset)) {
-                            llvm::Instruction *loadInst = const_cast<llvm::Instruction *>(load);
-                            llvm::Instruction *storeInst = const_cast<llvm::Instruction *>(store);
-                            auto loadFunction = constructedFunctions.find(const_cast<llvm::Function *>(load->getParent()->getParent()));
-                            auto storeFunction = constructedFunctions.find(const_cast<llvm::Function *>(store->getParent()->getParent()));
-                            if (loadFunction != constructedFunctions.end() && storeFunction != constructedFunctions.end()) {
-                                auto loadNode = loadFunction->second->findNode(loadInst);
-                                auto storeNode = storeFunction->second->findNode(storeInst);
-                                if (loadNode && storeNode) {
-                                    storeNode->addInterferenceDependence(loadNode);
-                                }
-                            }
-                        }
-                    }
-                }
+            auto storeSize = DL.getTypeStoreSize(store->getOperand(0)->getType());
+            auto aliasResult = PTA->alias(load->getOperand(0), loadSize,
+                                          store->getOperand(1), storeSize);
+            if (aliasResult == LLVMPointerAnalysis::AliasResult::NoAlias)
+                continue;
+
+            auto loadNode = findInstruction(load);
+            auto storeNode = findInstruction(store);
+            if (loadNode && storeNode) {
+                storeNode->addInterferenceDependence(loadNode);
             }
         }
     }
@@ -1163,6 +1224,30 @@ void LLVMDependenceGraph::makeSelfLoopsControlDependent()
     }
 }
 
+// return the noreturn node of a call that may not return
+static LLVMNode *getNoReturnOfCall(LLVMNode *node) {
+    if (auto params = node->getParameters())
+        return params->getNoReturn();
+    return nullptr;
+}
+
+// Make the nodes of the block up to the first call that may not return
+// (including the call) control dependent on 'noret'.
+// Return true if there is no such call in the block.
+static bool addNoreturnDependenciesToCall(LLVMNode *noret, LLVMBBlock *B) {
+    for (auto node : B->getNodes()) {
+        noret->addControlDependence(node);
+        if (getNoReturnOfCall(node))
+            return false;
+    }
+
+    return true;
+}
+
+// The dependencies are transitively reduced: the nodes after the next
+// call that may not return depend on the noreturn node of that call,
+// that depends on the call, which depends on 'noret'.
+// So it is enough to search only until the next such call on every path.
 void LLVMDependenceGraph::addNoreturnDependencies(LLVMNode *noret, LLVMBBlock *from) {
     std::set<LLVMBBlock *> visited;
     ADT::QueueLIFO<LLVMBBlock *> queue;
@@ -1171,13 +1256,13 @@ void LLVMDependenceGraph::addNoreturnDependencies(LLVMNode *noret, LLVMBBlock *f
         if (visited.insert(succ.target).second)
             queue.push(succ.target);
     }
-            
+
     while (!queue.empty()) {
         auto cur = queue.pop();
 
-        // do the stuff
-        for (auto node : cur->getNodes())
-            noret->addControlDependence(node);
+        // do the stuff, stop on the next call that may not return
+        if (!addNoreturnDependenciesToCall(noret, cur))
+            continue;
 
         // queue successors
         for (auto& succ : cur->successors()) {
@@ -1194,23 +1279,22 @@ void LLVMDependenceGraph::addNoreturnDependencies()
 
         for (auto& it : blocks) {
             LLVMBBlock *B = it.second;
-            std::set<LLVMNode *> noreturns;
+            // the noreturn node of the last call in the block
+            // that may not return
+            LLVMNode *noret = nullptr;
             for (auto node : B->getNodes()) {
-                // add dependencies for the found no returns
-                for (auto nrt : noreturns) {
-                    nrt->addControlDependence(node);
-                }
-
-                if (auto params = node->getParameters()) {
-                    if (auto noret = params->getNoReturn()) {
-                        // process the rest of the block
-                        noreturns.insert(noret);
+                // the rest of the block up to the next call
+                // that may not return depends on the last call
+                if (noret)
+                    noret->addControlDependence(node);
 
-                        // process reachable nodes
-                        addNoreturnDependencies(noret, B);
-                    }
-                }
+                if (auto nrt = getNoReturnOfCall(node))
+                    noret = nrt;
             }
+
+            // process reachable nodes
+            if (noret)
+                addNoreturnDependencies(noret, B);
         }
     }
 }
@@ -1220,14 +1304,6 @@ void LLVMDependenceGraph::addDefUseEdges() {
     DUA.run();
 }
 
-LLVMNode *findInstruction(llvm::Instruction * instruction, const std::map<llvm::Value *, LLVMDependenceGraph *> & constructedFunctions) {
-    auto valueKey = constructedFunctions.find(instruction->getParent()->getParent());
-    if (valueKey != constructedFunctions.end()) {
-        return valueKey->second->findNode(instruction);
-    }
-    return nullptr;
-}
-
 llvm::Instruction * castToLLVMInstruction(const llvm::Value * value) {
     return const_cast<llvm::Instruction *>(static_cast<const llvm::Instruction *> (value));
 }
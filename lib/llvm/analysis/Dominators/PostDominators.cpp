@@ -1,3 +1,7 @@
+#include <map>
+#include <set>
+#include <vector>
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -20,73 +24,216 @@
 #include "dg/analysis/PostDominanceFrontiers.h"
 
 #include "dg/llvm/LLVMDependenceGraph.h"
+#include "PostDominators.h"
 
 namespace dg {
 
-void LLVMDependenceGraph::computePostDominators(bool addPostDomFrontiers)
+static LLVMBBlock *getOrCreatePostDomTreeRoot(LLVMDependenceGraph *dg,
+                                              LLVMBBlock *&root)
+{
+    // PostDominatorTree may has special root without BB set
+    // or it is the node without immediate post-dominator
+    if (!root) {
+        root = new LLVMBBlock();
+        root->setKey(nullptr);
+        dg->setPostDominatorTreeRoot(root);
+    }
+
+    return root;
+}
+
+// set the immediate post-dominators from the post-dominator tree of LLVM,
+// return false if no block is in the tree (e.g. an infinite loop)
+bool setIPostDomsFromLLVM(LLVMDependenceGraph *dg, llvm::Function& f,
+                          LLVMBBlock *&root)
 {
     using namespace llvm;
-    // iterate over all functions
-    for (auto& F : getConstructedFunctions()) {
-        analysis::PostDominanceFrontiers<LLVMNode> pdfrontiers;
 
-        // root of post-dominator tree
-        LLVMBBlock *root = nullptr;
-        Value *val = const_cast<Value *>(F.first);
-        Function& f = *cast<Function>(val);
-        PostDominatorTree *pdtree;
+    PostDominatorTree *pdtree;
 
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-        pdtree = new PostDominatorTree();
-        // compute post-dominator tree for this function
-        pdtree->runOnFunction(f);
+    pdtree = new PostDominatorTree();
+    // compute post-dominator tree for this function
+    pdtree->runOnFunction(f);
 #else
-        PostDominatorTreeWrapperPass wrapper;
-        wrapper.runOnFunction(f);
-        pdtree = &wrapper.getPostDomTree();
+    PostDominatorTreeWrapperPass wrapper;
+    wrapper.runOnFunction(f);
+    pdtree = &wrapper.getPostDomTree();
 #ifndef NDEBUG
-        wrapper.verifyAnalysis();
+    wrapper.verifyAnalysis();
 #endif
 #endif
 
-        // add immediate post-dominator edges
-        auto& our_blocks = F.second->getBlocks();
-        bool built = false;
-        for (auto& it : our_blocks) {
-            LLVMBBlock *BB = it.second;
-            BasicBlock *B = cast<BasicBlock>(const_cast<Value *>(it.first));
-            DomTreeNode *N = pdtree->getNode(B);
-            // when function contains infinite loop, we're screwed
-            // and we don't have anything
-            // FIXME: just check for the root,
-            // don't iterate over all blocks, stupid...
-            if (!N)
-                continue;
-
-            DomTreeNode *idom = N->getIDom();
-            BasicBlock *idomBB = idom ? idom->getBlock() : nullptr;
-            built = true;
-
-            if (idomBB) {
-                LLVMBBlock *pb = our_blocks[idomBB];
-                assert(pb && "Do not have constructed BB");
-                BB->setIPostDom(pb);
-                assert(cast<BasicBlock>(BB->getKey())->getParent()
-                        == cast<BasicBlock>(pb->getKey())->getParent()
-                        && "BBs are from diferent functions");
-            // if we do not have idomBB, then the idomBB is a root BB
-            } else {
-                // PostDominatorTree may has special root without BB set
-                // or it is the node without immediate post-dominator
-                if (!root) {
-                    root = new LLVMBBlock();
-                    root->setKey(nullptr);
-                    F.second->setPostDominatorTreeRoot(root);
+    // add immediate post-dominator edges
+    auto& our_blocks = dg->getBlocks();
+    bool built = false;
+    for (auto& it : our_blocks) {
+        LLVMBBlock *BB = it.second;
+        BasicBlock *B = cast<BasicBlock>(const_cast<Value *>(it.first));
+        DomTreeNode *N = pdtree->getNode(B);
+        // when function contains infinite loop, we're screwed
+        // and we don't have anything
+        // FIXME: just check for the root,
+        // don't iterate over all blocks, stupid...
+        if (!N)
+            continue;
+
+        DomTreeNode *idom = N->getIDom();
+        BasicBlock *idomBB = idom ? idom->getBlock() : nullptr;
+        built = true;
+
+        if (idomBB) {
+            LLVMBBlock *pb = our_blocks[idomBB];
+            assert(pb && "Do not have constructed BB");
+            BB->setIPostDom(pb);
+            assert(cast<BasicBlock>(BB->getKey())->getParent()
+                    == cast<BasicBlock>(pb->getKey())->getParent()
+                    && "BBs are from diferent functions");
+        // if we do not have idomBB, then the idomBB is a root BB
+        } else {
+            BB->setIPostDom(getOrCreatePostDomTreeRoot(dg, root));
+        }
+    }
+
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
+    delete pdtree;
+#endif
+
+    return built;
+}
+
+// Set the immediate post-dominators computed on the CFG of our blocks.
+// We use this when the graph does not contain all the blocks
+// of the function (the code that was not executed is cut off,
+// see LLVMDependenceGraph::setCoverage), so the post-dominators
+// of LLVM do not match. Return false if no block can reach the exit.
+//
+// The algorithm is due:
+//
+// K. D. Cooper, T. J. Harvey, and K. Kennedy. 2001.
+// A Simple, Fast Dominance Algorithm.
+bool setIPostDomsOnBlocks(LLVMDependenceGraph *dg, LLVMBBlock *&root)
+{
+    auto& our_blocks = dg->getBlocks();
+
+    std::set<LLVMBBlock *> blocks;
+    for (auto& it : our_blocks)
+        blocks.insert(it.second);
+
+    // the successors of the block in the reversed CFG (the successors
+    // that are not our blocks are the unified exit block)
+    auto exits = [&blocks](LLVMBBlock *BB) {
+        for (const auto& succ : BB->successors()) {
+            if (blocks.count(succ.target) > 0)
+                return false;
+        }
+        return true;
+    };
+
+    // number the blocks in the post-order of the reversed CFG
+    // that starts in the (virtual) root
+    std::map<LLVMBBlock *, unsigned> order;
+    std::vector<LLVMBBlock *> postorder;
+    std::vector<std::pair<LLVMBBlock *, bool>> stack;
+    std::set<LLVMBBlock *> visited;
+    for (LLVMBBlock *BB : blocks) {
+        if (exits(BB))
+            stack.emplace_back(BB, false);
+    }
+
+    while (!stack.empty()) {
+        auto cur = stack.back();
+        stack.pop_back();
+
+        if (cur.second) {
+            order[cur.first] = postorder.size();
+            postorder.push_back(cur.first);
+            continue;
+        }
+
+        if (!visited.insert(cur.first).second)
+            continue;
+
+        stack.emplace_back(cur.first, true);
+        for (LLVMBBlock *pred : cur.first->predecessors()) {
+            if (blocks.count(pred) > 0 && visited.count(pred) == 0)
+                stack.emplace_back(pred, false);
+        }
+    }
+
+    if (postorder.empty())
+        return false;
+
+    // the virtual root is nullptr and is after all blocks in the post-order
+    const unsigned rootOrder = postorder.size();
+    auto getOrder = [&order, rootOrder](LLVMBBlock *BB) {
+        return BB ? order[BB] : rootOrder;
+    };
+
+    std::map<LLVMBBlock *, LLVMBBlock *> ipdom;
+    auto intersect = [&ipdom, &getOrder](LLVMBBlock *a, LLVMBBlock *b) {
+        while (a != b) {
+            while (getOrder(a) < getOrder(b))
+                a = ipdom[a];
+            while (getOrder(b) < getOrder(a))
+                b = ipdom[b];
+        }
+        return a;
+    };
+
+    bool changed;
+    do {
+        changed = false;
+        for (auto I = postorder.rbegin(), E = postorder.rend(); I != E; ++I) {
+            LLVMBBlock *BB = *I;
+
+            // the exits are post-dominated by the root
+            LLVMBBlock *newIPDom = nullptr;
+            bool found = exits(BB);
+            if (!found) {
+                for (const auto& succ : BB->successors()) {
+                    if (ipdom.count(succ.target) == 0)
+                        continue;
+
+                    newIPDom = found ? intersect(succ.target, newIPDom)
+                                     : succ.target;
+                    found = true;
                 }
+            }
 
-                BB->setIPostDom(root);
+            assert(found && "Did not find any processed successor");
+            auto it = ipdom.find(BB);
+            if (it == ipdom.end() || it->second != newIPDom) {
+                ipdom[BB] = newIPDom;
+                changed = true;
             }
         }
+    } while (changed);
+
+    for (auto& it : ipdom) {
+        it.first->setIPostDom(it.second ? it.second
+                                        : getOrCreatePostDomTreeRoot(dg, root));
+    }
+
+    return true;
+}
+
+void LLVMDependenceGraph::computePostDominators(bool addPostDomFrontiers)
+{
+    using namespace llvm;
+    // iterate over all functions
+    for (auto& F : getConstructedFunctions()) {
+        analysis::PostDominanceFrontiers<LLVMNode> pdfrontiers;
+
+        // root of post-dominator tree
+        LLVMBBlock *root = nullptr;
+        Value *val = const_cast<Value *>(F.first);
+        Function& f = *cast<Function>(val);
+
+        auto& our_blocks = F.second->getBlocks();
+        bool built = our_blocks.size() == f.size()
+                        ? setIPostDomsFromLLVM(F.second, f, root)
+                        : setIPostDomsOnBlocks(F.second, root);
 
         // well, if we haven't built the pdtree, this is probably infinite loop
         // that has no pdtree. Until we have anything better, just add sound control
@@ -108,9 +255,6 @@ void LLVMDependenceGraph::computePostDominators(bool addPostDomFrontiers)
                 pdfrontiers.compute(root, true /* store also control depend. */);
         }
 
-#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-        delete pdtree;
-#endif
     }
 }
 
@@ -0,0 +1,26 @@
+#ifndef _LLVM_DG_POST_DOMINATORS_H_
+#define _LLVM_DG_POST_DOMINATORS_H_
+
+#include "dg/llvm/LLVMDependenceGraph.h"
+
+namespace llvm {
+    class Function;
+}
+
+namespace dg {
+
+// Set the immediate post-dominators of the blocks of the graph
+// of a function. The blocks that have no post-dominator
+// get the root of the post-dominator tree (created on demand and stored
+// into 'root'). Return false if no block can reach the exit.
+
+// use the post-dominator tree of LLVM (the graph must have all the blocks)
+bool setIPostDomsFromLLVM(LLVMDependenceGraph *dg, llvm::Function& f,
+                          LLVMBBlock *&root);
+
+// compute the post-dominators on the CFG of the blocks of the graph
+bool setIPostDomsOnBlocks(LLVMDependenceGraph *dg, LLVMBBlock *&root);
+
+} // namespace dg
+
+#endif // _LLVM_DG_POST_DOMINATORS_H_
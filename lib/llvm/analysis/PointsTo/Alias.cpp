@@ -0,0 +1,145 @@
+#include <cassert>
+#include <vector>
+#include <algorithm>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Value.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
+
+namespace dg {
+
+using analysis::pta::PSNodeAlloc;
+
+using AliasResult = LLVMPointerAnalysis::AliasResult;
+
+// Gather the pointers from the points-to set that point to some memory
+// (that is, not null or invalidated memory) sorted by the ID of the target.
+// Return false if the set contains a pointer to unknown memory.
+static bool getSortedTargets(const PSNode *n, std::vector<Pointer>& ptrs)
+{
+    for (const Pointer& ptr : n->pointsTo) {
+        if (ptr.isUnknown())
+            return false;
+        if (ptr.isNull() || ptr.isInvalidated())
+            continue;
+        ptrs.push_back(ptr);
+    }
+
+    std::sort(ptrs.begin(), ptrs.end(),
+              [](const Pointer& a, const Pointer& b) {
+                  return a.target->getID() < b.target->getID();
+              });
+    return true;
+}
+
+// can the memory [off1, off1 + size1) overlap with [off2, off2 + size2)?
+static bool mayOverlap(Offset off1, uint64_t size1,
+                       Offset off2, uint64_t size2)
+{
+    if (off1.isUnknown() || off2.isUnknown())
+        return true;
+
+    if (off1 <= off2)
+        return size1 == Offset::UNKNOWN || *off2 - *off1 < size1;
+    return size2 == Offset::UNKNOWN || *off1 - *off2 < size2;
+}
+
+static AliasResult alias(const PSNode *n1, uint64_t size1,
+                         const PSNode *n2, uint64_t size2)
+{
+    std::vector<Pointer> ptrs1, ptrs2;
+    if (!getSortedTargets(n1, ptrs1) || !getSortedTargets(n2, ptrs2)) {
+        // unknown memory aliases with anything, but not with nothing
+        if (n1->pointsTo.empty() || n2->pointsTo.empty())
+            return AliasResult::NoAlias;
+        return AliasResult::MayAlias;
+    }
+
+    // both pointers point to the same byte of the same object.
+    // Global objects have only one instance (unless they are merged
+    // allocation sites), so this is a must alias
+    if (ptrs1.size() == 1 && ptrs2.size() == 1 &&
+        n1->pointsTo.size() == 1 && n2->pointsTo.size() == 1) {
+        const Pointer& ptr1 = ptrs1[0];
+        const Pointer& ptr2 = ptrs2[0];
+        auto alloc = PSNodeAlloc::get(ptr1.target);
+        if (ptr1.target == ptr2.target && alloc && alloc->isGlobal() &&
+            !alloc->isSummary() &&
+            !ptr1.offset.isUnknown() && ptr1.offset == ptr2.offset)
+            return AliasResult::MustAlias;
+    }
+
+    // intersect the sorted sequences of targets
+    auto I1 = ptrs1.begin(), E1 = ptrs1.end();
+    auto I2 = ptrs2.begin(), E2 = ptrs2.end();
+    while (I1 != E1 && I2 != E2) {
+        unsigned id1 = I1->target->getID();
+        unsigned id2 = I2->target->getID();
+        if (id1 < id2) {
+            ++I1;
+        } else if (id2 < id1) {
+            ++I2;
+        } else {
+            // compare all the offsets into this target
+            auto G1 = I1, G2 = I2;
+            while (G1 != E1 && G1->target->getID() == id1)
+                ++G1;
+            while (G2 != E2 && G2->target->getID() == id2)
+                ++G2;
+
+            for (auto it1 = I1; it1 != G1; ++it1) {
+                for (auto it2 = I2; it2 != G2; ++it2) {
+                    if (mayOverlap(it1->offset, size1, it2->offset, size2))
+                        return AliasResult::MayAlias;
+                }
+            }
+
+            I1 = G1;
+            I2 = G2;
+        }
+    }
+
+    return AliasResult::NoAlias;
+}
+
+AliasResult LLVMPointerAnalysis::alias(const llvm::Value *V1, uint64_t size1,
+                                       const llvm::Value *V2, uint64_t size2)
+{
+    PSNode *n1 = getPointsTo(V1);
+    PSNode *n2 = getPointsTo(V2);
+    // we know nothing about these values
+    if (!n1 || !n2)
+        return AliasResult::MayAlias;
+
+    // the query is symmetric, so normalize it
+    if (n2 < n1) {
+        std::swap(n1, n2);
+        std::swap(size1, size2);
+    }
+
+    auto key = AliasQueryT(n1, size1, n2, size2);
+    auto it = _aliasCache.find(key);
+    if (it != _aliasCache.end())
+        return it->second;
+
+    auto result = dg::alias(n1, size1, n2, size2);
+    _aliasCache.emplace(key, result);
+    return result;
+}
+
+} // namespace dg
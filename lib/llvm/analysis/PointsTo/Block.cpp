@@ -34,10 +34,18 @@ namespace pta {
 void LLVMPointerGraphBuilder::addPHIOperands(const llvm::Function &F)
 {
     for (const llvm::BasicBlock& B : F) {
+        if (!isCovered(&B))
+            continue;
+
         for (const llvm::Instruction& I : B) {
             if (const llvm::PHINode *PHI = llvm::dyn_cast<llvm::PHINode>(&I)) {
                 if (PSNode *node = getNodes(PHI)->getSingleNode())
                     addPHIOperands(node, PHI);
+            } else if (const llvm::LoadInst *LI = llvm::dyn_cast<llvm::LoadInst>(&I)) {
+                if (!isPromotedAccess(LI))
+                    continue;
+                if (auto nodes = getNodes(LI))
+                    addPromotedLoadOperands(nodes->getSingleNode(), LI);
             }
         }
     }
@@ -51,6 +59,11 @@ LLVMPointerGraphBuilder::buildPointerGraphBlock(const llvm::BasicBlock& block,
     PSNodesBlock blk;
 
     for (const llvm::Instruction& Inst : block) {
+        // stores to promoted local variables are
+        // mapped directly to the loads
+        if (llvm::isa<llvm::StoreInst>(&Inst) && isPromotedAccess(&Inst))
+            continue;
+
         if (!isRelevantInstruction(Inst)) {
             // check if it is a zeroing of memory,
             // if so, set the corresponding memory to zeroed
@@ -0,0 +1,141 @@
+#include <map>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/analysis/PointsTo/PointerGraph.h"
+#include "dg/analysis/PointsTo/PointerGraphOptimizations.h"
+
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+// the type of the memory allocated by the value
+static const llvm::Type *getAllocatedType(const llvm::Value *val)
+{
+    using namespace llvm;
+
+    if (auto AI = dyn_cast<AllocaInst>(val))
+        return AI->getAllocatedType();
+    if (auto GV = dyn_cast<GlobalVariable>(val))
+        return GV->getValueType();
+
+    // the memory from malloc and friends is usually
+    // casted to the right type right after the call
+    for (auto I = val->use_begin(), E = val->use_end(); I != E; ++I) {
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 5))
+        const llvm::Value *use = *I;
+#else
+        const llvm::Value *use = I->getUser();
+#endif
+        if (auto BC = dyn_cast<BitCastInst>(use))
+            return BC->getDestTy()->getContainedType(0);
+    }
+
+    return val->getType()->getContainedType(0);
+}
+
+unsigned LLVMPointerGraphBuilder::coarsenAllocations()
+{
+    using AllocCoarsening = LLVMPointerAnalysisOptions::AllocCoarsening;
+    if (_options.allocCoarsening == AllocCoarsening::none)
+        return 0;
+
+    // the sites are merged only with the sites of the same kind
+    // (stack, heap or global), so that the summaries keep
+    // the properties of the sites
+    enum { STACK, HEAP, GLOBAL };
+    using KeyT = std::tuple<int, const llvm::Type *, const llvm::Function *>;
+    std::map<KeyT, size_t> groupsIdx;
+    std::vector<std::vector<PSNodeAlloc *>> groups;
+
+    auto addSite = [&](const llvm::Value *val, const llvm::Function *F) {
+        // there is nothing to gain from merging the immutable globals
+        if (immutableGlobals.isImmutable(val))
+            return;
+
+        auto nds = getNodes(val);
+        if (!nds)
+            return;
+
+        // e.g. realloc is a sequence of nodes that is not an allocation
+        PSNodeAlloc *alloc = PSNodeAlloc::get(nds->getRepresentant());
+        if (!alloc || alloc->isTemporary())
+            return;
+        // only the calls of allocation functions (not e.g. va_start)
+        if (llvm::isa<llvm::CallInst>(val) && !alloc->isHeap())
+            return;
+
+        int kind = alloc->isGlobal() ? GLOBAL : (alloc->isHeap() ? HEAP : STACK);
+        if (_options.allocCoarsening == AllocCoarsening::type)
+            F = nullptr;
+
+        auto key = KeyT(kind, getAllocatedType(val), F);
+        auto it = groupsIdx.emplace(key, groups.size());
+        if (it.second)
+            groups.emplace_back();
+        groups[it.first->second].push_back(alloc);
+    };
+
+    // go in the order of the module, so that the results
+    // do not depend on the order in the maps.
+    // The globals are not in any function, so merge them
+    // only with the policy for the whole module
+    if (_options.allocCoarsening == AllocCoarsening::type) {
+        for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I)
+            addSite(&*I, nullptr);
+    }
+
+    for (const llvm::Function& F : *M) {
+        for (const llvm::BasicBlock& B : F) {
+            for (const llvm::Instruction& I : B) {
+                if (llvm::isa<llvm::AllocaInst>(&I) ||
+                    llvm::isa<llvm::CallInst>(&I))
+                    addSite(&I, &F);
+            }
+        }
+    }
+
+    // keep only the groups that are large enough
+    groups.erase(std::remove_if(groups.begin(), groups.end(),
+                                [this](const std::vector<PSNodeAlloc *>& g) {
+                                    return g.size() <= _options.coarseningThreshold;
+                                }),
+                 groups.end());
+
+    PointerGraphOptimizer optimizer(&PS);
+    unsigned merged = optimizer.mergeAllocations(groups);
+    if (merged > 0)
+        composeMapping(std::move(optimizer.getMapping()));
+
+    DBG(pta, "Merged " << merged << " allocation sites into "
+                       << groups.size() << " objects");
+    return merged;
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
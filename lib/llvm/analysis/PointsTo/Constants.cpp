@@ -1,3 +1,20 @@
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Operator.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
 #include "dg/llvm/analysis/PointsTo/PointerGraph.h"
 #include "llvm/llvm-utils.h"
 
@@ -7,148 +24,102 @@ namespace pta {
 
 extern const Pointer UnknownPointer;
 
-Pointer LLVMPointerGraphBuilder::handleConstantPtrToInt(const llvm::PtrToIntInst *P2I)
+// get the pointer that is the value of an operand of a constant expression.
+// Nested constant expressions are evaluated directly (and memoized),
+// no nodes are created for them.
+Pointer LLVMPointerGraphBuilder::getConstantOperandPointer(const llvm::Value *val)
 {
-    using namespace llvm;
+    if (const auto CE = llvm::dyn_cast<llvm::ConstantExpr>(val))
+        return getConstantExprPointer(CE);
 
-    const Value *llvmOp = P2I->getOperand(0);
-    // (possibly recursively) get the operand of this bit-cast
-    PSNode *op = getOperand(llvmOp);
+    PSNode *op = getOperand(val);
     assert(op->pointsTo.size() == 1
-           && "Constant PtrToInt with not only one pointer");
+           && "Constant operand with not only one pointer");
 
     return *op->pointsTo.begin();
 }
 
-Pointer LLVMPointerGraphBuilder::handleConstantIntToPtr(const llvm::IntToPtrInst *I2P)
+Pointer LLVMPointerGraphBuilder::handleConstantIntToPtr(const llvm::ConstantExpr *CE)
 {
     using namespace llvm;
 
-    const Value *llvmOp = I2P->getOperand(0);
+    const Value *llvmOp = CE->getOperand(0);
     if (isa<ConstantInt>(llvmOp)) {
-        llvm::errs() << "IntToPtr with constant: " << *I2P << "\n";
+        llvm::errs() << "IntToPtr with constant: " << *CE << "\n";
         return UnknownPointer;
     }
 
-    // (possibly recursively) get the operand of this bit-cast
-    PSNode *op = getOperand(llvmOp);
-    assert(op->pointsTo.size() == 1
-           && "Constant PtrToInt with not only one pointer");
-
-    return *op->pointsTo.begin();
+    return getConstantOperandPointer(llvmOp);
 }
 
-Pointer LLVMPointerGraphBuilder::handleConstantAdd(const llvm::Instruction *Inst)
+Pointer LLVMPointerGraphBuilder::handleConstantAdd(const llvm::ConstantExpr *CE)
 {
     using namespace llvm;
 
-    PSNode *op;
+    const Value *op;
     const Value *val = nullptr;
     Offset off = Offset::UNKNOWN;
 
     // see createAdd() for details
-    if (isa<ConstantInt>(Inst->getOperand(0))) {
-        op = getOperand(Inst->getOperand(1));
-        val = Inst->getOperand(0);
-    } else if (isa<ConstantInt>(Inst->getOperand(1))) {
-        op = getOperand(Inst->getOperand(0));
-        val = Inst->getOperand(1);
+    if (isa<ConstantInt>(CE->getOperand(0))) {
+        op = CE->getOperand(1);
+        val = CE->getOperand(0);
+    } else if (isa<ConstantInt>(CE->getOperand(1))) {
+        op = CE->getOperand(0);
+        val = CE->getOperand(1);
     } else {
-        op = tryGetOperand(Inst->getOperand(0));
-        if (!op)
-            op = tryGetOperand(Inst->getOperand(1));
-
-        if (!op) {
-            auto& unk = createUnknown(Inst);
-            return Pointer{unk.getSingleNode(), Offset::UNKNOWN};
-        }
+        op = CE->getOperand(0);
     }
 
-    assert(op && "Don't have operand for add");
     if (val)
         off = getConstantValue(val);
 
-    assert(op->pointsTo.size() == 1
-           && "Constant add with not only one pointer");
-
-    Pointer ptr = *op->pointsTo.begin();
+    Pointer ptr = getConstantOperandPointer(op);
     if (off.isUnknown())
         return Pointer(ptr.target, Offset::UNKNOWN);
     else
         return Pointer(ptr.target, ptr.offset + off);
 }
 
-Pointer LLVMPointerGraphBuilder::handleConstantArithmetic(const llvm::Instruction *Inst)
+Pointer LLVMPointerGraphBuilder::handleConstantArithmetic(const llvm::ConstantExpr *CE)
 {
     using namespace llvm;
 
-    PSNode *op;
-
-    if (isa<ConstantInt>(Inst->getOperand(0))) {
-        op = getOperand(Inst->getOperand(1));
-    } else if (isa<ConstantInt>(Inst->getOperand(1))) {
-        op = getOperand(Inst->getOperand(0));
-    } else {
-        op = tryGetOperand(Inst->getOperand(0));
-        if (!op)
-            op = tryGetOperand(Inst->getOperand(1));
-
-        if (!op)
-            return Pointer{createUnknown(Inst).getSingleNode(), Offset::UNKNOWN};
-    }
-
-    assert(op && "Don't have operand for add");
-    assert(op->pointsTo.size() == 1
-           && "Constant add with not only one pointer");
+    const Value *op;
+    if (isa<ConstantInt>(CE->getOperand(0)))
+        op = CE->getOperand(1);
+    else
+        op = CE->getOperand(0);
 
-    Pointer ptr = *op->pointsTo.begin();
+    Pointer ptr = getConstantOperandPointer(op);
     return Pointer(ptr.target, Offset::UNKNOWN);
 }
 
-Pointer LLVMPointerGraphBuilder::handleConstantBitCast(const llvm::BitCastInst *BC)
+Pointer LLVMPointerGraphBuilder::handleConstantGep(const llvm::ConstantExpr *CE)
 {
     using namespace llvm;
 
-    if (!BC->isLosslessCast()) {
-        errs() << "WARN: Not a loss less cast unhandled ConstExpr"
-               << *BC << "\n";
-        abort();
-        return UnknownPointer;
-    }
-
-    const Value *llvmOp = BC->stripPointerCasts();
-    // (possibly recursively) get the operand of this bit-cast
-    PSNode *op = getOperand(llvmOp);
-    assert(op->pointsTo.size() == 1
-           && "Constant BitCast with not only one pointer");
-
-    return *op->pointsTo.begin();
-}
-
-Pointer LLVMPointerGraphBuilder::handleConstantGep(const llvm::GetElementPtrInst *GEP)
-{
-    using namespace llvm;
-
-    const Value *op = GEP->getPointerOperand();
-    Pointer pointer(UNKNOWN_MEMORY, Offset::UNKNOWN);
-
-    // get operand PSNode (this may result in recursive call,
+    const Value *op = CE->getOperand(0);
+    // get the pointer of the operand (this may result in recursive call,
     // if this gep is recursively defined)
-    PSNode *opNode = getOperand(op);
-    assert(opNode->pointsTo.size() == 1
-           && "Constant node has more that 1 pointer");
-    pointer = *(opNode->pointsTo.begin());
+    Pointer pointer = getConstantOperandPointer(op);
 
     unsigned bitwidth = getPointerBitwidth(&M->getDataLayout(), op);
     APInt offset(bitwidth, 0);
 
     // get offset of this GEP
-    if (GEP->accumulateConstantOffset(M->getDataLayout(), offset)) {
-        if (offset.isIntN(bitwidth) && !pointer.offset.isUnknown())
-            pointer.offset = offset.getZExtValue();
-        else
-            errs() << "WARN: Offset greater than "
-                   << bitwidth << "-bit" << *GEP << "\n";
+    if (cast<GEPOperator>(CE)->accumulateConstantOffset(M->getDataLayout(), offset)) {
+        if (offset.isNegative()) {
+            uint64_t neg = (-offset).getZExtValue();
+            if (!pointer.offset.isUnknown() && *pointer.offset >= neg)
+                pointer.offset = *pointer.offset - neg;
+            else
+                pointer.offset = Offset::UNKNOWN;
+        } else {
+            pointer.offset += offset.getZExtValue();
+        }
+    } else {
+        pointer.offset = Offset::UNKNOWN;
     }
 
     return pointer;
@@ -158,12 +129,17 @@ Pointer LLVMPointerGraphBuilder::getConstantExprPointer(const llvm::ConstantExpr
 {
     using namespace llvm;
 
+    // constant expressions are shared by all their uses,
+    // so evaluate every one of them only once
+    auto it = _constantExprPointers.find(CE);
+    if (it != _constantExprPointers.end())
+        return it->second;
+
     Pointer pointer(UNKNOWN_MEMORY, Offset::UNKNOWN);
-    Instruction *Inst = const_cast<ConstantExpr*>(CE)->getAsInstruction();
 
-    switch(Inst->getOpcode()) {
+    switch(CE->getOpcode()) {
         case Instruction::GetElementPtr:
-            pointer = handleConstantGep(cast<GetElementPtrInst>(Inst));
+            pointer = handleConstantGep(CE);
             break;
         //case Instruction::ExtractValue:
         //case Instruction::Select:
@@ -171,16 +147,14 @@ Pointer LLVMPointerGraphBuilder::getConstantExprPointer(const llvm::ConstantExpr
         case Instruction::BitCast:
         case Instruction::SExt:
         case Instruction::ZExt:
-            pointer = handleConstantBitCast(cast<BitCastInst>(Inst));
-            break;
         case Instruction::PtrToInt:
-            pointer = handleConstantPtrToInt(cast<PtrToIntInst>(Inst));
+            pointer = getConstantOperandPointer(CE->getOperand(0));
             break;
         case Instruction::IntToPtr:
-            pointer = handleConstantIntToPtr(cast<IntToPtrInst>(Inst));
+            pointer = handleConstantIntToPtr(CE);
             break;
         case Instruction::Add:
-            pointer = handleConstantAdd(Inst);
+            pointer = handleConstantAdd(CE);
             break;
         case Instruction::And:
         case Instruction::Or:
@@ -193,27 +167,24 @@ Pointer LLVMPointerGraphBuilder::getConstantExprPointer(const llvm::ConstantExpr
         case Instruction::Sub:
         case Instruction::Mul:
         case Instruction::SDiv:
-            pointer = handleConstantArithmetic(Inst);
+            pointer = handleConstantArithmetic(CE);
             break;
         default:
             errs() << "ERR: Unsupported ConstantExpr " << *CE << "\n";
             abort();
     }
 
-#if LLVM_VERSION_MAJOR < 5
-    delete Inst;
-#else
-    Inst->deleteValue();
-#endif
+    _constantExprPointers.insert({CE, pointer});
     return pointer;
 }
 
 LLVMPointerGraphBuilder::PSNodesSeq&
 LLVMPointerGraphBuilder::createConstantExpr(const llvm::ConstantExpr *CE) {
+    // this is called only once for every constant expression,
+    // the node is then found in nodes_map by all the other uses
     Pointer ptr = getConstantExprPointer(CE);
     PSNode *node = PS.create(PSNodeType::CONSTANT, ptr.target, ptr.offset);
 
-
     return addNode(CE, node);
 }
 
@@ -0,0 +1,116 @@
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/analysis/PointsTo/PointerGraph.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+// the functions that are called directly from F
+// (the calls via pointers are not taken into account)
+static std::set<const llvm::Function *>
+getCalledFunctions(const llvm::Function& F)
+{
+    std::set<const llvm::Function *> called;
+    for (const llvm::BasicBlock& B : F) {
+        for (const llvm::Instruction& I : B) {
+            auto CI = llvm::dyn_cast<llvm::CallInst>(&I);
+            if (!CI)
+                continue;
+
+            if (const llvm::Function *callee = CI->getCalledFunction())
+                called.insert(callee);
+        }
+    }
+
+    return called;
+}
+
+static unsigned getPointerStoresNum(const llvm::Function& F)
+{
+    unsigned num = 0;
+    for (const llvm::BasicBlock& B : F) {
+        for (const llvm::Instruction& I : B) {
+            auto SI = llvm::dyn_cast<llvm::StoreInst>(&I);
+            if (SI && SI->getValueOperand()->getType()->isPointerTy())
+                ++num;
+        }
+    }
+
+    return num;
+}
+
+std::set<std::string> LLVMPointerGraphBuilder::getFlowSensitiveFunctions() const
+{
+    std::set<std::string> functions(_options.fsFunctions);
+
+    // the call graph as an undirected graph (the distance
+    // from the criteria is the distance in any direction)
+    std::map<const llvm::Function *, std::set<const llvm::Function *>> neighbours;
+    std::map<const llvm::Function *, unsigned> distance;
+    std::vector<const llvm::Function *> queue;
+
+    for (const llvm::Function& F : *M) {
+        if (F.isDeclaration())
+            continue;
+
+        if (_options.fsStoresThreshold > 0 &&
+            getPointerStoresNum(F) >= _options.fsStoresThreshold)
+            functions.insert(F.getName().str());
+
+        for (const llvm::Function *callee : getCalledFunctions(F)) {
+            if (_options.fsCriteria.count(callee->getName().str()) > 0 &&
+                distance.emplace(&F, 0).second)
+                queue.push_back(&F);
+
+            if (callee->isDeclaration())
+                continue;
+
+            neighbours[&F].insert(callee);
+            neighbours[callee].insert(&F);
+        }
+    }
+
+    // BFS from the functions that call the criteria
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const llvm::Function *F = queue[i];
+        functions.insert(F->getName().str());
+
+        unsigned dist = distance[F];
+        if (dist == _options.fsCriteriaDistance)
+            continue;
+
+        for (const llvm::Function *n : neighbours[F]) {
+            if (distance.emplace(n, dist + 1).second)
+                queue.push_back(n);
+        }
+    }
+
+    return functions;
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
@@ -40,45 +40,93 @@ namespace dg {
 namespace analysis {
 namespace pta {
 
+bool LLVMPointerGraphBuilder::typeContainsPointer(llvm::Type *Ty)
+{
+    auto it = _containsPointer.find(Ty);
+    if (it != _containsPointer.end())
+        return it->second;
+
+    bool ret = false;
+    if (Ty->isAggregateType()) {
+        for (auto I = Ty->subtype_begin(), E = Ty->subtype_end();
+             I != E; ++I) {
+            if (typeContainsPointer(*I)) {
+                ret = true;
+                break;
+            }
+        }
+    } else
+        ret = Ty->isPtrOrPtrVectorTy();
+
+    _containsPointer[Ty] = ret;
+    return ret;
+}
+
 void
 LLVMPointerGraphBuilder::handleGlobalVariableInitializer(const llvm::Constant *C,
                                                          PSNodeAlloc *node,
-                                                         uint64_t offset)
+                                                         uint64_t offset,
+                                                         uint64_t stride,
+                                                         uint64_t count)
 {
     using namespace llvm;
 
     // if the global is zero initialized, just set the zeroInitialized flag
     if (C->isNullValue()) {
         node->setZeroInitialized();
-    } else if (C->getType()->isAggregateType()) {
-        uint64_t off = 0;
-        for (auto I = C->op_begin(), E = C->op_end(); I != E; ++I) {
-            const Constant *op = cast<Constant>(*I);
-            Type *Ty = op->getType();
-            // recursively dive into the aggregate type
-            handleGlobalVariableInitializer(op, node, offset + off);
-            off += M->getDataLayout().getTypeAllocSize(Ty);
+    } else if (isa<UndefValue>(C) && !C->getType()->isAggregateType()) {
+        // undef value means unknown memory
+        node->addInitialPointer(offset, UnknownPointer, stride, count);
+    } else if (!typeContainsPointer(C->getType())) {
+        // there are no pointers in the initializer
+        return;
+    } else if (auto STy = dyn_cast<StructType>(C->getType())) {
+        const StructLayout *SL = M->getDataLayout().getStructLayout(STy);
+        for (unsigned i = 0, e = C->getNumOperands(); i < e; ++i) {
+            handleGlobalVariableInitializer(cast<Constant>(C->getOperand(i)),
+                                            node,
+                                            offset + SL->getElementOffset(i),
+                                            stride, count);
+        }
+    } else if (C->getType()->isAggregateType() || isa<ConstantVector>(C)) {
+        // the elements of arrays (and vectors) are uniqued constants, so we
+        // can find the runs of the same elements and handle them at once
+        for (unsigned i = 0, e = C->getNumOperands(); i < e;) {
+            const Constant *op = cast<Constant>(C->getOperand(i));
+            uint64_t elemSize = M->getDataLayout().getTypeAllocSize(op->getType());
+
+            unsigned j = i + 1;
+            while (j < e && C->getOperand(j) == op)
+                ++j;
+
+            if (count == 1) {
+                handleGlobalVariableInitializer(op, node, offset + i*elemSize,
+                                                elemSize, j - i);
+            } else {
+                // we already are in a run, we can not encode
+                // the nested one
+                for (unsigned k = i; k < j; ++k)
+                    handleGlobalVariableInitializer(op, node,
+                                                    offset + k*elemSize,
+                                                    stride, count);
+            }
+
+            i = j;
         }
     } else if (C->getType()->isPointerTy()) {
         PSNode *op = getOperand(C);
-        PSNode *target = PS.createGlobal(PSNodeType::CONSTANT, node, offset);
-        PS.createGlobal(PSNodeType::STORE, op, target);
-    } else if (isa<ConstantExpr>(C)
-                || isa<Function>(C)
-                || C->getType()->isPointerTy()) {
-       if (C->getType()->isPointerTy()) {
-           PSNode *value = getOperand(C);
-           assert(value->pointsTo.size() == 1 && "BUG: We should have constant");
-           PS.createGlobal(PSNodeType::STORE, value, node);
-       }
-    } else if (isa<UndefValue>(C)) {
-        // undef value means unknown memory
-        PSNode *target = PS.createGlobal(PSNodeType::CONSTANT, node, offset);
-        PS.createGlobal(PSNodeType::STORE, UNKNOWN_MEMORY, target);
-    } else if (!isa<ConstantInt>(C) && !isa<ConstantFP>(C)) {
-        llvm::errs() << *C << "\n";
-        llvm::errs() << "ERROR: ^^^ global variable initializer not handled\n";
-        abort();
+        if (!op->pointsTo.empty()) {
+            for (const Pointer& ptr : op->pointsTo)
+                node->addInitialPointer(offset, ptr, stride, count);
+        } else {
+            // the pointers will be known only after running the analysis,
+            // so we must store them by the analysis
+            for (uint64_t i = 0; i < count; ++i) {
+                PSNode *target = PS.createGlobal(PSNodeType::CONSTANT, node,
+                                                 offset + i*stride);
+                PS.createGlobal(PSNodeType::STORE, op, target);
+            }
+        }
     }
 }
 
@@ -94,8 +142,15 @@ static uint64_t getAllocatedSize(const llvm::GlobalVariable *GV,
 
 void LLVMPointerGraphBuilder::buildGlobals()
 {
+    // the immutable globals can not contain any pointer, so they
+    // are not processed by the analysis at all
+    immutableGlobals.compute(M);
+
     // create PointerGraph nodes
     for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I) {
+        if (immutableGlobals.isImmutable(&*I))
+            continue;
+
         // every global node is like memory allocation
         PSNodeAlloc *nd = PSNodeAlloc::get(PS.createGlobal(PSNodeType::ALLOC));
         nd->setIsGlobal();
@@ -105,6 +160,9 @@ void LLVMPointerGraphBuilder::buildGlobals()
     // only now handle the initializers - we need to have then
     // built, because they can point to each other
     for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I) {
+        if (immutableGlobals.isImmutable(&*I))
+            continue;
+
         PSNodeAlloc *node = PSNodeAlloc::get(getNodes(&*I)->getSingleNode());
         assert(node && "BUG: Do not have global variable"
                        " or it is not an allocation");
@@ -125,6 +183,20 @@ void LLVMPointerGraphBuilder::buildGlobals()
     }
 }
 
+// the node of an immutable global is not among the globals
+// of the graph -- it is only a target of pointers
+PSNode *LLVMPointerGraphBuilder::createImmutableGlobal(const llvm::GlobalVariable *GV)
+{
+    PSNodeAlloc *nd = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+    nd->setIsGlobal();
+    nd->setSize(getAllocatedSize(GV, &M->getDataLayout()));
+    if (GV->getInitializer()->isNullValue())
+        nd->setZeroInitialized();
+
+    addNode(GV, nd);
+    return nd;
+}
+
 } // namespace pta
 } // namespace analysis
 } // namespace dg
@@ -49,6 +49,59 @@ LLVMPointerGraphBuilder::createLoad(const llvm::Instruction *Inst) {
     return addNode(Inst, node);
 }
 
+// load of a local variable that is not modelled as memory.
+// The load is a PHI of the values written by the stores that reach it
+LLVMPointerGraphBuilder::PSNodesSeq&
+LLVMPointerGraphBuilder::createPromotedLoad(const llvm::Instruction *Inst) {
+    PSNode *node = PS.create(PSNodeType::PHI, nullptr);
+    assert(node);
+
+    // NOTE: the operands are added after building the whole function
+    // (the same as for PHI nodes), because the stored values
+    // may not have been built yet
+
+    return addNode(Inst, node);
+}
+
+// Get the offset of a GEP with variable indices. The variable indices
+// make the offset strided: the constant indices give the offset
+// in an element and the stride is the (greatest common divisor
+// of) the sizes of the elements indexed by the variable indices.
+static Offset getVariableGEPOffset(const llvm::GetElementPtrInst *GEP,
+                                   const llvm::DataLayout& DL) {
+    using namespace llvm;
+
+    // the constant part may be negative
+    int64_t constOffset = 0;
+    Offset strided = 0;
+    for (auto GTI = gep_type_begin(GEP), GTE = gep_type_end(GEP);
+         GTI != GTE; ++GTI) {
+#if LLVM_VERSION_MAJOR < 4
+        StructType *STy = dyn_cast<StructType>(*GTI);
+#else
+        StructType *STy = GTI.getStructTypeOrNull();
+#endif
+        if (STy) {
+            // indices into structures are always constant
+            auto idx = cast<ConstantInt>(GTI.getOperand())->getZExtValue();
+            constOffset += DL.getStructLayout(STy)->getElementOffset(idx);
+            continue;
+        }
+
+        Type *elemTy = GTI.getIndexedType();
+        if (!elemTy->isSized())
+            return Offset::UNKNOWN;
+
+        uint64_t elemSize = DL.getTypeAllocSize(elemTy);
+        if (auto C = dyn_cast<ConstantInt>(GTI.getOperand()))
+            constOffset += C->getSExtValue() * static_cast<int64_t>(elemSize);
+        else
+            strided += Offset::getStrided(elemSize, 0);
+    }
+
+    return strided + Offset(static_cast<uint64_t>(constOffset));
+}
+
 LLVMPointerGraphBuilder::PSNodesSeq&
 LLVMPointerGraphBuilder::createGEP(const llvm::Instruction *Inst) {
     using namespace llvm;
@@ -74,7 +127,17 @@ LLVMPointerGraphBuilder::createGEP(const llvm::Instruction *Inst) {
             // fall-through to Offset::UNKNOWN in this case
     }
 
-    // we didn't create the node with concrete offset,
+    // the indices are not constant, the GEP points to the same
+    // offset in some element of an array
+    if (!node && *_options.fieldSensitivity > 0 &&
+        !GEP->hasAllConstantIndices()) {
+        Offset off = getVariableGEPOffset(GEP, M->getDataLayout());
+        if (off.isStrided() &&
+            off.getElementOffset() < *_options.fieldSensitivity)
+            node = PS.create(PSNodeType::GEP, op, off);
+    }
+
+    // we didn't create the node with concrete or strided offset,
     // in which case we are supposed to create a node
     // with Offset::UNKNOWN
     if (!node)
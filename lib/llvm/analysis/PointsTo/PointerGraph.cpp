@@ -63,6 +63,8 @@ PSNode *LLVMPointerGraphBuilder::getConstant(const llvm::Value *val)
         PSNode *ret = PS.create(PSNodeType::FUNCTION);
         addNode(val, ret);
         return ret;
+    } else if (immutableGlobals.isImmutable(val)) {
+        return createImmutableGlobal(llvm::cast<llvm::GlobalVariable>(val));
     } else if (llvm::isa<llvm::Constant>(val)) {
         // it is just some constant that we can not handle
         return UNKNOWN_MEMORY;
@@ -279,6 +281,18 @@ void LLVMPointerGraphBuilder::addPHIOperands(PSNode *node, const llvm::PHINode *
     }
 }
 
+void LLVMPointerGraphBuilder::addPromotedLoadOperands(PSNode *node,
+                                                      const llvm::LoadInst *LI)
+{
+    for (const llvm::StoreInst *SI : promotable.getReachingStores(LI)) {
+        if (PSNode *op = tryGetOperand(SI->getValueOperand())) {
+            // do not add duplicate operands
+            if (!node->hasOperand(op))
+                node->addOperand(op);
+        }
+    }
+}
+
 template <typename OptsT>
 static bool isRelevantCall(const llvm::Instruction *Inst, bool invalidate_nodes,
                            const OptsT& opts)
@@ -337,7 +351,10 @@ LLVMPointerGraphBuilder::buildInstruction(const llvm::Instruction& Inst) {
             seq = &createStore(&Inst);
             break;
         case Instruction::Load:
-            seq = &createLoad(&Inst);
+            if (isPromotedAccess(&Inst))
+                seq = &createPromotedLoad(&Inst);
+            else
+                seq = &createLoad(&Inst);
             break;
         case Instruction::GetElementPtr:
             seq = &createGEP(&Inst);
@@ -587,6 +604,10 @@ LLVMPointerGraphBuilder::buildFunction(const llvm::Function& F)
 
     // build the instructions from blocks
     for (const llvm::BasicBlock *block : llvmBlocks) {
+        // we build only the code that was executed
+        if (!isCovered(block))
+            continue;
+
         auto blk = buildPointerGraphBlock(*block, subg);
 
         if (blk.empty()) {
@@ -640,6 +661,9 @@ PointerGraph *LLVMPointerGraphBuilder::buildLLVMPointerGraph()
         abort();
     }
 
+    if (_options.coverage)
+        promotable.setCoverage(_options.coverage);
+
     // first we must build globals, because nodes can use them as operands
     buildGlobals();
 
@@ -43,11 +43,16 @@ namespace pta {
 
 void LLVMPointerGraphBuilder::FuncGraph::blockAddSuccessors(std::set<const llvm::BasicBlock *>& found_blocks,
                                                             LLVMPointerGraphBuilder::PSNodesBlock& blk,
-                                                            const llvm::BasicBlock& block) {
+                                                            const llvm::BasicBlock& block,
+                                                            const ExecutionCoverage *coverage) {
 
     for (llvm::succ_const_iterator
          S = llvm::succ_begin(&block), SE = llvm::succ_end(&block); S != SE; ++S) {
 
+        // the code that was not executed is cut off
+        if (coverage && !coverage->isCovered(*S))
+            continue;
+
          // we already processed this block? Then don't try to add the edges again
          if (!found_blocks.insert(*S).second)
             continue;
@@ -58,7 +63,7 @@ void LLVMPointerGraphBuilder::FuncGraph::blockAddSuccessors(std::set<const llvm:
             // relevant instruction), we must pretend to be there for
             // control flow information. Thus instead of adding it as
             // successor, add its successors as successors
-            blockAddSuccessors(found_blocks, blk, *(*S));
+            blockAddSuccessors(found_blocks, blk, *(*S), coverage);
         } else {
             // add successor to the last nodes
             blk.getLastNode()->addSuccessor(it->second.getFirstNode());
@@ -171,7 +176,7 @@ LLVMPointerGraphBuilder::addCFGEdges(const llvm::Function *F,
         PSNodesBlock blk(&seq);
 
         std::set<const llvm::BasicBlock *> found_blocks;
-        finfo.blockAddSuccessors(found_blocks, blk, *entry);
+        finfo.blockAddSuccessors(found_blocks, blk, *entry, _options.coverage);
     }
 
     for (auto& it : finfo.llvmBlocks) {
@@ -184,7 +189,7 @@ LLVMPointerGraphBuilder::addCFGEdges(const llvm::Function *F,
         // so many blocks that this could have some big overhead. If proven
         // otherwise later, we'll change this.
         std::set<const llvm::BasicBlock *> found_blocks;
-        finfo.blockAddSuccessors(found_blocks, blk, *it.first);
+        finfo.blockAddSuccessors(found_blocks, blk, *it.first, _options.coverage);
     }
 }
 
@@ -1,4 +1,7 @@
 #include <set>
+#include <map>
+#include <vector>
+#include <algorithm>
 #include <cassert>
 
 // ignore unused parameters in LLVM libraries
@@ -162,7 +165,8 @@ RDNode *LLVMRDBuilder::createRealloc(const llvm::Instruction *Inst)
 
     if (buildUses) {
         // realloc copies the memory
-        auto defSites = mapPointers(Inst, Inst->getOperand(0), size);
+        auto defSites = mapPointers(Inst, Inst->getOperand(0), size,
+                                    true /* use */);
         for (const auto& ds : defSites) {
             node->addUse(ds);
         }
@@ -171,11 +175,17 @@ RDNode *LLVMRDBuilder::createRealloc(const llvm::Instruction *Inst)
     return node;
 }
 
-static void getLocalVariables(const llvm::Function *F,
-                              std::set<const llvm::Value *>& ret)
+const std::vector<const llvm::Value *>&
+LLVMRDBuilder::getLocalVariables(const llvm::Function *F)
 {
     using namespace llvm;
 
+    auto it = localVariables.find(F);
+    if (it != localVariables.end())
+        return it->second;
+
+    auto& ret = localVariables[F];
+
     // get all alloca insts that are not address taken
     // (are not stored into a pointer)
     // -- that means that they can not be used outside of
@@ -183,6 +193,10 @@ static void getLocalVariables(const llvm::Function *F,
     for (const BasicBlock& block : *F) {
         for (const Instruction& Inst : block) {
             if (isa<AllocaInst>(&Inst)) {
+                // promoted locals are never defined in the graph
+                if (_options.promoteLocals && promotable.isPromoted(&Inst))
+                    continue;
+
                 bool is_address_taken = false;
                 for (auto I = Inst.use_begin(), E = Inst.use_end();
                      I != E; ++I) {
@@ -200,10 +214,12 @@ static void getLocalVariables(const llvm::Function *F,
                 }
 
                 if (!is_address_taken)
-                    ret.insert(&Inst);
+                    ret.push_back(&Inst);
             }
         }
     }
+
+    return ret;
 }
 
 RDNode *LLVMRDBuilder::createReturn(const llvm::Instruction *Inst)
@@ -214,13 +230,7 @@ RDNode *LLVMRDBuilder::createReturn(const llvm::Instruction *Inst)
     if (!forgetLocalsAtReturn)
         return node;
 
-    // FIXME: don't do that for every return instruction,
-    // compute it only once for a function
-    std::set<const llvm::Value *> locals;
-    getLocalVariables(Inst->getParent()->getParent(),
-                      locals);
-
-    for (const llvm::Value *ptrVal : locals) {
+    for (const llvm::Value *ptrVal : getLocalVariables(Inst->getParent()->getParent())) {
         RDNode *ptrNode = getOperand(ptrVal);
         if (!ptrNode) {
             llvm::errs() << ValInfo(ptrVal) << "\n";
@@ -320,7 +330,8 @@ RDNode *LLVMRDBuilder::createLoad(const llvm::Instruction *Inst)
     if (size == 0)
         size = Offset::UNKNOWN;
 
-    auto defSites = mapPointers(Inst, Inst->getOperand(0), size);
+    auto defSites = mapPointers(Inst, Inst->getOperand(0), size,
+                                true /* use */);
     for (const auto& ds : defSites) {
         node->addUse(ds);
     }
@@ -393,10 +404,13 @@ LLVMRDBuilder::buildBlockNodes(Subgraph& subg, const llvm::BasicBlock& llvmBlock
                     node = createAlloc(&Inst);
                     break;
                 case Instruction::Store:
-                    node = createStore(&Inst);
+                    // stores to promoted locals are mapped
+                    // directly to the loads
+                    if (!isPromotedAccess(&Inst))
+                        node = createStore(&Inst);
                     break;
                 case Instruction::Load:
-                    if (buildUses)
+                    if (buildUses && !isPromotedAccess(&Inst))
                         node = createLoad(&Inst);
                     break;
                 case Instruction::Ret:
@@ -472,6 +486,10 @@ void LLVMRDBuilder::blockAddSuccessors(LLVMRDBuilder::Subgraph& subg,
     for (auto S = llvm::succ_begin(llvmBlock),
               SE = llvm::succ_end(llvmBlock); S != SE; ++S) {
 
+        // the code that was not executed is cut off
+        if (!isCovered(*S))
+            continue;
+
         // we already processed this block? Then don't try to add the edges again
         // FIXME: get rid of this... we can check whether we saw the RDBBlock...
         if (!visited.insert(*S).second)
@@ -671,6 +689,9 @@ LLVMRDBuilder::buildFunction(const llvm::Function& F)
     // so that all operands are created before their uses
     for (const auto llvmBlock :
               getBasicBlocksInDominatorOrder(const_cast<llvm::Function&>(F))) {
+        // we build only the code that was executed
+        if (!isCovered(llvmBlock))
+            continue;
 
         auto& block = buildBlock(subg, *llvmBlock);
 
@@ -755,6 +776,11 @@ RDNode *LLVMRDBuilder::createUndefinedCall(const llvm::CallInst *CInst)
             if (llvm::isa<llvm::Function>(ptr.value))
                 // function may not be redefined
                 continue;
+            if (PTA->getImmutableGlobals().isImmutable(ptr.value)) {
+                // the call may only read the immutable memory
+                addImmutableUse(CInst, ptr.value);
+                continue;
+            }
 
             RDNode *target = getOperand(ptr.value);
             assert(target && "Don't have pointer target for call argument");
@@ -848,6 +874,8 @@ RDNode *LLVMRDBuilder::createIntrinsicCall(const llvm::CallInst *CInst)
     for (const auto& ptr : pts.second) {
         if (llvm::isa<llvm::Function>(ptr.value))
             continue;
+        if (PTA->getImmutableGlobals().isImmutable(ptr.value))
+            continue;
 
         Offset from, to;
         if (ptr.offset.isUnknown()) {
@@ -920,6 +948,11 @@ RDNode *LLVMRDBuilder::funcFromModel(const FunctionModel *model, const llvm::Cal
             if (llvm::isa<llvm::Function>(ptr.value))
                 // functions may not be redefined
                 continue;
+            if (PTA->getImmutableGlobals().isImmutable(ptr.value)) {
+                if (model->uses(i))
+                    addImmutableUse(CInst, ptr.value);
+                continue;
+            }
 
             RDNode *target = getOperand(ptr.value);
             assert(target && "Don't have pointer target for call argument");
@@ -1063,8 +1096,11 @@ ReachingDefinitionsGraph&& LLVMRDBuilder::build()
         abort();
     }
 
+    if (_options.coverage)
+        promotable.setCoverage(_options.coverage);
+
     // first we must build globals, because nodes can use them as operands
-    auto glob = buildGlobals();
+    RDNode *glob = buildGlobals();
 
     // now we can build rest of the graph
     auto& subg = buildFunction(*F);
@@ -1074,24 +1110,30 @@ ReachingDefinitionsGraph&& LLVMRDBuilder::build()
     RDNode *root = subg.entry->nodes.front();
 
     // Do we have any globals at all?
-    // If so, insert them at the begining of the graph.
-    if (glob.first) {
-        assert(glob.second && "Have the start but not the end");
-        // this is a sequence of global nodes,
-        // make it the root of the graph
-        makeEdge(glob.second, root);
-        root = glob.first;
+    // If so, insert their initialization at the begining of the graph.
+    if (glob) {
+        makeEdge(glob, root);
+        root = glob;
     }
 
     // Add interprocedural edges. We do that here after all functions
     // are build to avoid problems with recursive procedures and such.
+    // The calls of pure functions do not go through their bodies,
+    // the data-flow goes directly from the call to the return node.
+    auto pure = getPureSubgraphs();
     for (auto& it : calls) {
         auto callNode = it.first.first;
         auto returnNode = it.first.second;
         assert(returnNode && "Do not have return node for a call");
         assert(returnNode->getType() == RDNodeType::CALL_RETURN && "Do not have return node for a call");
 
+        bool bypass = false;
         for (auto subg : it.second) {
+            if (pure.count(subg) > 0) {
+                bypass |= !subg->returns.empty();
+                continue;
+            }
+
             makeEdge(callNode, subg->entry->nodes.front());
             if (!subg->returns.empty()) {
                 for (auto ret : subg->returns) {
@@ -1100,6 +1142,11 @@ ReachingDefinitionsGraph&& LLVMRDBuilder::build()
             }
 
         }
+
+        const auto& succs = callNode->getSuccessors();
+        if (bypass &&
+            std::find(succs.begin(), succs.end(), returnNode) == succs.end())
+            makeEdge(callNode, returnNode);
     }
 
     if (_options.threads) {
@@ -1116,42 +1163,110 @@ ReachingDefinitionsGraph&& LLVMRDBuilder::build()
     return std::move(graph);
 }
 
-std::pair<RDNode *, RDNode *> LLVMRDBuilder::buildGlobals()
+static bool hasDefsOrUses(const RDNode *node)
+{
+    return !node->defs.empty() || !node->overwrites.empty() ||
+           !node->uses.empty() ||
+           node->getType() == RDNodeType::FORK ||
+           node->getType() == RDNodeType::JOIN;
+}
+
+std::set<const LLVMRDBuilder::Subgraph *> LLVMRDBuilder::getPureSubgraphs() const
+{
+    std::map<const RDNode *, const Subgraph *> callSites;
+    std::set<const Subgraph *> impure;
+    for (auto& it : subgraphs_map) {
+        const Subgraph *subg = &it.second;
+        for (auto& bit : subg->blocks) {
+            for (const RDNode *node : bit.second.nodes) {
+                callSites.emplace(node, subg);
+                if (hasDefsOrUses(node))
+                    impure.insert(subg);
+            }
+        }
+    }
+
+    // the callers of every subgraph
+    std::map<const Subgraph *, std::vector<const Subgraph *>> callers;
+    for (auto& it : calls) {
+        auto callSite = callSites.find(it.first.first);
+        if (callSite == callSites.end())
+            continue;
+
+        // the calls of the models of functions and undefined functions
+        // are already between the call and the return node
+        for (const RDNode *succ : it.first.first->getSuccessors()) {
+            if (hasDefsOrUses(succ))
+                impure.insert(callSite->second);
+        }
+
+        for (const Subgraph *subg : it.second)
+            callers[subg].push_back(callSite->second);
+    }
+
+    // the functions that call an impure function are impure too
+    std::vector<const Subgraph *> queue(impure.begin(), impure.end());
+    while (!queue.empty()) {
+        const Subgraph *subg = queue.back();
+        queue.pop_back();
+
+        for (const Subgraph *caller : callers[subg]) {
+            if (impure.insert(caller).second)
+                queue.push_back(caller);
+        }
+    }
+
+    std::set<const Subgraph *> pure;
+    for (auto& it : subgraphs_map) {
+        if (impure.count(&it.second) == 0)
+            pure.insert(&it.second);
+    }
+
+    return pure;
+}
+
+RDNode *LLVMRDBuilder::buildGlobals()
 {
-    RDNode *cur = nullptr, *prev, *first = nullptr;
+    const auto& immutable = PTA->getImmutableGlobals();
+
     for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I) {
-        prev = cur;
+        // nothing is ever written to the immutable globals,
+        // so there is nothing to define or to use in them
+        if (immutable.isImmutable(&*I))
+            continue;
 
-        // every global node is like memory allocation
-        cur = create(RDNodeType::ALLOC);
-        addNode(&*I, cur);
+        // every global node is like memory allocation,
+        // it is only a target of def-sites and so it is not
+        // a part of the graph
+        RDNode *nd = create(RDNodeType::ALLOC);
+        addNode(&*I, nd);
 
-        // add the initial global definitions
+        // add the initial global definitions, all of them
+        // are in one node instead of a long chain of nodes
         if (auto GV = llvm::dyn_cast<llvm::GlobalVariable>(&*I)) {
             auto size = getAllocatedSize(GV->getType()->getContainedType(0), DL);
             if (size == 0)
                 size = Offset::UNKNOWN;
 
-            cur->addDef(cur, 0, size, true /* strong update */);
+            if (!globalsInit)
+                globalsInit = create(RDNodeType::STORE);
+            globalsInit->addDef(nd, 0, size, true /* strong update */);
         }
-
-        if (prev)
-            makeEdge(prev, cur);
-        else
-            first = cur;
     }
 
-    assert((!first && !cur) || (first && cur));
-    return std::pair<RDNode *, RDNode *>(first, cur);
+    return globalsInit;
 }
 
 ///
 // Map pointers of 'val' to def-sites.
 // \param where  location in the program, for debugging
 // \param size is the number of bytes used from the memory
+// \param isUse  the pointers are read by 'where' (the immutable
+//               globals are recorded as its uses, see getImmutableUses())
 std::vector<DefSite> LLVMRDBuilder::mapPointers(const llvm::Value *where,
                                                 const llvm::Value *val,
-                                                Offset size)
+                                                Offset size,
+                                                bool isUse)
 {
     std::vector<DefSite> result;
 
@@ -1190,9 +1305,17 @@ std::vector<DefSite> LLVMRDBuilder::mapPointers(const llvm::Value *where,
         result.push_back(DefSite(UNKNOWN_MEMORY));
     }
 
+    const auto& immutable = PTA->getImmutableGlobals();
     for (const auto& ptr: psn.second) {
         if (llvm::isa<llvm::Function>(ptr.value))
             continue;
+        // the immutable memory is not in the graph, its uses
+        // are reached only by the initializer
+        if (immutable.isImmutable(ptr.value)) {
+            if (isUse)
+                addImmutableUse(where, ptr.value);
+            continue;
+        }
 
         RDNode *ptrNode = getOperand(ptr.value);
         if (!ptrNode) {
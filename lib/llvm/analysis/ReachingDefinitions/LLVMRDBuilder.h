@@ -3,6 +3,8 @@
 
 #include <unordered_map>
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
@@ -26,6 +28,8 @@
 #include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
 #include "dg/llvm/analysis/ReachingDefinitions/LLVMReachingDefinitionsAnalysisOptions.h"
 #include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
+#include "dg/llvm/analysis/PromotableAllocas.h"
+#include "dg/llvm/analysis/ExecutionCoverage.h"
 
 namespace dg {
 namespace analysis {
@@ -72,6 +76,28 @@ protected:
     // map of all built subgraphs - the value type is a pair (root, return)
     std::unordered_map<const llvm::Value *, Subgraph> subgraphs_map;
 
+    // local variables that we do not model as memory
+    PromotableAllocas promotable;
+
+    // was the block executed? (if we build only the executed code)
+    bool isCovered(const llvm::BasicBlock *B) const {
+        return !_options.coverage || _options.coverage->isCovered(B);
+    }
+
+    // the node that defines the initial values of all globals
+    RDNode *globalsInit{nullptr};
+
+    // the immutable globals read by the instructions, the globals
+    // have no nodes and their only definition is the initializer
+    std::unordered_map<const llvm::Value *,
+                       std::vector<const llvm::Value *>> immutableUses;
+
+    void addImmutableUse(const llvm::Value *where, const llvm::Value *glob) {
+        auto& uses = immutableUses[where];
+        if (std::find(uses.begin(), uses.end(), glob) == uses.end())
+            uses.push_back(glob);
+    }
+
     RDNode *create(RDNodeType t) { return graph.create(t); }
 
 public:
@@ -99,6 +125,31 @@ public:
 
         return it->second;
     }
+
+    // the definitions of globals made by this node are the globals
+    // themselves, the node has no value on its own
+    RDNode *getGlobalsInitialization() const { return globalsInit; }
+
+    // the immutable globals (see ImmutableGlobals) read by 'val'
+    const std::vector<const llvm::Value *>&
+    getImmutableUses(const llvm::Value *val) const {
+        static const std::vector<const llvm::Value *> empty;
+        auto it = immutableUses.find(val);
+        return it == immutableUses.end() ? empty : it->second;
+    }
+
+    // is this a load or store of a local variable that is not modelled
+    // as memory? Such instructions have no nodes in the graph
+    bool isPromotedAccess(const llvm::Instruction *I) {
+        return _options.promoteLocals && promotable.isPromotedAccess(I);
+    }
+
+    // the definitions of the value read by a promoted load
+    const std::vector<const llvm::StoreInst *>&
+    getPromotedDefinitions(const llvm::LoadInst *LI) {
+        assert(isPromotedAccess(LI));
+        return promotable.getReachingStores(LI);
+    }
 };
 
 class LLVMRDBuilder : public LLVMRDBuilderBase {
@@ -117,13 +168,14 @@ public:
 
 private:
 
-    static void blockAddSuccessors(Subgraph& subg, Block& block,
-                                   const llvm::BasicBlock *llvmBlock,
-                                   std::set<const llvm::BasicBlock *>& visited);
+    void blockAddSuccessors(Subgraph& subg, Block& block,
+                            const llvm::BasicBlock *llvmBlock,
+                            std::set<const llvm::BasicBlock *>& visited);
 
     std::vector<DefSite> mapPointers(const llvm::Value *where,
                                      const llvm::Value *val,
-                                     Offset size);
+                                     Offset size,
+                                     bool isUse = false);
 
     void addNode(const llvm::Value *val, RDNode *node)
     {
@@ -147,6 +199,11 @@ private:
     RDNode *createRealloc(const llvm::Instruction *Inst);
     RDNode *createReturn(const llvm::Instruction *Inst);
 
+    // local variables of functions that are forgotten at returns
+    std::unordered_map<const llvm::Function *,
+                       std::vector<const llvm::Value *>> localVariables;
+    const std::vector<const llvm::Value *>&
+    getLocalVariables(const llvm::Function *F);
 
     RDNode *funcFromModel(const FunctionModel *model, const llvm::CallInst *);
     Block& buildBlock(Subgraph& subg, const llvm::BasicBlock& block);
@@ -154,7 +211,7 @@ private:
     Subgraph& buildFunction(const llvm::Function& F);
     Subgraph *getOrCreateSubgraph(const llvm::Function *F);
 
-    std::pair<RDNode *, RDNode *> buildGlobals();
+    RDNode *buildGlobals();
 
     std::pair<RDNode *, RDNode *> createCallToFunction(const llvm::Function *F, const llvm::CallInst *CInst);
 
@@ -179,6 +236,10 @@ private:
 
     bool isInlineAsm(const llvm::Instruction *instruction);
 
+    // the subgraphs of the functions that do not define nor use
+    // any memory (not even in the functions that they call)
+    std::set<const Subgraph *> getPureSubgraphs() const;
+
     void matchForksAndJoins();
 };
 
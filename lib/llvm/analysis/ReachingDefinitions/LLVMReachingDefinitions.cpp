@@ -1,3 +1,6 @@
+#include <set>
+#include <vector>
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -31,6 +34,7 @@ void LLVMReachingDefinitions::initializeSparseRDA() {
     builder = new LLVMRDBuilder(m, pta, _options);
     // let the compiler do copy-ellision
     auto graph = builder->build();
+    graph.optimize();
 
     RDA = std::unique_ptr<ReachingDefinitionsAnalysis>(
                     new SSAReachingDefinitionsAnalysis(std::move(graph)));
@@ -40,6 +44,7 @@ void LLVMReachingDefinitions::initializeDenseRDA() {
     builder = new LLVMRDBuilder(m, pta, _options,
                                 true /* forget locals at return */);
     auto graph = builder->build();
+    graph.optimize();
 
     RDA = std::unique_ptr<ReachingDefinitionsAnalysis>(
                     new ReachingDefinitionsAnalysis(std::move(graph)));
@@ -60,12 +65,70 @@ LLVMReachingDefinitions::getNodesMap() const {
     return builder->getNodesMap();
 }
 
+static const llvm::LoadInst *getPromotedLoad(LLVMRDBuilder *builder,
+                                             const llvm::Value *val) {
+    auto LI = llvm::dyn_cast<llvm::LoadInst>(val);
+    if (LI && builder->isPromotedAccess(LI))
+        return LI;
+    return nullptr;
+}
+
+bool LLVMReachingDefinitions::isUse(const llvm::Value *val) const {
+    if (getPromotedLoad(builder, val))
+        return true;
+
+    // the reads of immutable globals are not in the graph
+    if (!builder->getImmutableUses(val).empty())
+        return true;
+
+    auto nd = getNode(val);
+    return nd && !nd->getUses().empty();
+}
+
+// The initialization node defines all globals at once, the definitions
+// of the globals that are read by 'use' are the globals themselves.
+// If 'use' reads several objects, we do not know which of the globals
+// were overwritten since the initialization, so we take all of them.
+static void addGlobalsDefinitions(const RDNode *init, const RDNode *use,
+                                  std::set<const llvm::Value *>& globals,
+                                  std::vector<llvm::Value *>& defs) {
+    auto add = [&](RDNode *target) {
+        auto GV = target->getUserData<llvm::Value>();
+        if (GV && llvm::isa<llvm::GlobalVariable>(GV) &&
+            globals.insert(GV).second)
+            defs.push_back(GV);
+    };
+
+    for (const DefSite& ds : use->getUses()) {
+        if (ds.target->isUnknown()) {
+            for (const DefSite& def : init->getDefines())
+                add(def.target);
+        } else {
+            add(ds.target);
+        }
+    }
+}
+
 // the value 'use' must be an instruction that reads from memory
 std::vector<llvm::Value *>
 LLVMReachingDefinitions::getLLVMReachingDefinitions(llvm::Value *use) {
 
     std::vector<llvm::Value *> defs;
 
+    // the definitions of promoted locals are the stores
+    // that reach the load, we do not need to ask the analysis
+    // (there are none if the load reads an uninitialized local)
+    if (auto LI = getPromotedLoad(builder, use)) {
+        for (auto SI : builder->getPromotedDefinitions(LI))
+            defs.push_back(const_cast<llvm::StoreInst *>(SI));
+        return defs;
+    }
+
+    // the only definition of an immutable global is its initializer,
+    // that is the global itself
+    for (const llvm::Value *glob : builder->getImmutableUses(use))
+        defs.push_back(const_cast<llvm::Value *>(glob));
+
     auto loc = getNode(use);
     if (!loc) {
         llvm::errs() << "[RD] error: no node for: " << *use << "\n";
@@ -73,7 +136,8 @@ LLVMReachingDefinitions::getLLVMReachingDefinitions(llvm::Value *use) {
     }
 
     if (loc->getUses().empty()) {
-        llvm::errs() << "[RD] error: the queried value has empty uses: " << *use << "\n";
+        if (defs.empty())
+            llvm::errs() << "[RD] error: the queried value has empty uses: " << *use << "\n";
         return defs;
     }
 
@@ -82,7 +146,7 @@ LLVMReachingDefinitions::getLLVMReachingDefinitions(llvm::Value *use) {
     }
 
     auto rdDefs = getReachingDefinitions(loc);
-    if (rdDefs.empty()) {
+    if (rdDefs.empty() && defs.empty()) {
         static std::set<const llvm::Value *> reported;
         if (reported.insert(use).second) {
             llvm::errs() << "[RD] error: no reaching definition for: " << *use << "\n";
@@ -90,8 +154,14 @@ LLVMReachingDefinitions::getLLVMReachingDefinitions(llvm::Value *use) {
     }
 
     //map the values
+    std::set<const llvm::Value *> globals;
     for (RDNode *nd : rdDefs) {
         assert(nd->getType() != rd::RDNodeType::PHI);
+        if (nd == builder->getGlobalsInitialization()) {
+            addGlobalsDefinitions(nd, loc, globals, defs);
+            continue;
+        }
+
         auto llvmvalue = nd->getUserData<llvm::Value>();
         assert(llvmvalue && "RD node has no value");
         defs.push_back(llvmvalue);
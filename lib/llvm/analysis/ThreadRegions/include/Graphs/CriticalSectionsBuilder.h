@@ -5,6 +5,15 @@
 #include <map>
 #include <set>
 
+namespace dg {
+    class LLVMPointerAnalysis;
+    namespace analysis {
+    namespace pta {
+        class PSNode;
+    }
+    }
+}
+
 class Node;
 class LockNode;
 class UnlockNode;
@@ -14,63 +23,63 @@ class ForkNode;
 namespace llvm {
     class Instruction;
     class CallInst;
+    class BasicBlock;
+    class Function;
 }
 
 class CriticalSection {
 private:
-    LockNode *          lock_;
-    std::set<Node *>    nodes_;
+    LockNode *                          lock_;
+    std::set<const llvm::Instruction *> nodes_;
 
 public:
     CriticalSection(LockNode * lock);
 
     const llvm::CallInst * lock() const;
 
-    std::set<const llvm::Instruction *> nodes() const;
+    const std::set<const llvm::Instruction *> & nodes() const;
 
     std::set<const llvm::CallInst *> unlocks() const;
 
-    bool insertNodes(const std::set<Node *> & nodes_);
+    bool insertNode(Node * node);
 };
 
+///
+// Computes critical sections of all locks at once using a forward
+// "may hold locks" data-flow analysis. Every lock has its ID and every
+// node of the graph gets a bitset of the locks that may be held when
+// the node is reached. A lock generates its ID and its corresponding
+// unlocks kill it, except the unlocks that we know may release another
+// mutex (see releases()). The critical section of a lock are then
+// the nodes that have the ID of the lock in their bitset.
 class CriticalSectionsBuilder
 {
-    std::set<LockNode *>            locks_;
-
-    LockNode *                      currentLock;
-    std::set<UnlockNode *>          currentUnlocks;
-
-    std::set<Node *>                visited_;
-    std::set<Node *>                examined_;
-
+    dg::LLVMPointerAnalysis *                               pointsToAnalysis_;
     std::map<const llvm::CallInst *,CriticalSection *>     criticalSections_;
+    mutable std::map<const llvm::Function *, bool>          recursiveFunctions_;
 public:
-    CriticalSectionsBuilder();
+    CriticalSectionsBuilder(dg::LLVMPointerAnalysis * pointsToAnalysis);
 
     ~CriticalSectionsBuilder();
 
-    bool buildCriticalSection(LockNode * lock);
+    bool buildCriticalSections(const std::set<LockNode *> & locks);
 
     std::set<const llvm::CallInst *> locks() const;
 
-    std::set<const llvm::Instruction *> correspondingNodes(const llvm::CallInst * lock) const;
+    const std::set<const llvm::Instruction *> & correspondingNodes(const llvm::CallInst * lock) const;
 
     std::set<const llvm::CallInst *> correspondingUnlocks(const llvm::CallInst * lock) const;
 
 private:
-    bool populateCriticalSection();
-
-    void visitNode(Node * node);
-
-    void preVisit(Node * node);
+    bool releases(const UnlockNode * unlock, const LockNode * lock) const;
 
-    void visit(Node * node);
+    bool isSingleInstance(dg::analysis::pta::PSNode * target) const;
 
-    void postVisit(Node * node);
+    bool isRecursive(const llvm::Function * function) const;
 
-    bool visited(Node * node) const;
+    static bool isInLoop(const llvm::BasicBlock * block);
 
-    bool examined(Node * node) const;
+    static std::vector<Node *> reversePostorder(const std::vector<LockNode *> & locks);
 };
 
 #endif // CRITICALSECTIONSBUILDER_H
@@ -3,6 +3,8 @@
 
 #include <utility>
 #include <set>
+#include <vector>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -10,12 +12,14 @@ namespace dg {
     class LLVMPointerAnalysis;
     namespace analysis {
     namespace pta {
+        class PSNode;
         class PSNodeJoin;
     }
     }
 }
 
 namespace llvm {
+    class Value;
     class Instruction;
     class BasicBlock;
     class Function;
@@ -32,9 +36,15 @@ class FunctionGraph;
 
 class GraphBuilder
 {
+public:
+    using NodeSequence = std::pair<Node *, Node *>;
+
 private:
     dg::LLVMPointerAnalysis *                                       pointsToAnalysis_ = nullptr;
 
+    // the number of threads that build the graphs of functions
+    unsigned                                                        workers_ = 1;
+
     std::unordered_set<Node *>                                      artificialNodes_;
     std::unordered_map<const llvm::Instruction *, Node *>           llvmToNodeMap_;
 
@@ -47,10 +57,46 @@ private:
     std::unordered_map<const llvm::CallInst *, LockNode *>          llvmToLocks_;
     std::unordered_map<const llvm::CallInst *, UnlockNode *>        llvmToUnlocks_;
 
-public:
-    using NodeSequence = std::pair<Node *, Node *>;
+    // functions that a value may point to, queried before the parallel
+    // phase, because the queries may modify the pointer analysis
+    std::unordered_map<const llvm::Value *,
+                       std::vector<const llvm::Function *>>         pointsToFunctions_;
+
+    // calls of defined functions and the graphs of the called functions
+    std::unordered_map<const Node *, FunctionGraph *>               calledFunctions_;
+
+    struct MutexBucket {
+        std::set<LockNode *>    locks;
+        std::set<UnlockNode *>  unlocks;
+    };
+
+    // A call (or fork) of a defined function that is not connected yet.
+    // Until it is connected, the node of the call also stands for the exit
+    // of the called function, i.e. it has the successors of the exit.
+    struct PendingCall {
+        Node *                      node;
+        const llvm::Function *      function;
+        bool                        fork;
+    };
+
+    // Nodes of one function (or a part of it) built independently
+    // of the other functions, so that more functions can be built at once
+    struct FunctionBuild {
+        const llvm::Function *                                      function = nullptr;
+        FunctionGraph *                                             graph = nullptr;
+        // in the order of creation
+        std::vector<Node *>                                         nodes;
+        std::unordered_map<const llvm::BasicBlock *, NodeSequence>  blocks;
+        // in the order of creation
+        std::vector<PendingCall>                                    calls;
+
+        FunctionBuild(const llvm::Function * function = nullptr) : function(function) {}
+    };
+
+    using FunctionBuilds = std::vector<std::unique_ptr<FunctionBuild>>;
 
-    GraphBuilder(dg::LLVMPointerAnalysis * pointsToAnalysis);
+public:
+    GraphBuilder(dg::LLVMPointerAnalysis * pointsToAnalysis, unsigned workers = 1);
 
     ~GraphBuilder();
 
@@ -88,48 +134,69 @@ public:
     void clear();
 
 private:
-    NodeSequence buildCallInstruction(const llvm::Instruction * instruction);
+    // the intra-procedural part, it may run in parallel for different functions
+    NodeSequence buildInstruction(FunctionBuild & build, const llvm::Instruction * instruction);
+
+    NodeSequence buildBlock(FunctionBuild & build, const llvm::BasicBlock * basicBlock);
+
+    void buildFunction(FunctionBuild & build);
+
+    NodeSequence buildCallInstruction(FunctionBuild & build, const llvm::Instruction * instruction);
 
-    NodeSequence buildReturnInstruction(const llvm::Instruction * instruction);
+    NodeSequence buildReturnInstruction(FunctionBuild & build, const llvm::Instruction * instruction);
 
-    NodeSequence buildGeneralInstruction(const llvm::Instruction * instruction);
+    NodeSequence buildGeneralInstruction(FunctionBuild & build, const llvm::Instruction * instruction);
 
-    NodeSequence buildGeneralCallInstruction(const llvm::CallInst * callInstruction);
+    NodeSequence buildGeneralCallInstruction(FunctionBuild & build, const llvm::CallInst * callInstruction);
 
-    NodeSequence insertFunction(const llvm::Function * function, const llvm::CallInst *callInstruction);
+    NodeSequence insertFunction(FunctionBuild & build, const llvm::Function * function, const llvm::CallInst *callInstruction);
 
-    NodeSequence insertFunctionPointerCall(const llvm::CallInst *callInstruction);
+    NodeSequence insertFunctionPointerCall(FunctionBuild & build, const llvm::CallInst *callInstruction);
 
-    NodeSequence insertUndefinedFunction(const llvm::Function * function, const llvm::CallInst *callInstruction);
+    NodeSequence insertUndefinedFunction(FunctionBuild & build, const llvm::Function * function, const llvm::CallInst *callInstruction);
 
-    NodeSequence insertPthreadCreate(const llvm::CallInst * callInstruction);
+    NodeSequence insertPthreadCreate(FunctionBuild & build, const llvm::CallInst * callInstruction);
 
-    NodeSequence insertPthreadMutexLock(const llvm::CallInst * callInstruction);
+    NodeSequence insertPthreadMutexLock(FunctionBuild & build, const llvm::CallInst * callInstruction);
 
-    NodeSequence insertPthreadMutexUnlock(const llvm::CallInst * callInstruction);
+    NodeSequence insertPthreadMutexUnlock(FunctionBuild & build, const llvm::CallInst * callInstruction);
 
-    NodeSequence insertPthreadJoin(const llvm::CallInst * callInstruction);
+    NodeSequence insertPthreadJoin(FunctionBuild & build, const llvm::CallInst * callInstruction);
 
-    NodeSequence insertPthreadExit(const llvm::CallInst * callInstruction);
+    NodeSequence insertPthreadExit(FunctionBuild & build, const llvm::CallInst * callInstruction);
 
-    NodeSequence createOrGetFunction(const llvm::Function * function);
+    // the sequential part
+    void resolvePointsToFunctions(const llvm::Instruction * instruction);
+
+    const std::vector<const llvm::Function *> & resolvePointsToFunctions(const llvm::Value * value);
+
+    const std::vector<const llvm::Function *> & pointsToFunctions(const llvm::Value * value) const;
+
+    void buildCalledFunctions(FunctionBuilds & builds);
+
+    void buildFunctions(FunctionBuilds & builds, std::size_t first);
+
+    void renumberNodes(FunctionBuilds & builds, std::size_t index,
+                       std::unordered_map<const llvm::Function *, std::size_t> & functions,
+                       std::unordered_set<const llvm::Function *> & visited,
+                       int & id);
+
+    void commit(FunctionBuilds & builds);
+
+    void registerNode(Node * node);
+
+    Node * resolveSequenceEnd(Node * node) const;
 
     bool populateCorrespondingForks(JoinNode * join, dg::analysis::pta::PSNodeJoin *PSJoin);
 
     bool connectJoins(JoinNode * join, dg::analysis::pta::PSNodeJoin *PSJoin);
 
+    bool getMutexTargets(const llvm::CallInst * callInst, std::set<dg::analysis::pta::PSNode *> & targets) const;
+
     template <typename T>
-    T * addNode(T * node) {
-        if (node->isArtificial()) {
-            if (this->artificialNodes_.insert(node).second) {
-                return node;
-            }
-        } else {
-            if (this->llvmToNodeMap_.emplace(node->llvmInstruction(), node).second) {
-                return node;
-            }
-        }
-        return nullptr;
+    T * addNode(FunctionBuild & build, T * node) {
+        build.nodes.push_back(node);
+        return node;
     }
 };
 
@@ -2,6 +2,7 @@
 #define NODE_H
 
 #include <set>
+#include <atomic>
 #include <iosfwd>
 #include <string>
 
@@ -37,14 +38,19 @@ inline std::string nodeTypeToString(enum NodeType type)
 class Node
 {
 private:
-    const int                   id_;
+    int                         id_;
     const NodeType              nodeType_;
     const llvm::Instruction *   llvmInstruction_;
     const llvm::CallInst *      callInstruction_;
     std::set<Node *>            predecessors_;
     std::set<Node *>            successors_;
 
-    static int lastId;
+    // nodes may be created by several threads at once
+    static std::atomic<int> lastId;
+
+    // GraphBuilder renumbers the nodes built in parallel,
+    // so that the ids do not depend on the scheduling
+    friend class GraphBuilder;
 
 public:
     Node(NodeType type, const llvm::Instruction * instruction = nullptr, const llvm::CallInst * callInst = nullptr);
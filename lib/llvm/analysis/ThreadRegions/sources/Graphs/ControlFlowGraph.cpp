@@ -4,10 +4,10 @@
 #include "ThreadRegionsBuilder.h"
 #include "CriticalSectionsBuilder.h"
 
-ControlFlowGraph::ControlFlowGraph(dg::LLVMPointerAnalysis *pointsToAnalysis)
-    :graphBuilder(new GraphBuilder(pointsToAnalysis)),
+ControlFlowGraph::ControlFlowGraph(dg::LLVMPointerAnalysis *pointsToAnalysis, unsigned workers)
+    :graphBuilder(new GraphBuilder(pointsToAnalysis, workers)),
      threadRegionsBuilder(new ThreadRegionsBuilder()),
-     criticalSectionsBuilder(new CriticalSectionsBuilder()){}
+     criticalSectionsBuilder(new CriticalSectionsBuilder(pointsToAnalysis)){}
 
 std::set<const llvm::CallInst *> ControlFlowGraph::getJoins() const {
     return graphBuilder->getJoins();
@@ -25,7 +25,7 @@ std::set<const llvm::CallInst *> ControlFlowGraph::getCorrespongingUnlocks(const
     return criticalSectionsBuilder->correspondingUnlocks(callInst);
 }
 
-std::set<const llvm::Instruction *> ControlFlowGraph::getCorrespondingCriticalSection(const llvm::CallInst * callInst) const {
+const std::set<const llvm::Instruction *> & ControlFlowGraph::getCorrespondingCriticalSection(const llvm::CallInst * callInst) const {
     return criticalSectionsBuilder->correspondingNodes(callInst);
 }
 
@@ -36,11 +36,7 @@ void ControlFlowGraph::buildFunction(const llvm::Function * function) {
     graphBuilder->matchForksAndJoins();
     graphBuilder->matchLocksAndUnlocks();
 
-    auto locks = graphBuilder->getLocks();
-
-    for (auto lock : locks) {
-        criticalSectionsBuilder->buildCriticalSection(lock);
-    }
+    criticalSectionsBuilder->buildCriticalSections(graphBuilder->getLocks());
 
     threadRegionsBuilder->reserve(graphBuilder->size());
     threadRegionsBuilder->build(nodeSeq.first);
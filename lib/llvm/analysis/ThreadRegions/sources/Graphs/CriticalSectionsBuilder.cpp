@@ -1,6 +1,9 @@
 #include "CriticalSectionsBuilder.h"
 #include "Nodes.h"
 
+#include "dg/ADT/Bitvector.h"
+#include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -10,6 +13,8 @@
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #endif
 
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 
 #if (__clang__)
@@ -18,9 +23,14 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
+using dg::ADT::SparseBitvector;
 
-CriticalSectionsBuilder::CriticalSectionsBuilder()
+CriticalSectionsBuilder::CriticalSectionsBuilder(dg::LLVMPointerAnalysis *pointsToAnalysis)
+    :pointsToAnalysis_(pointsToAnalysis)
 {}
 
 CriticalSectionsBuilder::~CriticalSectionsBuilder() {
@@ -29,31 +39,223 @@ CriticalSectionsBuilder::~CriticalSectionsBuilder() {
     }
 }
 
-bool CriticalSectionsBuilder::buildCriticalSection(LockNode *lock) {
-    auto iterator = criticalSections_.find(lock->callInstruction());
-    if (iterator != criticalSections_.end()) {
+bool CriticalSectionsBuilder::buildCriticalSections(const std::set<LockNode *> &locks) {
+    // lock ID is the index into this vector
+    std::vector<LockNode *> newLocks;
+    std::vector<CriticalSection *> sections;
+    std::unordered_map<Node *, size_t> lockIds;
+    std::unordered_map<Node *, SparseBitvector> kills;
+
+    for (auto lock : locks) {
+        auto iterator = criticalSections_.find(lock->callInstruction());
+        if (iterator != criticalSections_.end()) {
+            continue;
+        }
+
+        auto criticalSection = new CriticalSection(lock);
+        criticalSections_.emplace(lock->callInstruction(), criticalSection);
+
+        lockIds.emplace(lock, newLocks.size());
+        for (auto unlock : lock->correspondingUnlocks()) {
+            if (releases(unlock, lock)) {
+                kills[unlock].set(newLocks.size());
+            }
+        }
+        newLocks.push_back(lock);
+        sections.push_back(criticalSection);
+    }
+
+    if (newLocks.empty()) {
         return false;
     }
 
-    auto criticalSection = new CriticalSection(lock);
-    criticalSections_.emplace(lock->callInstruction(), criticalSection);
+    auto order = reversePostorder(newLocks);
+    std::unordered_map<Node *, size_t> orderIndex(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        orderIndex.emplace(order[i], i);
+    }
+
+    // the locks that may be held at the entry of the node,
+    // the worklist is ordered by the RPO index of the nodes
+    std::vector<SparseBitvector> heldLocks(order.size());
+    std::set<size_t> worklist;
+    for (auto lock : newLocks) {
+        worklist.insert(orderIndex[lock]);
+    }
 
-    currentLock = lock;
-    currentUnlocks = lock->correspondingUnlocks();
-    visitNode(lock);
-    bool changed = populateCriticalSection();
-    examined_.clear();
+    while (!worklist.empty()) {
+        size_t index = *worklist.begin();
+        worklist.erase(worklist.begin());
+
+        Node * node = order[index];
+        SparseBitvector out = heldLocks[index];
+
+        auto kill = kills.find(node);
+        if (kill != kills.end()) {
+            for (auto lockId : kill->second) {
+                out.unset(lockId);
+            }
+        }
+
+        auto lockId = lockIds.find(node);
+        if (lockId != lockIds.end()) {
+            out.set(lockId->second);
+        }
+
+        for (auto successor : *node) {
+            auto successorIndex = orderIndex[successor];
+            if (heldLocks[successorIndex].set(out)) {
+                worklist.insert(successorIndex);
+            }
+        }
+    }
+
+    bool changed = false;
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (auto lockId : heldLocks[i]) {
+            changed |= sections[lockId]->insertNode(order[i]);
+        }
+    }
     return changed;
 }
 
-bool CriticalSectionsBuilder::populateCriticalSection() {
-    return criticalSections_[currentLock->callInstruction()]->insertNodes(examined_);
+// Does the unlock release the lock? The lock is kept only if we know that
+// the unlock may release another mutex: all the mutexes are single objects
+// (so that the pointers tell their instances apart) and the unlock does not
+// release exactly the mutex of the lock. Otherwise the unlock releases
+// the lock as every corresponding unlock did before.
+bool CriticalSectionsBuilder::releases(const UnlockNode *unlock, const LockNode *lock) const {
+    auto lockCall = lock->callInstruction();
+    auto unlockCall = unlock->callInstruction();
+    if (lockCall->getNumArgOperands() < 1 || unlockCall->getNumArgOperands() < 1) {
+        return true;
+    }
+
+    auto lockMutex = pointsToAnalysis_->getPointsTo(lockCall->getArgOperand(0));
+    auto unlockMutex = pointsToAnalysis_->getPointsTo(unlockCall->getArgOperand(0));
+    if (!lockMutex || !unlockMutex) {
+        return true;
+    }
+
+    for (auto mutexes : {&lockMutex->pointsTo, &unlockMutex->pointsTo}) {
+        for (const auto & pointer : *mutexes) {
+            if (!pointer.isValid() || pointer.isInvalidated() ||
+                pointer.offset.isUnknown() || !isSingleInstance(pointer.target)) {
+                return true;
+            }
+        }
+    }
+
+    return lockMutex->pointsTo.size() == 1 && unlockMutex->pointsTo.size() == 1 &&
+           *lockMutex->pointsTo.begin() == *unlockMutex->pointsTo.begin();
+}
+
+// Does the allocation have at most one instance at any time?
+// That is a global or an allocation that is not in a loop
+// nor in a recursive function.
+bool CriticalSectionsBuilder::isSingleInstance(dg::analysis::pta::PSNode *target) const {
+    using namespace dg::analysis::pta;
+    auto alloc = PSNodeAlloc::get(target);
+    if (!alloc || alloc->isSummary()) {
+        return false;
+    }
+    if (alloc->isGlobal()) {
+        return true;
+    }
+
+    auto instruction = llvm::dyn_cast_or_null<llvm::Instruction>(target->getUserData<llvm::Value>());
+    if (!instruction) {
+        return false;
+    }
+    return !isInLoop(instruction->getParent()) &&
+           !isRecursive(instruction->getParent()->getParent());
+}
+
+bool CriticalSectionsBuilder::isInLoop(const llvm::BasicBlock *block) {
+    std::unordered_set<const llvm::BasicBlock *> visited;
+    std::vector<const llvm::BasicBlock *> queue(llvm::succ_begin(block), llvm::succ_end(block));
+    while (!queue.empty()) {
+        auto current = queue.back();
+        queue.pop_back();
+        if (current == block) {
+            return true;
+        }
+        if (visited.insert(current).second) {
+            queue.insert(queue.end(), llvm::succ_begin(current), llvm::succ_end(current));
+        }
+    }
+    return false;
+}
+
+bool CriticalSectionsBuilder::isRecursive(const llvm::Function *function) const {
+    auto iterator = recursiveFunctions_.find(function);
+    if (iterator != recursiveFunctions_.end()) {
+        return iterator->second;
+    }
+
+    bool recursive = false;
+    std::unordered_set<const llvm::Function *> visited;
+    std::vector<const llvm::Function *> queue{function};
+    while (!queue.empty() && !recursive) {
+        auto current = queue.back();
+        queue.pop_back();
+        for (auto & block : *current) {
+            for (auto & instruction : block) {
+                auto callInst = llvm::dyn_cast<llvm::CallInst>(&instruction);
+                if (!callInst) {
+                    continue;
+                }
+
+                std::vector<const llvm::Function *> callees;
+                if (auto callee = callInst->getCalledFunction()) {
+                    callees.push_back(callee);
+                } else {
+                    callees = pointsToAnalysis_->getPointsToFunctions(callInst->getCalledValue());
+                }
+
+                for (auto callee : callees) {
+                    if (callee == function) {
+                        recursive = true;
+                    } else if (!callee->isDeclaration() && visited.insert(callee).second) {
+                        queue.push_back(callee);
+                    }
+                }
+            }
+        }
+    }
+
+    recursiveFunctions_.emplace(function, recursive);
+    return recursive;
 }
 
-void CriticalSectionsBuilder::visitNode(Node *node) {
-    preVisit(node);
-    visit(node);
-    postVisit(node);
+std::vector<Node *> CriticalSectionsBuilder::reversePostorder(const std::vector<LockNode *> &locks) {
+    std::vector<Node *> postorder;
+    std::unordered_set<Node *> visited;
+    std::vector<std::pair<Node *, NodeIterator>> stack;
+
+    for (auto lock : locks) {
+        if (!visited.insert(lock).second) {
+            continue;
+        }
+        stack.emplace_back(lock, lock->begin());
+
+        while (!stack.empty()) {
+            auto & top = stack.back();
+            if (top.second == top.first->end()) {
+                postorder.push_back(top.first);
+                stack.pop_back();
+                continue;
+            }
+
+            Node * successor = *top.second;
+            ++top.second;
+            if (visited.insert(successor).second) {
+                stack.emplace_back(successor, successor->begin());
+            }
+        }
+    }
+
+    return std::vector<Node *>(postorder.rbegin(), postorder.rend());
 }
 
 std::set<const llvm::CallInst *> CriticalSectionsBuilder::locks() const {
@@ -65,15 +267,16 @@ std::set<const llvm::CallInst *> CriticalSectionsBuilder::locks() const {
     return llvmLocks;
 }
 
-std::set<const llvm::Instruction *> CriticalSectionsBuilder::correspondingNodes(const llvm::CallInst *lock) const {
+const std::set<const llvm::Instruction *> &CriticalSectionsBuilder::correspondingNodes(const llvm::CallInst *lock) const {
+    static const std::set<const llvm::Instruction *> empty;
     if (!lock) {
-        return {};
+        return empty;
     }
     auto iterator = criticalSections_.find(lock);
     if (iterator != criticalSections_.end()) {
         return iterator->second->nodes();
     }
-    return {};
+    return empty;
 }
 
 std::set<const llvm::CallInst *> CriticalSectionsBuilder::correspondingUnlocks(const llvm::CallInst *lock) const {
@@ -87,46 +290,6 @@ std::set<const llvm::CallInst *> CriticalSectionsBuilder::correspondingUnlocks(c
     return {};
 }
 
-void CriticalSectionsBuilder::preVisit(Node *node) {
-    visited_.insert(node);
-    if (auto unlockNode = castNode<NodeType::UNLOCK>(node)) {
-        currentUnlocks.erase(unlockNode);
-    }
-}
-
-void CriticalSectionsBuilder::visit(Node *node) {
-    if (currentUnlocks.empty()) {
-        return;
-    }
-
-    for (auto successor : *node) {
-        if (!visited(successor) && !examined(successor)) {
-            visitNode(successor);
-        }
-    }
-}
-
-void CriticalSectionsBuilder::postVisit(Node *node) {
-    visited_.erase(node);
-    examined_.insert(node);
-}
-
-bool CriticalSectionsBuilder::visited(Node *node) const {
-    auto iterator = visited_.find(node);
-    if (iterator != visited_.end()) {
-        return true;
-    }
-    return false;
-}
-
-bool CriticalSectionsBuilder::examined(Node *node) const {
-    auto iterator = examined_.find(node);
-    if (iterator != examined_.end()) {
-        return true;
-    }
-    return false;
-}
-
 CriticalSection::CriticalSection(LockNode *lock):lock_(lock)
 {}
 
@@ -134,14 +297,8 @@ const llvm::CallInst *CriticalSection::lock() const {
     return this->lock_->callInstruction();
 }
 
-std::set<const llvm::Instruction *> CriticalSection::nodes() const {
-    std::set<const llvm::Instruction *> llvmNodes;
-    for (auto node : nodes_) {
-        if (!node->isArtificial()) {
-            llvmNodes.insert(node->llvmInstruction());
-        }
-    }
-    return llvmNodes;
+const std::set<const llvm::Instruction *> & CriticalSection::nodes() const {
+    return nodes_;
 }
 
 std::set<const llvm::CallInst *> CriticalSection::unlocks() const {
@@ -152,10 +309,9 @@ std::set<const llvm::CallInst *> CriticalSection::unlocks() const {
     return llvmUnlocks;
 }
 
-bool CriticalSection::insertNodes(const std::set<Node *> &nodes) {
-    auto sizeBefore = this->nodes_.size();
-    this->nodes_.insert(nodes.begin(), nodes.end());
-    this->nodes_.erase(lock_);
-    auto sizeAfter = this->nodes_.size();
-    return sizeBefore < sizeAfter;
+bool CriticalSection::insertNode(Node *node) {
+    if (node == lock_ || node->isArtificial()) {
+        return false;
+    }
+    return this->nodes_.insert(node->llvmInstruction()).second;
 }
@@ -11,10 +11,16 @@
 #include <llvm/IR/Function.h>
 
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cassert>
 
 using namespace llvm;
 
-GraphBuilder::GraphBuilder(dg::LLVMPointerAnalysis *pointsToAnalysis):pointsToAnalysis_(pointsToAnalysis)
+GraphBuilder::GraphBuilder(dg::LLVMPointerAnalysis *pointsToAnalysis, unsigned workers)
+    :pointsToAnalysis_(pointsToAnalysis),
+     workers_(std::max(workers, 1u))
 {}
 
 GraphBuilder::~GraphBuilder() {
@@ -35,106 +41,92 @@ GraphBuilder::~GraphBuilder() {
     }
 }
 
-template <>
-ForkNode * GraphBuilder::addNode(ForkNode * node) {
-    llvmToForks_.emplace(node->callInstruction(), node);
-    if (node->isArtificial()) {
-        if (this->artificialNodes_.insert(node).second) {
-            return node;
-        }
-    } else {
-        if (this->llvmToNodeMap_.emplace(node->llvmInstruction(), node).second) {
-            return node;
-        }
+GraphBuilder::NodeSequence GraphBuilder::buildInstruction(const llvm::Instruction *instruction) {
+    if (!instruction) {
+        return {nullptr, nullptr};
     }
 
-    return nullptr;
-}
-
-template <>
-JoinNode * GraphBuilder::addNode(JoinNode * node) {
-    llvmToJoins_.emplace(node->callInstruction(), node);
-    if (node->isArtificial()) {
-        if (this->artificialNodes_.insert(node).second) {
-            return node;
-        }
-    } else {
-        if (this->llvmToNodeMap_.emplace(node->llvmInstruction(), node).second) {
-            return node;
-        }
+    auto inst = findInstruction(instruction);
+    if (inst) {
+        return {nullptr, nullptr};
     }
 
-    return nullptr;
+    FunctionBuilds builds;
+    builds.emplace_back(new FunctionBuild());
+    resolvePointsToFunctions(instruction);
+    auto sequence = buildInstruction(*builds.front(), instruction);
+    buildCalledFunctions(builds);
+    commit(builds);
+    return {sequence.first, resolveSequenceEnd(sequence.second)};
 }
 
-template <>
-LockNode * GraphBuilder::addNode(LockNode * node) {
-    llvmToLocks_.emplace(node->callInstruction(), node);
-    if (node->isArtificial()) {
-        if (this->artificialNodes_.insert(node).second) {
-            return node;
-        }
-    } else {
-        if (this->llvmToNodeMap_.emplace(node->llvmInstruction(), node).second) {
-            return node;
-        }
+GraphBuilder::NodeSequence GraphBuilder::buildBlock(const llvm::BasicBlock *basicBlock) {
+    if (!basicBlock) {
+        return {nullptr, nullptr};
     }
 
-    return nullptr;
-}
+    auto block = findBlock(basicBlock);
+    if (block) {
+        return {nullptr, nullptr};
+    }
 
-template <>
-UnlockNode * GraphBuilder::addNode(UnlockNode * node) {
-    llvmToUnlocks_.emplace(node->callInstruction(), node);
-    if (node->isArtificial()) {
-        if (this->artificialNodes_.insert(node).second) {
-            return node;
-        }
-    } else {
-        if (this->llvmToNodeMap_.emplace(node->llvmInstruction(), node).second) {
-            return node;
-        }
+    FunctionBuilds builds;
+    builds.emplace_back(new FunctionBuild());
+    for (auto & instruction : *basicBlock) {
+        resolvePointsToFunctions(&instruction);
     }
+    buildBlock(*builds.front(), basicBlock);
+    buildCalledFunctions(builds);
+    commit(builds);
 
-    return nullptr;
+    block = findBlock(basicBlock);
+    return {block->firstNode(), block->lastNode()};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildInstruction(const llvm::Instruction *instruction) {
-    if (!instruction) {
+GraphBuilder::NodeSequence GraphBuilder::buildFunction(const llvm::Function *function) {
+    if (!function) {
         return {nullptr, nullptr};
     }
 
-    auto inst = findInstruction(instruction);
-    if (inst) {
+    if (function->size() == 0) {
+        return {nullptr, nullptr};
+    }
+
+    auto functionGraph = findFunction(function);
+    if (functionGraph) {
         return {nullptr, nullptr};
     }
+
+    FunctionBuilds builds;
+    builds.emplace_back(new FunctionBuild(function));
+    buildFunctions(builds, 0);
+    buildCalledFunctions(builds);
+    commit(builds);
+
+    functionGraph = findFunction(function);
+    return {functionGraph->entryNode(), functionGraph->exitNode()};
+}
+
+GraphBuilder::NodeSequence GraphBuilder::buildInstruction(FunctionBuild &build, const llvm::Instruction *instruction) {
     NodeSequence sequence;
     switch (instruction->getOpcode()) {
     case Instruction::Call:
-        sequence = buildCallInstruction(instruction);
+        sequence = buildCallInstruction(build, instruction);
         break;
     case Instruction::Ret:
-        sequence = buildReturnInstruction(instruction);
+        sequence = buildReturnInstruction(build, instruction);
         break;
     default:
-        sequence = buildGeneralInstruction(instruction);
+        sequence = buildGeneralInstruction(build, instruction);
         break;
     }
     return sequence;
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildBlock(const llvm::BasicBlock *basicBlock) {
-    if (!basicBlock) {
-        return {nullptr, nullptr};
-    }
-
-    auto block = findBlock(basicBlock);
-    if (block) {
-        return {nullptr, nullptr};
-    }
+GraphBuilder::NodeSequence GraphBuilder::buildBlock(FunctionBuild &build, const llvm::BasicBlock *basicBlock) {
     std::vector<NodeSequence> builtInstructions;
     for (auto & instruction : *basicBlock) {
-        auto builtInstruction = buildInstruction(&instruction);
+        auto builtInstruction = buildInstruction(build, &instruction);
         builtInstructions.push_back(builtInstruction);
         if (builtInstruction.second->getType() == NodeType::RETURN)
             break;
@@ -151,55 +143,40 @@ GraphBuilder::NodeSequence GraphBuilder::buildBlock(const llvm::BasicBlock *basi
     Node * firstNode = builtInstructions.front().first;
     Node * lastNode = builtInstructions.back().second;
 
-    auto blockGraph = new BlockGraph(basicBlock, firstNode, lastNode);
-    this->llvmToBlockMap_.emplace(basicBlock, blockGraph);
+    build.blocks.emplace(basicBlock, NodeSequence(firstNode, lastNode));
 
     return  {firstNode, lastNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildFunction(const llvm::Function *function) {
-    if (!function) {
-        return {nullptr, nullptr};
-    }
-
-    if (function->size() == 0) {
-        return {nullptr, nullptr};
-    }
-
-    auto functionGraph = findFunction(function);
-    if (functionGraph) {
-        return {nullptr, nullptr};
-    }
+void GraphBuilder::buildFunction(FunctionBuild &build) {
+    auto function = build.function;
 
     //TODO refactor this into createFunctionGraph method
-    auto entryNode = addNode(createNode<NodeType::ENTRY>());
-    auto exitNode = addNode(createNode<NodeType::EXIT>());
-    functionGraph = new FunctionGraph(function, entryNode, exitNode);
-    this->llvmToFunctionMap_.emplace(function, functionGraph);
+    auto entryNode = addNode(build, createNode<NodeType::ENTRY>());
+    auto exitNode = addNode(build, createNode<NodeType::EXIT>());
+    build.graph = new FunctionGraph(function, entryNode, exitNode);
 
     for (auto & block : *function) {
         if (isReachable(&block)) {
-            buildBlock(&block);
+            buildBlock(build, &block);
         }
     }
 
     for (auto & block : *function) {
         if (isReachable(&block)) {
-            auto blockGraph = findBlock(&block);
+            auto & blockSequence = build.blocks[&block];
             if (predecessorsNumber(&block) == 0) {
-                functionGraph->entryNode()->addSuccessor(blockGraph->firstNode());
+                entryNode->addSuccessor(blockSequence.first);
             }
             if (successorsNumber(&block) == 0) {
-                blockGraph->lastNode()->addSuccessor(functionGraph->exitNode());
+                blockSequence.second->addSuccessor(exitNode);
             }
             for (auto it = succ_begin(&block); it != succ_end(&block); ++it) {
-                auto successorGraph = findBlock(*it);
-                blockGraph->lastNode()->addSuccessor(successorGraph->firstNode());
+                auto & successorSequence = build.blocks[*it];
+                blockSequence.second->addSuccessor(successorSequence.first);
             }
         }
     }
-
-    return {functionGraph->entryNode(), functionGraph->exitNode()};
 }
 
 Node *GraphBuilder::findInstruction(const llvm::Instruction *instruction) {
@@ -275,29 +252,83 @@ bool GraphBuilder::matchForksAndJoins() {
 
 bool GraphBuilder::matchLocksAndUnlocks() {
     using namespace dg::analysis::pta;
-    bool changed = false;
+
+    // Index the locks and unlocks by the memory objects their mutex
+    // may point to, so that we do not need to compare every lock with
+    // every unlock. Locks and unlocks of an unknown mutex go into
+    // a separate bucket that matches everything.
+    std::unordered_map<PSNode *, MutexBucket> buckets;
+    MutexBucket unknownMutex;
+
     for (auto lock : llvmToLocks_) {
-        auto lockMutexPtr = pointsToAnalysis_->getPointsTo(lock.first);
-        for (auto unlock : llvmToUnlocks_) {
-            auto unlockMutexPtr = pointsToAnalysis_->getPointsTo(unlock.first);
-
-            std::set<PSNode *> mutexPointerIntersection;
-            for (const auto lockPointsTo : lockMutexPtr->pointsTo) {
-                for (const auto unlockPointsTo : unlockMutexPtr->pointsTo) {
-                    if (lockPointsTo.target == unlockPointsTo.target) {
-                        mutexPointerIntersection.insert(lockPointsTo.target);
-                    }
-                }
+        std::set<PSNode *> targets;
+        if (getMutexTargets(lock.first, targets)) {
+            for (auto target : targets) {
+                buckets[target].locks.insert(lock.second);
             }
+        } else {
+            unknownMutex.locks.insert(lock.second);
+        }
+    }
 
-            if (!mutexPointerIntersection.empty()) {
-                changed |= lock.second->addCorrespondingUnlock(unlock.second);
+    for (auto unlock : llvmToUnlocks_) {
+        std::set<PSNode *> targets;
+        if (getMutexTargets(unlock.first, targets)) {
+            for (auto target : targets) {
+                buckets[target].unlocks.insert(unlock.second);
+            }
+        } else {
+            unknownMutex.unlocks.insert(unlock.second);
+        }
+    }
+
+    bool changed = false;
+    for (auto & bucket : buckets) {
+        for (auto lock : bucket.second.locks) {
+            for (auto unlock : bucket.second.unlocks) {
+                changed |= lock->addCorrespondingUnlock(unlock);
             }
         }
     }
+
+    for (auto lock : unknownMutex.locks) {
+        for (auto unlock : llvmToUnlocks_) {
+            changed |= lock->addCorrespondingUnlock(unlock.second);
+        }
+    }
+
+    for (auto unlock : unknownMutex.unlocks) {
+        for (auto lock : llvmToLocks_) {
+            changed |= lock.second->addCorrespondingUnlock(unlock);
+        }
+    }
+
     return changed;
 }
 
+bool GraphBuilder::getMutexTargets(const llvm::CallInst *callInst,
+                                   std::set<dg::analysis::pta::PSNode *> &targets) const {
+    using namespace dg::analysis::pta;
+    if (callInst->getNumArgOperands() < 1) {
+        return false;
+    }
+
+    auto mutexPtr = pointsToAnalysis_->getPointsTo(callInst->getArgOperand(0));
+    if (!mutexPtr) {
+        return false;
+    }
+
+    for (const auto & pointsTo : mutexPtr->pointsTo) {
+        if (pointsTo.isUnknown()) {
+            return false;
+        }
+        if (pointsTo.isValid() && !pointsTo.isInvalidated()) {
+            targets.insert(pointsTo.target);
+        }
+    }
+    return true;
+}
+
 void GraphBuilder::print(std::ostream &ostream) const {
     ostream << "digraph \"Control Flow Graph\" {\n";
     ostream << "compound = true\n";
@@ -349,106 +380,106 @@ void GraphBuilder::clear() {
     llvmToForks_.clear();
     llvmToLocks_.clear();
     llvmToUnlocks_.clear();
+    pointsToFunctions_.clear();
+    calledFunctions_.clear();
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildGeneralInstruction(const Instruction *instruction) {
-    auto currentNode = addNode(createNode<NodeType::GENERAL>(instruction));
+GraphBuilder::NodeSequence GraphBuilder::buildGeneralInstruction(FunctionBuild &build, const Instruction *instruction) {
+    auto currentNode = addNode(build, createNode<NodeType::GENERAL>(instruction));
     return {currentNode, currentNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildGeneralCallInstruction(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::buildGeneralCallInstruction(FunctionBuild &build, const CallInst *callInstruction) {
     CallNode * callNode;
     if (callInstruction->getCalledFunction()) {
-        callNode = addNode(createNode<NodeType::CALL>(callInstruction));
+        callNode = addNode(build, createNode<NodeType::CALL>(callInstruction));
     } else {
-        callNode = addNode(createNode<NodeType::CALL>(nullptr, callInstruction));
+        callNode = addNode(build, createNode<NodeType::CALL>(nullptr, callInstruction));
     }
     return {callNode, callNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertUndefinedFunction(const Function *function, const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertUndefinedFunction(FunctionBuild &build, const Function *function, const CallInst *callInstruction) {
     std::string funcName = function->getName();
 
     if (funcName == "pthread_create") {
-        return insertPthreadCreate(callInstruction);
+        return insertPthreadCreate(build, callInstruction);
     } else if (funcName == "pthread_join") {
-        return insertPthreadJoin(callInstruction);
+        return insertPthreadJoin(build, callInstruction);
     } else if (funcName == "pthread_exit") {
-        return insertPthreadExit(callInstruction);
+        return insertPthreadExit(build, callInstruction);
     } else if (funcName == "pthread_mutex_lock") {
-        return insertPthreadMutexLock(callInstruction);
+        return insertPthreadMutexLock(build, callInstruction);
     } else if (funcName == "pthread_mutex_unlock") {
-        return insertPthreadMutexUnlock(callInstruction);
+        return insertPthreadMutexUnlock(build, callInstruction);
     } else {
-        return buildGeneralCallInstruction(callInstruction);
+        return buildGeneralCallInstruction(build, callInstruction);
     }
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertPthreadCreate(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertPthreadCreate(FunctionBuild &build, const CallInst *callInstruction) {
     ForkNode * forkNode;
     if (callInstruction->getCalledFunction()) {
-        forkNode = addNode(createNode<NodeType::FORK>(callInstruction));
+        forkNode = addNode(build, createNode<NodeType::FORK>(callInstruction));
     } else {
-        forkNode = addNode(createNode<NodeType::FORK>(nullptr, callInstruction));
+        forkNode = addNode(build, createNode<NodeType::FORK>(nullptr, callInstruction));
     }
     auto possibleFunction = callInstruction->getArgOperand(2);
-    auto functionsToBeForked = pointsToAnalysis_->getPointsToFunctions(possibleFunction);
-    for (auto function : functionsToBeForked) {
-        auto graph = createOrGetFunction(function);
-        if (graph.first) {
-            forkNode->addForkSuccessor(static_cast<EntryNode *>(graph.first));
+    for (auto function : pointsToFunctions(possibleFunction)) {
+        if (function->size() > 0) {
+            build.calls.push_back({forkNode, function, true});
         }
     }
     return {forkNode, forkNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertPthreadMutexLock(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertPthreadMutexLock(FunctionBuild &build, const CallInst *callInstruction) {
     LockNode * lockNode;
     if (callInstruction->getCalledFunction()) {
-        lockNode = addNode(createNode<NodeType::LOCK>(callInstruction));
+        lockNode = addNode(build, createNode<NodeType::LOCK>(callInstruction));
     } else {
-        lockNode = addNode(createNode<NodeType::LOCK>(nullptr, callInstruction));
+        lockNode = addNode(build, createNode<NodeType::LOCK>(nullptr, callInstruction));
     }
 
     return {lockNode, lockNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertPthreadMutexUnlock(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertPthreadMutexUnlock(FunctionBuild &build, const CallInst *callInstruction) {
     UnlockNode * unlockNode;
     if (callInstruction->getCalledFunction()) {
-        unlockNode = addNode(createNode<NodeType::UNLOCK>(callInstruction));
+        unlockNode = addNode(build, createNode<NodeType::UNLOCK>(callInstruction));
     } else {
-        unlockNode = addNode(createNode<NodeType::UNLOCK>(nullptr, callInstruction));
+        unlockNode = addNode(build, createNode<NodeType::UNLOCK>(nullptr, callInstruction));
     }
 
     return {unlockNode, unlockNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertPthreadJoin(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertPthreadJoin(FunctionBuild &build, const CallInst *callInstruction) {
     JoinNode * joinNode;
     if (callInstruction->getCalledFunction()) {
-        joinNode = addNode(createNode<NodeType::JOIN>(callInstruction));
+        joinNode = addNode(build, createNode<NodeType::JOIN>(callInstruction));
     } else {
-        joinNode = addNode(createNode<NodeType::JOIN>(nullptr, callInstruction));
+        joinNode = addNode(build, createNode<NodeType::JOIN>(nullptr, callInstruction));
     }
     return  {joinNode, joinNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertPthreadExit(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertPthreadExit(FunctionBuild &build, const CallInst *callInstruction) {
     CallNode * callNode;
     if (callInstruction->getCalledFunction()) {
-        callNode = addNode(createNode<NodeType::CALL>(callInstruction));
+        callNode = addNode(build, createNode<NodeType::CALL>(callInstruction));
     } else {
-        callNode = addNode(createNode<NodeType::CALL>(nullptr, callInstruction));
+        callNode = addNode(build, createNode<NodeType::CALL>(nullptr, callInstruction));
     }
-    auto returnNode = addNode(createNode<NodeType::RETURN>());
+    auto returnNode = addNode(build, createNode<NodeType::RETURN>());
     callNode->addSuccessor(returnNode);
     return {callNode, returnNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertFunction(const Function *function, const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertFunction(FunctionBuild &build, const Function *function, const CallInst *callInstruction) {
     if (function->size() == 0) {
-        return insertUndefinedFunction(function, callInstruction);
+        return insertUndefinedFunction(build, function, callInstruction);
     } else {
         Node * callNode;
         if (callInstruction->getCalledFunction()) {
@@ -456,63 +487,251 @@ GraphBuilder::NodeSequence GraphBuilder::insertFunction(const Function *function
         } else {
             callNode = createNode<NodeType::CALL>(nullptr, callInstruction);
         }
-        addNode(callNode);
-        auto nodeSeq = createOrGetFunction(function);
-        callNode->addSuccessor(nodeSeq.first);
-        return {callNode, nodeSeq.second};
+        addNode(build, callNode);
+        // the called function is connected in commit(),
+        // until then the call node stands also for its exit
+        build.calls.push_back({callNode, function, false});
+        return {callNode, callNode};
     }
 }
 
-GraphBuilder::NodeSequence GraphBuilder::insertFunctionPointerCall(const CallInst *callInstruction) {
+GraphBuilder::NodeSequence GraphBuilder::insertFunctionPointerCall(FunctionBuild &build, const CallInst *callInstruction) {
     auto calledValue = callInstruction->getCalledValue();
-    auto functions = pointsToAnalysis_->getPointsToFunctions(calledValue);
+    const auto & functions = pointsToFunctions(calledValue);
 
-    auto callFuncPtrNode = addNode(createNode<NodeType::CALL_FUNCPTR>(callInstruction));
+    auto callFuncPtrNode = addNode(build, createNode<NodeType::CALL_FUNCPTR>(callInstruction));
     Node * returnNode;
 
     if (functions.size() > 1) {
-        returnNode = addNode(createNode<NodeType::CALL_RETURN>());
+        returnNode = addNode(build, createNode<NodeType::CALL_RETURN>());
         for (auto function : functions) {
-            auto nodeSeq = insertFunction(function, callInstruction);
+            auto nodeSeq = insertFunction(build, function, callInstruction);
             callFuncPtrNode->addSuccessor(nodeSeq.first);
             nodeSeq.second->addSuccessor(returnNode);
         }
     } else if (functions.size() == 1) {
-        auto nodeSeq = insertFunction(functions.front(), callInstruction);
+        auto nodeSeq = insertFunction(build, functions.front(), callInstruction);
         callFuncPtrNode->addSuccessor(nodeSeq.first);
         returnNode = nodeSeq.second;
     } else {
-        auto nodeSeq = buildGeneralCallInstruction(callInstruction);
+        auto nodeSeq = buildGeneralCallInstruction(build, callInstruction);
         callFuncPtrNode->addSuccessor(nodeSeq.first);
         returnNode = nodeSeq.second;
     }
     return {callFuncPtrNode, returnNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildCallInstruction(const Instruction *instruction) {
+GraphBuilder::NodeSequence GraphBuilder::buildCallInstruction(FunctionBuild &build, const Instruction *instruction) {
     auto callInst = dyn_cast<CallInst>(instruction);
     if (callInst->isInlineAsm()) {
-        return buildGeneralInstruction(instruction);
+        return buildGeneralInstruction(build, instruction);
     }
 
     if (callInst->getCalledFunction()) {
-        return insertFunction(callInst->getCalledFunction(), callInst);
+        return insertFunction(build, callInst->getCalledFunction(), callInst);
     } else {
-        return insertFunctionPointerCall(callInst);
+        return insertFunctionPointerCall(build, callInst);
     }
 }
 
-GraphBuilder::NodeSequence GraphBuilder::buildReturnInstruction(const Instruction *instruction) {
-    auto currentNode = addNode(createNode<NodeType::RETURN>(instruction));
+GraphBuilder::NodeSequence GraphBuilder::buildReturnInstruction(FunctionBuild &build, const Instruction *instruction) {
+    auto currentNode = addNode(build, createNode<NodeType::RETURN>(instruction));
     return {currentNode, currentNode};
 }
 
-GraphBuilder::NodeSequence GraphBuilder::createOrGetFunction(const Function *function) {
-    auto functionGraph = findFunction(function);
-    if (functionGraph) {
-        return {functionGraph->entryNode(), functionGraph->exitNode()};
+void GraphBuilder::resolvePointsToFunctions(const Instruction *instruction) {
+    auto callInst = dyn_cast<CallInst>(instruction);
+    if (!callInst || callInst->isInlineAsm()) {
+        return;
+    }
+
+    std::vector<const Function *> calledFunctions;
+    if (callInst->getCalledFunction()) {
+        calledFunctions.push_back(callInst->getCalledFunction());
+    } else {
+        calledFunctions = resolvePointsToFunctions(callInst->getCalledValue());
+    }
+
+    for (auto function : calledFunctions) {
+        if (function->size() == 0 && function->getName() == "pthread_create") {
+            resolvePointsToFunctions(callInst->getArgOperand(2));
+        }
+    }
+}
+
+const std::vector<const Function *> & GraphBuilder::resolvePointsToFunctions(const Value *value) {
+    auto iterator = pointsToFunctions_.find(value);
+    if (iterator == pointsToFunctions_.end()) {
+        iterator = pointsToFunctions_.emplace(value,
+                       pointsToAnalysis_->getPointsToFunctions(value)).first;
+    }
+    return iterator->second;
+}
+
+const std::vector<const Function *> & GraphBuilder::pointsToFunctions(const Value *value) const {
+    auto iterator = pointsToFunctions_.find(value);
+    assert(iterator != pointsToFunctions_.end() && "Did not query the pointer analysis");
+    return iterator->second;
+}
+
+// Build the graphs of builds[first], builds[first + 1], ...
+// The graphs are independent, so use more threads if we have them.
+void GraphBuilder::buildFunctions(FunctionBuilds &builds, std::size_t first) {
+    for (auto i = first; i < builds.size(); ++i) {
+        for (auto & block : *builds[i]->function) {
+            if (isReachable(&block)) {
+                for (auto & instruction : block) {
+                    resolvePointsToFunctions(&instruction);
+                }
+            }
+        }
+    }
+
+    std::atomic<std::size_t> next{first};
+    auto worker = [this, &builds, &next]() {
+        for (auto i = next++; i < builds.size(); i = next++) {
+            buildFunction(*builds[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    auto threadsNumber = std::min<std::size_t>(workers_, builds.size() - first);
+    for (std::size_t i = 1; i < threadsNumber; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto & thread : threads) {
+        thread.join();
+    }
+}
+
+// Build the functions called from the builds that are not built yet,
+// repeat for the functions called from these functions, and so on.
+void GraphBuilder::buildCalledFunctions(FunctionBuilds &builds) {
+    std::unordered_set<const Function *> scheduled;
+    for (auto & build : builds) {
+        scheduled.insert(build->function);
+    }
+
+    std::size_t scanned = 0;
+    while (scanned < builds.size()) {
+        auto first = builds.size();
+        for (; scanned < first; ++scanned) {
+            for (auto & call : builds[scanned]->calls) {
+                if (!findFunction(call.function) &&
+                    scheduled.insert(call.function).second) {
+                    builds.emplace_back(new FunctionBuild(call.function));
+                }
+            }
+        }
+
+        if (first < builds.size()) {
+            buildFunctions(builds, first);
+        }
+    }
+}
+
+// Give the nodes ids in the same order as if the functions were built
+// one by one when the calls are found, i.e. the nodes of a called
+// function get ids right after the node of the first call.
+void GraphBuilder::renumberNodes(FunctionBuilds &builds, std::size_t index,
+                                 std::unordered_map<const Function *, std::size_t> &functions,
+                                 std::unordered_set<const Function *> &visited,
+                                 int &id) {
+    auto & build = *builds[index];
+    if (build.function) {
+        visited.insert(build.function);
+    }
+
+    auto call = build.calls.begin();
+    for (auto node : build.nodes) {
+        node->id_ = id++;
+        for (; call != build.calls.end() && call->node == node; ++call) {
+            auto iterator = functions.find(call->function);
+            if (iterator != functions.end() &&
+                visited.find(call->function) == visited.end()) {
+                renumberNodes(builds, iterator->second, functions, visited, id);
+            }
+        }
+    }
+}
+
+// Sequential part of the building - renumber the nodes, connect
+// the calls and forks with the called functions and register everything
+void GraphBuilder::commit(FunctionBuilds &builds) {
+    std::size_t nodesNumber = 0;
+    std::unordered_map<const Function *, std::size_t> functions;
+    for (std::size_t i = 0; i < builds.size(); ++i) {
+        auto & build = *builds[i];
+        nodesNumber += build.nodes.size();
+        if (build.function) {
+            functions.emplace(build.function, i);
+            llvmToFunctionMap_.emplace(build.function, build.graph);
+        }
+    }
+
+    std::unordered_set<const Function *> visited;
+    int id = Node::lastId.fetch_add(static_cast<int>(nodesNumber));
+    renumberNodes(builds, 0, functions, visited, id);
+
+    for (auto & build : builds) {
+        for (auto & call : build->calls) {
+            auto functionGraph = findFunction(call.function);
+            assert(functionGraph && "Did not build the called function");
+            if (call.fork) {
+                castNode<NodeType::FORK>(call.node)->addForkSuccessor(functionGraph->entryNode());
+                continue;
+            }
+
+            // move the successors of the call to the exit of the function
+            auto successors = call.node->successors();
+            for (auto successor : successors) {
+                call.node->removeSuccessor(successor);
+                functionGraph->exitNode()->addSuccessor(successor);
+            }
+            call.node->addSuccessor(functionGraph->entryNode());
+            calledFunctions_.emplace(call.node, functionGraph);
+        }
+    }
+
+    for (auto & build : builds) {
+        for (auto node : build->nodes) {
+            registerNode(node);
+        }
+        for (auto & block : build->blocks) {
+            auto blockGraph = new BlockGraph(block.first, block.second.first,
+                                             resolveSequenceEnd(block.second.second));
+            llvmToBlockMap_.emplace(block.first, blockGraph);
+        }
+    }
+}
+
+void GraphBuilder::registerNode(Node *node) {
+    if (auto fork = castNode<NodeType::FORK>(node)) {
+        llvmToForks_.emplace(fork->callInstruction(), fork);
+    } else if (auto join = castNode<NodeType::JOIN>(node)) {
+        llvmToJoins_.emplace(join->callInstruction(), join);
+    } else if (auto lock = castNode<NodeType::LOCK>(node)) {
+        llvmToLocks_.emplace(lock->callInstruction(), lock);
+    } else if (auto unlock = castNode<NodeType::UNLOCK>(node)) {
+        llvmToUnlocks_.emplace(unlock->callInstruction(), unlock);
+    }
+
+    if (node->isArtificial()) {
+        artificialNodes_.insert(node);
+    } else {
+        llvmToNodeMap_.emplace(node->llvmInstruction(), node);
+    }
+}
+
+// a sequence of nodes that ends with a call of a defined
+// function really ends with the exit of the function
+Node *GraphBuilder::resolveSequenceEnd(Node *node) const {
+    auto iterator = calledFunctions_.find(node);
+    if (iterator == calledFunctions_.end()) {
+        return node;
     }
-    return buildFunction(function);
+    return iterator->second->exitNode();
 }
 
 bool GraphBuilder::populateCorrespondingForks(JoinNode *join, dg::analysis::pta::PSNodeJoin *PSJoin) {
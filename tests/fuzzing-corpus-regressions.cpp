@@ -0,0 +1,33 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+// Replay the inputs (e.g., from tests/fuzzing/corpus)
+// given on the command line on a fuzzing target
+void runOnInput(const std::string& file) {
+    std::ifstream input(file, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Failed opening " << file << "\n";
+        abort();
+    }
+
+    std::vector<unsigned char> data(
+        (std::istreambuf_iterator<char>(input)),
+        std::istreambuf_iterator<char>());
+
+    input.close();
+
+    std::cout << "Running " << file << "\n";
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i)
+        runOnInput(argv[i]);
+}
@@ -0,0 +1,60 @@
+#ifndef _DG_FUZZING_PERF_BUDGET_H_
+#define _DG_FUZZING_PERF_BUDGET_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// The number of operations (processed nodes, unions of sets, ...)
+// that an analysis may perform per one byte of the input.
+// The budget grows linearly with the size of the input
+// (which is bounded by -max_len), so an input on which the analysis
+// performs super-linear amount of work is reported as a crash.
+#ifndef OPS_PER_BYTE
+#define OPS_PER_BYTE 128
+#endif
+
+namespace dg {
+namespace fuzzing {
+
+class PerfBudget {
+    const char *name;
+    uint64_t budget;
+    uint64_t ops{0};
+
+public:
+    PerfBudget(const char *n, size_t inputSize)
+    : name(n), budget(OPS_PER_BYTE * (static_cast<uint64_t>(inputSize) + 1)) {}
+
+    void add(uint64_t num = 1) {
+        ops += num;
+        if (ops > budget) {
+            fprintf(stderr, "%s: performed %lu operations, "
+                            "the budget is %lu\n", name,
+                    static_cast<unsigned long>(ops),
+                    static_cast<unsigned long>(budget));
+            abort();
+        }
+    }
+
+    uint64_t getOps() const { return ops; }
+};
+
+// Simple reader of the fuzzer's bytes. When we are out of data,
+// return zeros, so that every input is a valid input.
+class InputReader {
+    const uint8_t *data;
+    size_t size;
+    size_t pos{0};
+
+public:
+    InputReader(const uint8_t *d, size_t s) : data(d), size(s) {}
+
+    bool atEnd() const { return pos >= size; }
+    uint8_t get() { return atEnd() ? 0 : data[pos++]; }
+};
+
+} // namespace fuzzing
+} // namespace dg
+
+#endif // _DG_FUZZING_PERF_BUDGET_H_
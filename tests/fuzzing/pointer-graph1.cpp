@@ -0,0 +1,125 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "dg/analysis/PointsTo/PointerGraph.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+
+#include "perf-budget.h"
+
+using namespace dg::analysis::pta;
+using dg::analysis::Offset;
+using dg::fuzzing::PerfBudget;
+using dg::fuzzing::InputReader;
+
+// Pointer analysis that counts the processed nodes
+// and the points-to sets that it merges into the nodes
+template <typename PTAType>
+class CountingPTA : public PTAType {
+    PerfBudget& budget;
+
+public:
+    CountingPTA(PointerGraph *PS, PerfBudget& b)
+    : PTAType(PS), budget(b) {}
+
+    bool iteration() override {
+        for (PSNode *n : this->to_process)
+            budget.add(1 + n->getOperandsNum());
+        return PTAType::iteration();
+    }
+
+    void enqueue(PSNode *n) override {
+        budget.add();
+        PTAType::enqueue(n);
+    }
+};
+
+// Build a pointer graph from the input. Every node is described
+// by at least three bytes: the type and two operands (indices
+// of already created nodes). If the highest bit of the type is set,
+// one more byte follows that says to which node should the new node
+// have an edge (creating a loop).
+static void buildGraph(PointerGraph& PS, InputReader& input)
+{
+    std::vector<PSNode *> nodes;
+
+    PSNode *root = PS.create(PSNodeType::ALLOC);
+    nodes.push_back(root);
+
+    auto operand = [&nodes](uint8_t b) { return nodes[b % nodes.size()]; };
+
+    while (!input.atEnd()) {
+        uint8_t type = input.get();
+        uint8_t op1 = input.get();
+        uint8_t op2 = input.get();
+
+        PSNode *node = nullptr;
+        switch (type % 8) {
+            case 0:
+                node = PS.create(PSNodeType::ALLOC);
+                node->setSize(op1);
+                break;
+            case 1:
+                node = PS.create(PSNodeType::GEP, operand(op1),
+                                 op2 == 0xff ? Offset::UNKNOWN
+                                             : static_cast<Offset::type>(op2 % 32));
+                break;
+            case 2:
+                node = PS.create(PSNodeType::LOAD, operand(op1));
+                break;
+            case 3:
+                node = PS.create(PSNodeType::STORE, operand(op1), operand(op2));
+                break;
+            case 4:
+                node = PS.create(PSNodeType::CAST, operand(op1));
+                break;
+            case 5:
+                node = PS.create(PSNodeType::PHI, operand(op1), operand(op2),
+                                 nullptr);
+                break;
+            case 6:
+                node = PS.create(PSNodeType::MEMCPY, operand(op1), operand(op2),
+                                 static_cast<Offset::type>(1 + ((type >> 3) & 0xf)));
+                break;
+            default:
+                node = PS.create(PSNodeType::NOOP);
+        }
+
+        nodes.back()->addSuccessor(node);
+        nodes.push_back(node);
+
+        // never create an edge to the root, it must stay the entry node
+        if ((type & 0x80) && nodes.size() > 2) {
+            uint8_t target = input.get();
+            node->addSuccessor(nodes[1 + target % (nodes.size() - 2)]);
+        }
+    }
+
+    auto subg = PS.createSubgraph(root);
+    PS.setEntry(subg);
+    for (PSNode *n : nodes)
+        n->setParent(subg);
+}
+
+template <typename PTAType>
+static void runPTA(const char *name, const uint8_t *data, size_t size)
+{
+    PerfBudget budget(name, size);
+    InputReader input(data, size);
+    PointerGraph PS;
+    buildGraph(PS, input);
+
+    CountingPTA<PTAType> PTA(&PS, budget);
+    PTA.run();
+}
+
+extern "C"
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    runPTA<PointerAnalysisFI>("FI pointer analysis", data, size);
+    runPTA<PointerAnalysisFS>("FS pointer analysis", data, size);
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
+
+#include "perf-budget.h"
+
+using namespace dg::analysis::rd;
+using dg::analysis::Offset;
+using dg::fuzzing::PerfBudget;
+using dg::fuzzing::InputReader;
+
+// Build a reaching definitions graph from the input. Every node
+// is described by at least three bytes: the type, the target memory
+// (index of already created allocation, 0xff is unknown memory)
+// and the offset and length of the accessed memory (0xff is unknown).
+// If the highest bit of the type is set, one more byte follows that says
+// to which node should the new node have an edge (creating a loop).
+static ReachingDefinitionsGraph buildGraph(InputReader& input,
+                                           std::vector<RDNode *>& uses)
+{
+    ReachingDefinitionsGraph graph;
+    std::vector<RDNode *> nodes;
+    std::vector<RDNode *> allocs;
+
+    RDNode *root = graph.create(RDNodeType::ALLOC);
+    nodes.push_back(root);
+    allocs.push_back(root);
+
+    while (!input.atEnd()) {
+        uint8_t type = input.get();
+        uint8_t target = input.get();
+        uint8_t range = input.get();
+
+        RDNode *mem = target == 0xff ? UNKNOWN_MEMORY
+                                     : allocs[target % allocs.size()];
+        Offset off = range == 0xff ? Offset::UNKNOWN : Offset(range & 0x1f);
+        Offset len = range == 0xff ? Offset::UNKNOWN : Offset(1 + (range >> 5));
+
+        RDNode *node = nullptr;
+        switch (type % 4) {
+            case 0:
+                node = graph.create(RDNodeType::ALLOC);
+                allocs.push_back(node);
+                break;
+            case 1:
+                node = graph.create(RDNodeType::STORE);
+                // strong update only on known memory
+                node->addDef(mem, off, len,
+                             (type & 0x40) && !mem->isUnknown() &&
+                             !off.isUnknown());
+                break;
+            case 2:
+                node = graph.create(RDNodeType::LOAD);
+                node->addUse(mem, off, len);
+                uses.push_back(node);
+                break;
+            default:
+                node = graph.create(RDNodeType::NOOP);
+        }
+
+        nodes.back()->addSuccessor(node);
+        nodes.push_back(node);
+
+        if ((type & 0x80) && nodes.size() > 2) {
+            uint8_t succ = input.get();
+            node->addSuccessor(nodes[1 + succ % (nodes.size() - 2)]);
+        }
+    }
+
+    graph.setRoot(root);
+    return graph;
+}
+
+extern "C"
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    {
+        PerfBudget budget("data-flow RD", size);
+        InputReader input(data, size);
+        std::vector<RDNode *> uses;
+        ReachingDefinitionsAnalysis RD(buildGraph(input, uses));
+        RD.run();
+
+        // the processed nodes and the maps merged into them
+        budget.add(RD.getProcessedNodesNum() + RD.getMergedMapsNum());
+
+        for (RDNode *use : uses)
+            budget.add(RD.getReachingDefinitions(use).size());
+    }
+
+    {
+        PerfBudget budget("SSA RD", size);
+        InputReader input(data, size);
+        std::vector<RDNode *> uses;
+        SSAReachingDefinitionsAnalysis RD(buildGraph(input, uses));
+        size_t nodesNum = RD.getGraph()->size();
+        RD.run();
+
+        // count the phi nodes created by the analysis
+        // and the size of the results
+        budget.add(RD.getGraph()->size() - nodesNum);
+        nodesNum = RD.getGraph()->size();
+        for (RDNode *use : uses)
+            budget.add(RD.getReachingDefinitions(use).size());
+        budget.add(RD.getGraph()->size() - nodesNum);
+    }
+
+    return 0;
+}
@@ -1,15 +1,89 @@
 #include <assert.h>
 #include <cstdarg>
 #include <cstdio>
+#include <sstream>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Verifier.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
 
 #include "dg/llvm/LLVMDependenceGraph.h"
+#include "dg/llvm/LLVMDependenceGraphBuilder.h"
+#include "dg/llvm/LLVMSlicer.h"
+#include "dg/llvm/analysis/ExecutionCoverage.h"
+#include "dg/llvm/analysis/ImmutableGlobals.h"
+#include "dg/llvm/analysis/PromotableAllocas.h"
+#include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
+#if LLVM_VERSION_MAJOR >= 4
+#include "dg/llvm/analysis/PointsTo/LLVMAliasAnalysis.h"
+#endif
+#include "dg/llvm/analysis/ReachingDefinitions/ReachingDefinitions.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/DFS.h"
 #include "test-runner.h"
 
+// not a public header
+#include "llvm/analysis/Dominators/PostDominators.h"
+
 
 namespace dg {
 namespace tests {
 
+static llvm::LoadInst *createLoad(llvm::Type *Ty, llvm::Value *ptr,
+                                  llvm::BasicBlock *B)
+{
+#if LLVM_VERSION_MAJOR < 8
+    (void) Ty;
+    return new llvm::LoadInst(ptr, "", B);
+#else
+    return new llvm::LoadInst(Ty, ptr, "", B);
+#endif
+}
+
+// a pointer to the first element of the global array
+static llvm::Constant *firstElement(llvm::GlobalVariable *G)
+{
+    using namespace llvm;
+    Type *i64 = Type::getInt64Ty(G->getContext());
+    Constant *idx[] = {ConstantInt::get(i64, 0), ConstantInt::get(i64, 0)};
+    return ConstantExpr::getGetElementPtr(G->getValueType(), G, idx);
+}
+
+static llvm::GlobalVariable *createString(llvm::Module& M, const char *name)
+{
+    using namespace llvm;
+    Constant *str = ConstantDataArray::getString(M.getContext(), name);
+    return new GlobalVariable(M, str->getType(), true /* constant */,
+                              GlobalValue::PrivateLinkage, str, name);
+}
+
+static llvm::Function *createFunction(llvm::Module& M, const char *name,
+                                      llvm::FunctionType *Ty)
+{
+    using namespace llvm;
+    return Function::Create(Ty, GlobalValue::ExternalLinkage, name, &M);
+}
+
 struct TestRefcount : public Test
 {
     TestRefcount() : Test("reference counting test") {}
@@ -55,6 +129,1536 @@ struct TestRefcount : public Test
     }
 };
 
+struct TestConstantExprs : public Test
+{
+    TestConstantExprs() : Test("nested constant expressions test") {}
+
+    void test()
+    {
+        using namespace llvm;
+        using namespace dg::analysis::pta;
+
+        LLVMContext ctx;
+        Module M("constexprs", ctx);
+
+        Type *i8 = Type::getInt8Ty(ctx);
+        Type *i64 = Type::getInt64Ty(ctx);
+        Type *i8ptr = Type::getInt8PtrTy(ctx);
+        ArrayType *Ty = ArrayType::get(i8, 1024);
+        GlobalVariable *G
+            = new GlobalVariable(M, Ty, false, GlobalValue::ExternalLinkage,
+                                 ConstantAggregateZero::get(Ty), "g");
+
+        // p = gep(inttoptr(ptrtoint(p) + 4), 2) nested 'depth' times,
+        // so p points to g + 6*depth
+        const unsigned depth = 200;
+        Constant *p = ConstantExpr::getBitCast(G, i8ptr);
+        for (unsigned i = 0; i < depth; ++i) {
+            Constant *add = ConstantExpr::getAdd(ConstantExpr::getPtrToInt(p, i64),
+                                                 ConstantInt::get(i64, 4));
+            p = ConstantExpr::getIntToPtr(add, i8ptr);
+            p = ConstantExpr::getGetElementPtr(i8, p, ConstantInt::get(i64, 2));
+        }
+
+        // use the expression twice in main()
+        Function *F = Function::Create(FunctionType::get(Type::getVoidTy(ctx), false),
+                                       GlobalValue::ExternalLinkage, "main", &M);
+        BasicBlock *B = BasicBlock::Create(ctx, "entry", F);
+        new StoreInst(ConstantInt::get(i8, 0), p, B);
+        new StoreInst(ConstantInt::get(i8, 1), p, B);
+        ReturnInst::Create(ctx, B);
+
+        LLVMPointerAnalysis PTA(&M);
+        PTA.run<PointerAnalysisFI>();
+
+        PSNode *gnode = PTA.getPointsTo(G);
+        PSNode *pnode = PTA.getPointsTo(p);
+        check(gnode && pnode, "do not have the nodes");
+        check(pnode == PTA.getPointsTo(p), "the expression has more nodes");
+        check(pnode->pointsTo.size() == 1, "p points to more than one pointer");
+        check(pnode->doesPointsTo(gnode, 6*depth),
+              "p does not point to g + %u", 6*depth);
+    }
+};
+
+struct TestImmutableGlobals : public Test
+{
+    TestImmutableGlobals() : Test("immutable globals test") {}
+
+    void test()
+    {
+        using namespace llvm;
+
+        LLVMContext ctx;
+        Module M("immutable", ctx);
+
+        Type *voidTy = Type::getVoidTy(ctx);
+        Type *i8 = Type::getInt8Ty(ctx);
+        Type *i32 = Type::getInt32Ty(ctx);
+        Type *i8ptr = Type::getInt8PtrTy(ctx);
+        Type *i32ptr = Type::getInt32PtrTy(ctx);
+
+        GlobalVariable *sink
+            = new GlobalVariable(M, i8ptr, false, GlobalValue::ExternalLinkage,
+                                 ConstantPointerNull::get(cast<PointerType>(i8ptr)),
+                                 "sink");
+
+        // read and passed to an undefined function
+        GlobalVariable *str = createString(M, "str");
+        // the address is stored to memory
+        GlobalVariable *stored = createString(M, "stored");
+        // read and stored through a chain of constant expressions
+        GlobalVariable *chain = createString(M, "chain");
+        GlobalVariable *chainStored = createString(M, "chainStored");
+        // the address is in the initializer of other global
+        GlobalVariable *inInit = createString(M, "inInit");
+        new GlobalVariable(M, i8ptr, false, GlobalValue::ExternalLinkage,
+                           firstElement(inInit), "holder");
+        // passed to a defined function that reads it
+        GlobalVariable *argRead = createString(M, "argRead");
+        // passed to a defined function that stores it
+        GlobalVariable *argStored = createString(M, "argStored");
+        // passed as a variadic argument
+        GlobalVariable *vararg = createString(M, "vararg");
+        // passed to the thread function
+        GlobalVariable *thread = createString(M, "thread");
+        // not constant
+        Constant *init = ConstantDataArray::getString(ctx, "mutable");
+        GlobalVariable *mut
+            = new GlobalVariable(M, init->getType(), false,
+                                 GlobalValue::PrivateLinkage, init, "mutable");
+        // contains a pointer
+        GlobalVariable *ptr
+            = new GlobalVariable(M, i8ptr, true, GlobalValue::PrivateLinkage,
+                                 ConstantPointerNull::get(cast<PointerType>(i8ptr)),
+                                 "ptr");
+
+        FunctionType *argFunTy = FunctionType::get(voidTy, {i8ptr}, false);
+        Function *printfF = createFunction(M, "printf",
+                                           FunctionType::get(i32, {i8ptr}, true));
+        Function *pthreadCreate
+            = createFunction(M, "pthread_create",
+                             FunctionType::get(i32, {i8ptr, i8ptr, i8ptr, i8ptr}, false));
+
+        Function *reads = createFunction(M, "reads", argFunTy);
+        BasicBlock *B = BasicBlock::Create(ctx, "entry", reads);
+        createLoad(i8, &*reads->arg_begin(), B);
+        ReturnInst::Create(ctx, B);
+
+        Function *stores = createFunction(M, "stores", argFunTy);
+        B = BasicBlock::Create(ctx, "entry", stores);
+        new StoreInst(&*stores->arg_begin(), sink, B);
+        ReturnInst::Create(ctx, B);
+
+        Function *variadic = createFunction(M, "variadic",
+                                            FunctionType::get(voidTy, {i32}, true));
+        B = BasicBlock::Create(ctx, "entry", variadic);
+        ReturnInst::Create(ctx, B);
+
+        Function *F = createFunction(M, "main", FunctionType::get(voidTy, false));
+        B = BasicBlock::Create(ctx, "entry", F);
+        createLoad(i8, firstElement(str), B);
+        CallInst::Create(printfF, {firstElement(str)}, "", B);
+        new StoreInst(firstElement(stored), sink, B);
+        createLoad(i32, ConstantExpr::getBitCast(firstElement(chain), i32ptr), B);
+        new StoreInst(ConstantExpr::getBitCast(
+                        ConstantExpr::getBitCast(firstElement(chainStored), i32ptr),
+                        i8ptr), sink, B);
+        CallInst::Create(reads, {firstElement(argRead)}, "", B);
+        CallInst::Create(stores, {firstElement(argStored)}, "", B);
+        CallInst::Create(variadic, {ConstantInt::get(i32, 1), firstElement(vararg)},
+                         "", B);
+        Constant *null = ConstantPointerNull::get(cast<PointerType>(i8ptr));
+        CallInst::Create(pthreadCreate, {null, null, null, firstElement(thread)},
+                         "", B);
+        createLoad(i8, firstElement(mut), B);
+        createLoad(i8ptr, ptr, B);
+        ReturnInst::Create(ctx, B);
+
+        dg::analysis::ImmutableGlobals immutable;
+        immutable.compute(&M);
+
+        check(immutable.isImmutable(str), "str is not immutable");
+        check(immutable.isImmutable(chain), "chain is not immutable");
+        check(immutable.isImmutable(argRead), "argRead is not immutable");
+        check(!immutable.isImmutable(stored), "stored is immutable");
+        check(!immutable.isImmutable(chainStored), "chainStored is immutable");
+        check(!immutable.isImmutable(inInit), "inInit is immutable");
+        check(!immutable.isImmutable(argStored), "argStored is immutable");
+        check(!immutable.isImmutable(vararg), "vararg is immutable");
+        check(!immutable.isImmutable(thread), "thread is immutable");
+        check(!immutable.isImmutable(mut), "mutable is immutable");
+        check(!immutable.isImmutable(ptr), "ptr is immutable");
+        check(!immutable.isImmutable(sink), "sink is immutable");
+        check(immutable.size() == 3, "wrong number of immutable globals: %u",
+              static_cast<unsigned>(immutable.size()));
+    }
+};
+
+struct TestGlobalsDefinitions : public Test
+{
+    TestGlobalsDefinitions() : Test("globals initialization in RD test") {}
+
+    template <typename RDType>
+    void checkDefinitions()
+    {
+        using namespace llvm;
+        using namespace dg::analysis;
+
+        LLVMContext ctx;
+        Module M("globals", ctx);
+
+        Type *i8 = Type::getInt8Ty(ctx);
+        Type *i32 = Type::getInt32Ty(ctx);
+        GlobalVariable *A
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 1), "a");
+        GlobalVariable *B
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 2), "b");
+        GlobalVariable *S = createString(M, "str");
+
+        Function *F = createFunction(M, "main",
+                                     FunctionType::get(Type::getVoidTy(ctx), false));
+        BasicBlock *BB = BasicBlock::Create(ctx, "entry", F);
+        LoadInst *L1 = createLoad(i32, A, BB);
+        LoadInst *L2 = createLoad(i32, B, BB);
+        StoreInst *S1 = new StoreInst(ConstantInt::get(i32, 3), A, BB);
+        LoadInst *L3 = createLoad(i32, A, BB);
+        LoadInst *L4 = createLoad(i8, firstElement(S), BB);
+        ReturnInst::Create(ctx, BB);
+
+        LLVMPointerAnalysis PTA(&M);
+        PTA.run<pta::PointerAnalysisFI>();
+
+        rd::LLVMReachingDefinitions RD(&M, &PTA, {});
+        RD.run<RDType>();
+
+        using DefsT = std::vector<llvm::Value *>;
+        check(RD.getLLVMReachingDefinitions(L1) == DefsT{A},
+              "the definition of 'a' is not the global");
+        check(RD.getLLVMReachingDefinitions(L2) == DefsT{B},
+              "the definition of 'b' is not the global");
+        check(RD.getLLVMReachingDefinitions(L3) == DefsT{S1},
+              "the store does not overwrite the initial value");
+
+        // the string is not in the graph
+        check(!RD.getNode(S), "have a node for the immutable global");
+        check(RD.isUse(L4), "the read of the string is not a use");
+        check(RD.getLLVMReachingDefinitions(L4) == DefsT{S},
+              "the definition of the string is not the global");
+    }
+
+    void test()
+    {
+        checkDefinitions<dg::analysis::rd::ReachingDefinitionsAnalysis>();
+        checkDefinitions<dg::analysis::rd::SSAReachingDefinitionsAnalysis>();
+    }
+};
+
+struct TestGlobalsInitializers : public Test
+{
+    TestGlobalsInitializers() : Test("pointers in globals initializers test") {}
+
+    using InitialPointer = dg::analysis::pta::PSNodeAlloc::InitialPointer;
+
+    static const InitialPointer *findInitialPointer(dg::analysis::pta::PSNode *n,
+                                                    uint64_t offset)
+    {
+        for (const auto& ip : dg::analysis::pta::PSNodeAlloc::get(n)->getInitialPointers()) {
+            if (*ip.offset == offset)
+                return &ip;
+        }
+        return nullptr;
+    }
+
+    static llvm::Constant *element(llvm::GlobalVariable *G,
+                                   std::vector<unsigned> indices)
+    {
+        using namespace llvm;
+        Type *i32 = Type::getInt32Ty(G->getContext());
+        std::vector<Constant *> idx{ConstantInt::get(i32, 0)};
+        for (unsigned i : indices)
+            idx.push_back(ConstantInt::get(i32, i));
+        return ConstantExpr::getGetElementPtr(G->getValueType(), G, idx);
+    }
+
+    void test()
+    {
+        using namespace llvm;
+        using namespace dg::analysis;
+
+        LLVMContext ctx;
+        Module M("initializers", ctx);
+
+        Type *i8 = Type::getInt8Ty(ctx);
+        Type *i32 = Type::getInt32Ty(ctx);
+        PointerType *i32ptr = PointerType::get(i32, 0);
+        GlobalVariable *X
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 0), "x");
+        GlobalVariable *Y
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 0), "y");
+
+        // i32 *arr[4] = {&x, &x, &x, &x};
+        ArrayType *arrTy = ArrayType::get(i32ptr, 4);
+        GlobalVariable *Arr
+            = new GlobalVariable(M, arrTy, false, GlobalValue::ExternalLinkage,
+                                 ConstantArray::get(arrTy, {X, X, X, X}), "arr");
+
+        // struct { char c; i32 *p; } padded = {1, &y};
+        StructType *sTy = StructType::create(ctx, {i8, i32ptr}, "struct.s");
+        GlobalVariable *Padded
+            = new GlobalVariable(M, sTy, false, GlobalValue::ExternalLinkage,
+                                 ConstantStruct::get(sTy, {ConstantInt::get(i8, 1), Y}),
+                                 "padded");
+
+        // struct s nested[3] = {{0, &x}, {0, &x}, {0, &y}};
+        Constant *sx = ConstantStruct::get(sTy, {ConstantInt::get(i8, 0), X});
+        Constant *sy = ConstantStruct::get(sTy, {ConstantInt::get(i8, 0), Y});
+        ArrayType *nestedTy = ArrayType::get(sTy, 3);
+        GlobalVariable *Nested
+            = new GlobalVariable(M, nestedTy, false, GlobalValue::ExternalLinkage,
+                                 ConstantArray::get(nestedTy, {sx, sx, sy}), "nested");
+
+        // <2 x i32 *> vec = {&x, &y};
+        GlobalVariable *Vec
+            = new GlobalVariable(M, VectorType::get(i32ptr, 2
+#if LLVM_VERSION_MAJOR >= 11
+                                                    , false
+#endif
+                                                    ),
+                                 false, GlobalValue::ExternalLinkage,
+                                 ConstantVector::get({X, Y}), "vec");
+
+        Function *F = createFunction(M, "main",
+                                     FunctionType::get(Type::getVoidTy(ctx), false));
+        BasicBlock *BB = BasicBlock::Create(ctx, "entry", F);
+        LoadInst *L1 = createLoad(i32ptr, element(Arr, {3}), BB);
+        LoadInst *L2 = createLoad(i32ptr, element(Padded, {1}), BB);
+        LoadInst *L3 = createLoad(i32ptr, element(Nested, {1, 1}), BB);
+        LoadInst *L4 = createLoad(i32ptr, element(Nested, {2, 1}), BB);
+        ReturnInst::Create(ctx, BB);
+
+        LLVMPointerAnalysis PTA(&M);
+        PTA.run<pta::PointerAnalysisFI>();
+
+        pta::PSNode *x = PTA.getPointsTo(X);
+        pta::PSNode *y = PTA.getPointsTo(Y);
+
+        // the array of the same pointers is one strided pointer
+        pta::PSNode *arr = PTA.getPointsTo(Arr);
+        check(pta::PSNodeAlloc::get(arr)->getInitialPointers().size() == 1,
+              "the array does not have one initial pointer");
+        const InitialPointer *ip = findInitialPointer(arr, 0);
+        check(ip && ip->pointer.target == x && *ip->pointer.offset == 0,
+              "wrong initial pointer of the array");
+        check(ip && *ip->stride == 8 && ip->count == 4,
+              "wrong stride or count of the array");
+
+        // the pointer is after the padding
+        pta::PSNode *padded = PTA.getPointsTo(Padded);
+        check(pta::PSNodeAlloc::get(padded)->getInitialPointers().size() == 1,
+              "the struct does not have one initial pointer");
+        ip = findInitialPointer(padded, 8);
+        check(ip && ip->pointer.target == y && ip->count == 1,
+              "wrong initial pointer of the struct");
+
+        // the first two (same) structures are one run
+        pta::PSNode *nested = PTA.getPointsTo(Nested);
+        check(pta::PSNodeAlloc::get(nested)->getInitialPointers().size() == 2,
+              "the nested array does not have two initial pointers");
+        ip = findInitialPointer(nested, 8);
+        check(ip && ip->pointer.target == x && *ip->stride == 16 && ip->count == 2,
+              "wrong initial pointer of the run in the nested array");
+        ip = findInitialPointer(nested, 40);
+        check(ip && ip->pointer.target == y && ip->count == 1,
+              "wrong initial pointer of the last nested structure");
+
+        pta::PSNode *vec = PTA.getPointsTo(Vec);
+        ip = findInitialPointer(vec, 0);
+        check(ip && ip->pointer.target == x, "wrong first element of the vector");
+        ip = findInitialPointer(vec, 8);
+        check(ip && ip->pointer.target == y, "wrong second element of the vector");
+
+        // the analysis reads the initial pointers
+        check(PTA.getPointsTo(L1)->doesPointsTo(x, 0), "arr[3] does not point to x");
+        check(PTA.getPointsTo(L2)->doesPointsTo(y, 0), "padded.p does not point to y");
+        check(PTA.getPointsTo(L3)->doesPointsTo(x, 0), "nested[1].p does not point to x");
+        check(!PTA.getPointsTo(L3)->doesPointsTo(y, 0), "nested[1].p points to y");
+        check(PTA.getPointsTo(L4)->doesPointsTo(y, 0), "nested[2].p does not point to y");
+        check(!PTA.getPointsTo(L4)->doesPointsTo(x, 0), "nested[2].p points to x");
+    }
+};
+
+struct TestPromotedLocals : public Test
+{
+    TestPromotedLocals() : Test("promoted locals in RD test") {}
+
+    using DefsT = std::set<llvm::Value *>;
+
+    template <typename RDType>
+    DefsT getDefinitions(llvm::Module& M, bool promote, llvm::Value *use)
+    {
+        using namespace dg::analysis;
+
+        LLVMPointerAnalysisOptions ptaOpts;
+        ptaOpts.promoteLocals = promote;
+        LLVMPointerAnalysis PTA(&M, ptaOpts);
+        PTA.run<pta::PointerAnalysisFI>();
+
+        LLVMReachingDefinitionsAnalysisOptions rdOpts;
+        rdOpts.promoteLocals = promote;
+        rd::LLVMReachingDefinitions RD(&M, &PTA, rdOpts);
+        RD.run<RDType>();
+
+        auto defs = RD.getLLVMReachingDefinitions(use);
+        return DefsT(defs.begin(), defs.end());
+    }
+
+    template <typename RDType>
+    void checkDefinitions()
+    {
+        using namespace llvm;
+
+        LLVMContext ctx;
+        Module M("locals", ctx);
+
+        Type *i32 = Type::getInt32Ty(ctx);
+        Type *i32ptr = PointerType::get(i32, 0);
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        Function *F = createFunction(M, "main",
+                                     FunctionType::get(Type::getVoidTy(ctx),
+                                                       args, false));
+        Type *extArgs[] = {i32ptr};
+        Function *ext = createFunction(M, "ext",
+                                       FunctionType::get(Type::getVoidTy(ctx),
+                                                         extArgs, false));
+
+        // x is promotable, the address of y escapes through a call
+        // and the address of z through a store:
+        //
+        // entry: store 1, x; store 2, y; store 3, z; store z, pp;
+        //        br c, T, J
+        // T:     store 4, x; call ext(y); q = load pp; store 5, q; br J
+        // J:     lx = load x; ly = load y; lz = load z
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        BasicBlock *T = BasicBlock::Create(ctx, "T", F);
+        BasicBlock *J = BasicBlock::Create(ctx, "J", F);
+        AllocaInst *X = new AllocaInst(i32, 0, "x", entry);
+        AllocaInst *Y = new AllocaInst(i32, 0, "y", entry);
+        AllocaInst *Z = new AllocaInst(i32, 0, "z", entry);
+        AllocaInst *PP = new AllocaInst(i32ptr, 0, "pp", entry);
+        StoreInst *SX1 = new StoreInst(ConstantInt::get(i32, 1), X, entry);
+        StoreInst *SY = new StoreInst(ConstantInt::get(i32, 2), Y, entry);
+        StoreInst *SZ1 = new StoreInst(ConstantInt::get(i32, 3), Z, entry);
+        new StoreInst(Z, PP, entry);
+        BranchInst::Create(T, J, &*F->arg_begin(), entry);
+
+        StoreInst *SX2 = new StoreInst(ConstantInt::get(i32, 4), X, T);
+        Value *callArgs[] = {Y};
+        CallInst *call = CallInst::Create(ext, callArgs, "", T);
+        LoadInst *Q = createLoad(i32ptr, PP, T);
+        StoreInst *SZ2 = new StoreInst(ConstantInt::get(i32, 5), Q, T);
+        BranchInst::Create(J, T);
+
+        LoadInst *LX = createLoad(i32, X, J);
+        LoadInst *LY = createLoad(i32, Y, J);
+        LoadInst *LZ = createLoad(i32, Z, J);
+        ReturnInst::Create(ctx, J);
+
+        dg::analysis::PromotableAllocas promotable;
+        check(promotable.isPromoted(X), "x is not promoted");
+        check(!promotable.isPromoted(Y), "y is promoted, but escapes via a call");
+        check(!promotable.isPromoted(Z), "z is promoted, but escapes via a store");
+
+        // the promoted loads must get the same definitions
+        // as the loads of the memory
+        for (LoadInst *L : {LX, LY, LZ}) {
+            check(getDefinitions<RDType>(M, true, L) ==
+                  getDefinitions<RDType>(M, false, L),
+                  "the promoted locals change the definitions of %s",
+                  L->getPointerOperand()->getName().data());
+        }
+
+        DefsT defsX{SX1, SX2}, defsY{SY, call}, defsZ{SZ1, SZ2};
+        check(getDefinitions<RDType>(M, true, LX) == defsX,
+              "wrong definitions of x");
+        check(getDefinitions<RDType>(M, true, LY) == defsY,
+              "wrong definitions of y");
+        check(getDefinitions<RDType>(M, true, LZ) == defsZ,
+              "wrong definitions of z");
+    }
+
+    void test()
+    {
+        checkDefinitions<dg::analysis::rd::ReachingDefinitionsAnalysis>();
+        checkDefinitions<dg::analysis::rd::SSAReachingDefinitionsAnalysis>();
+    }
+};
+
+struct TestFindInstruction : public Test
+{
+    TestFindInstruction() : Test("finding nodes of instructions test") {}
+
+    // main() calls foo(), both have a few instructions
+    static void createModule(llvm::Module& M)
+    {
+        using namespace llvm;
+        LLVMContext& ctx = M.getContext();
+        Type *i32 = Type::getInt32Ty(ctx);
+        FunctionType *FTy = FunctionType::get(Type::getVoidTy(ctx), false);
+
+        Function *foo = createFunction(M, "foo", FTy);
+        BasicBlock *FB = BasicBlock::Create(ctx, "entry", foo);
+        AllocaInst *A = new AllocaInst(i32, 0, "", FB);
+        new StoreInst(ConstantInt::get(i32, 1), A, FB);
+        ReturnInst::Create(ctx, FB);
+
+        Function *F = createFunction(M, "main", FTy);
+        BasicBlock *B = BasicBlock::Create(ctx, "entry", F);
+        AllocaInst *X = new AllocaInst(i32, 0, "", B);
+        new StoreInst(ConstantInt::get(i32, 0), X, B);
+        CallInst::Create(foo, "", B);
+        createLoad(i32, X, B);
+        ReturnInst::Create(ctx, B);
+    }
+
+    void checkInstructions(const LLVMDependenceGraph& dg, llvm::Module& M)
+    {
+        for (llvm::Function& F : M) {
+            for (llvm::BasicBlock& B : F) {
+                for (llvm::Instruction& I : B) {
+                    LLVMNode *node = dg.findInstruction(&I);
+                    check(node != nullptr, "no node for an instruction of %s",
+                          F.getName().data());
+                    check(node == nullptr || node->getValue() == &I,
+                          "wrong node for an instruction of %s",
+                          F.getName().data());
+                }
+            }
+        }
+    }
+
+    void checkNoInstructions(const LLVMDependenceGraph& dg, llvm::Module& M)
+    {
+        for (llvm::Function& F : M) {
+            for (llvm::BasicBlock& B : F) {
+                for (llvm::Instruction& I : B)
+                    check(dg.findInstruction(&I) == nullptr,
+                          "found a node for an instruction of another graph");
+            }
+        }
+    }
+
+    void test()
+    {
+        using namespace llvm;
+
+        LLVMContext ctx;
+        Module M1("first", ctx);
+        Module M2("second", ctx);
+        createModule(M1);
+        createModule(M2);
+
+        LLVMDependenceGraph dg1;
+        check(dg1.build(&M1, M1.getFunction("main")),
+              "failed building the first graph");
+        LLVMDependenceGraph dg2;
+        check(dg2.build(&M2, M2.getFunction("main")),
+              "failed building the second graph");
+
+        // building the second graph must not break
+        // the lookups in the first one
+        checkInstructions(dg1, M1);
+        checkInstructions(dg2, M2);
+        checkNoInstructions(dg1, M2);
+        checkNoInstructions(dg2, M1);
+    }
+};
+
+struct TestCompactCFG : public Test
+{
+    TestCompactCFG() : Test("CFG compaction test") {}
+
+    llvm::LLVMContext ctx;
+    llvm::Type *i32 = llvm::Type::getInt32Ty(ctx);
+
+    // i32 f(i1 c)
+    llvm::Function *createFunction(llvm::Module& M, const char *name)
+    {
+        using namespace llvm;
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        return tests::createFunction(M, name, FunctionType::get(i32, args, false));
+    }
+
+    llvm::BasicBlock *block(llvm::Function *F, const char *name)
+    {
+        return llvm::BasicBlock::Create(ctx, name, F);
+    }
+
+    llvm::Value *cond(llvm::Function *F) { return &*F->arg_begin(); }
+    llvm::Constant *num(int n) { return llvm::ConstantInt::get(i32, n); }
+
+    void checkValid(llvm::Function *F)
+    {
+        check(!llvm::verifyFunction(*F, &llvm::errs()),
+              "%s is broken after the compaction", F->getName().data());
+    }
+
+    void testFoldTrivialPhis(llvm::Module& M)
+    {
+        using namespace llvm;
+
+        // entry: br c, A, B; A: br J; B: br J;
+        // J: p = phi [1, A], [1, B]; q = phi [1, A], [2, B];
+        //    r = p + q; ret r
+        Function *F = createFunction(M, "phis");
+        BasicBlock *entry = block(F, "entry");
+        BasicBlock *A = block(F, "A");
+        BasicBlock *B = block(F, "B");
+        BasicBlock *J = block(F, "J");
+        BranchInst::Create(A, B, cond(F), entry);
+        BranchInst::Create(J, A);
+        BranchInst::Create(J, B);
+        PHINode *p = PHINode::Create(i32, 2, "p", J);
+        p->addIncoming(num(1), A);
+        p->addIncoming(num(1), B);
+        PHINode *q = PHINode::Create(i32, 2, "q", J);
+        q->addIncoming(num(1), A);
+        q->addIncoming(num(2), B);
+        auto r = BinaryOperator::CreateAdd(p, q, "r", J);
+        ReturnInst::Create(ctx, r, J);
+
+        // L: l = phi [0, entry], [l, L]; br c, L, E -- the value
+        // from the loop is the phi itself, so it always is 0
+        Function *G = createFunction(M, "loopphi");
+        BasicBlock *Gentry = block(G, "entry");
+        BasicBlock *L = block(G, "L");
+        BasicBlock *E = block(G, "E");
+        BranchInst::Create(L, Gentry);
+        PHINode *l = PHINode::Create(i32, 2, "l", L);
+        l->addIncoming(num(0), Gentry);
+        l->addIncoming(l, L);
+        BranchInst::Create(L, E, cond(G), L);
+        ReturnInst::Create(ctx, l, E);
+
+        LLVMSlicer slicer;
+        check(slicer.foldTrivialPhis(J), "did not fold the phi in J");
+        check(J->size() == 3, "J should have q, r and ret, has %u instructions",
+              static_cast<unsigned>(J->size()));
+        check(r->getOperand(0) == num(1), "p was not replaced by 1");
+        check(r->getOperand(1) == q, "q was replaced");
+        check(!slicer.foldTrivialPhis(J), "folded a non-trivial phi");
+        checkValid(F);
+
+        check(slicer.foldTrivialPhis(L), "did not fold the phi on the loop");
+        check(!isa<PHINode>(L->front()), "the phi on the loop was not removed");
+        check(E->getTerminator()->getOperand(0) == num(0),
+              "the phi on the loop was not replaced by 0");
+        checkValid(G);
+
+        check(slicer.getCompactionStatistics().phisFolded == 2,
+              "wrong number of folded phis: %u",
+              slicer.getCompactionStatistics().phisFolded);
+    }
+
+    void testRemoveForwardingBlock(llvm::Module& M)
+    {
+        using namespace llvm;
+
+        // entry: br c, A, X; A: br Fw; Fw: br S; X: br S;
+        // S: p = phi [1, Fw], [2, X]; ret p
+        Function *F = createFunction(M, "forward");
+        BasicBlock *entry = block(F, "entry");
+        BasicBlock *A = block(F, "A");
+        BasicBlock *Fw = block(F, "Fw");
+        BasicBlock *X = block(F, "X");
+        BasicBlock *S = block(F, "S");
+        BranchInst::Create(A, X, cond(F), entry);
+        BranchInst::Create(Fw, A);
+        BranchInst::Create(S, Fw);
+        BranchInst::Create(S, X);
+        PHINode *p = PHINode::Create(i32, 2, "p", S);
+        p->addIncoming(num(1), Fw);
+        p->addIncoming(num(2), X);
+        ReturnInst::Create(ctx, p, S);
+
+        LLVMSlicer slicer;
+        check(slicer.removeForwardingBlock(Fw), "did not remove Fw");
+        check(A->getTerminator()->getOperand(0) == S, "A does not jump to S");
+        check(p->getNumIncomingValues() == 2, "wrong number of incoming values");
+        check(p->getIncomingValueForBlock(A) == num(1),
+              "the phi does not get 1 from A");
+        checkValid(F);
+
+        // T feeds the phi, but its predecessor is a predecessor
+        // of the phi's block too, so the phi would need two values
+        // for the entry block:
+        // entry: br c, T, D; T: br D; D: d = phi [1, entry], [2, T]; ret d
+        Function *D = createFunction(M, "diamond");
+        BasicBlock *Dentry = block(D, "entry");
+        BasicBlock *T = block(D, "T");
+        BasicBlock *DJ = block(D, "D");
+        BranchInst::Create(T, DJ, cond(D), Dentry);
+        BranchInst::Create(DJ, T);
+        PHINode *d = PHINode::Create(i32, 2, "d", DJ);
+        d->addIncoming(num(1), Dentry);
+        d->addIncoming(num(2), T);
+        ReturnInst::Create(ctx, d, DJ);
+
+        check(!slicer.removeForwardingBlock(T),
+              "removed a block that feeds a phi of the entry's successor");
+        checkValid(D);
+
+        // a loop with a latch that only jumps back to the header:
+        // entry: br H; H: i = phi [0, entry], [n, Lt]; n = i + 1;
+        // br c, Lt, E; Lt: br H; E: ret n
+        Function *G = createFunction(M, "latch");
+        BasicBlock *Gentry = block(G, "entry");
+        BasicBlock *H = block(G, "H");
+        BasicBlock *Lt = block(G, "Lt");
+        BasicBlock *E = block(G, "E");
+        BranchInst::Create(H, Gentry);
+        PHINode *i = PHINode::Create(i32, 2, "i", H);
+        auto n = BinaryOperator::CreateAdd(i, num(1), "n", H);
+        BranchInst::Create(Lt, E, cond(G), H);
+        i->addIncoming(num(0), Gentry);
+        i->addIncoming(n, Lt);
+        BranchInst::Create(H, Lt);
+        ReturnInst::Create(ctx, n, E);
+
+        check(slicer.removeForwardingBlock(Lt), "did not remove the latch");
+        check(H->getTerminator()->getOperand(2) == H ||
+              H->getTerminator()->getOperand(1) == H,
+              "the header does not jump to itself");
+        check(i->getIncomingValueForBlock(H) == n,
+              "the phi does not get n from the header");
+        checkValid(G);
+
+        // the header jumps to itself now, so it is not removable
+        // and a block jumping to itself neither
+        BasicBlock *U = block(G, "U");
+        BranchInst::Create(U, U);
+        check(!slicer.removeForwardingBlock(U), "removed a self-loop");
+        check(!slicer.removeForwardingBlock(H), "removed the loop header");
+        U->dropAllReferences();
+        U->eraseFromParent();
+
+        check(slicer.getCompactionStatistics().blocksRemoved == 2,
+              "wrong number of removed blocks: %u",
+              slicer.getCompactionStatistics().blocksRemoved);
+    }
+
+    void testMergeIntoPredecessor(llvm::Module& M)
+    {
+        using namespace llvm;
+
+        // entry: br c, P, Y; P: br B; B: a = phi [3, P]; b = a + 1; br S;
+        // Y: br S; S: p = phi [b, B], [0, Y]; ret p
+        Function *F = createFunction(M, "merge");
+        BasicBlock *entry = block(F, "entry");
+        BasicBlock *P = block(F, "P");
+        BasicBlock *B = block(F, "B");
+        BasicBlock *Y = block(F, "Y");
+        BasicBlock *S = block(F, "S");
+        BranchInst::Create(P, Y, cond(F), entry);
+        BranchInst::Create(B, P);
+        PHINode *a = PHINode::Create(i32, 1, "a", B);
+        a->addIncoming(num(3), P);
+        auto b = BinaryOperator::CreateAdd(a, num(1), "b", B);
+        BranchInst::Create(S, B);
+        BranchInst::Create(S, Y);
+        PHINode *p = PHINode::Create(i32, 2, "p", S);
+        p->addIncoming(b, B);
+        p->addIncoming(num(0), Y);
+        ReturnInst::Create(ctx, p, S);
+
+        LLVMSlicer slicer;
+        check(!slicer.mergeIntoPredecessor(S), "merged a block with two predecessors");
+        check(slicer.mergeIntoPredecessor(B), "did not merge B into P");
+        check(b->getParent() == P, "the instructions were not moved to P");
+        check(b->getOperand(0) == num(3), "the phi in B was not folded");
+        check(p->getIncomingValueForBlock(P) == b,
+              "the phi in S does not get b from P");
+        checkValid(F);
+
+        // a loop of two blocks:
+        // entry: br H; H: i = phi [0, entry], [n, B]; br B;
+        // B: n = i + 1; br c, H, E; E: ret n
+        Function *G = createFunction(M, "loop");
+        BasicBlock *Gentry = block(G, "entry");
+        BasicBlock *H = block(G, "H");
+        BasicBlock *LB = block(G, "B");
+        BasicBlock *E = block(G, "E");
+        BranchInst::Create(H, Gentry);
+        PHINode *i = PHINode::Create(i32, 2, "i", H);
+        BranchInst::Create(LB, H);
+        auto n = BinaryOperator::CreateAdd(i, num(1), "n", LB);
+        BranchInst::Create(H, E, cond(G), LB);
+        i->addIncoming(num(0), Gentry);
+        i->addIncoming(n, LB);
+        ReturnInst::Create(ctx, n, E);
+
+        check(!slicer.mergeIntoPredecessor(H), "merged the loop header");
+        check(slicer.mergeIntoPredecessor(LB), "did not merge the loop body");
+        check(i->getIncomingValueForBlock(H) == n,
+              "the phi does not get n from the header");
+        check(H->getTerminator()->getOperand(2) == H ||
+              H->getTerminator()->getOperand(1) == H,
+              "the header does not jump to itself");
+        checkValid(G);
+
+        // the header is its own predecessor now
+        check(!slicer.mergeIntoPredecessor(H), "merged a block into itself");
+
+        check(slicer.getCompactionStatistics().blocksMerged == 2,
+              "wrong number of merged blocks: %u",
+              slicer.getCompactionStatistics().blocksMerged);
+    }
+
+    void testCompactFunction(llvm::Module& M)
+    {
+        using namespace llvm;
+
+        // entry: br A; A: br B; B: p = phi [1, A]; br C; C: ret p
+        Function *F = createFunction(M, "chain");
+        BasicBlock *entry = block(F, "entry");
+        BasicBlock *A = block(F, "A");
+        BasicBlock *B = block(F, "B");
+        BasicBlock *C = block(F, "C");
+        BranchInst::Create(A, entry);
+        BranchInst::Create(B, A);
+        PHINode *p = PHINode::Create(i32, 1, "p", B);
+        p->addIncoming(num(1), A);
+        BranchInst::Create(C, B);
+        ReturnInst::Create(ctx, p, C);
+
+        LLVMSlicer slicer;
+        slicer.compactCFG(F);
+        check(F->size() == 1, "the chain was not compacted to one block");
+        check(isa<ReturnInst>(F->getEntryBlock().front()),
+              "the entry block should contain only the return");
+        checkValid(F);
+    }
+
+    void test()
+    {
+        llvm::Module M("compact", ctx);
+
+        testFoldTrivialPhis(M);
+        testRemoveForwardingBlock(M);
+        testMergeIntoPredecessor(M);
+        testCompactFunction(M);
+    }
+};
+
+struct TestExecutionCoverage : public Test
+{
+    TestExecutionCoverage() : Test("execution coverage test") {}
+
+    llvm::LLVMContext ctx;
+    llvm::Type *i32 = llvm::Type::getInt32Ty(ctx);
+
+    llvm::Constant *num(int n) { return llvm::ConstantInt::get(i32, n); }
+
+    // i32 main(i1 c):
+    //   entry: x = alloca; store 0, x; br c, T, E
+    //   T:     store 1, x; br J
+    //   E:     store 2, x; br J
+    //   J:     p = phi [1, T], [2, E]; l = load x; r = p + l; ret r
+    llvm::Function *createMain(llvm::Module& M)
+    {
+        using namespace llvm;
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        Function *F = createFunction(M, "main", FunctionType::get(i32, args, false));
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        BasicBlock *T = BasicBlock::Create(ctx, "T", F);
+        BasicBlock *E = BasicBlock::Create(ctx, "E", F);
+        BasicBlock *J = BasicBlock::Create(ctx, "J", F);
+
+        AllocaInst *X = new AllocaInst(i32, 0, "x", entry);
+        new StoreInst(num(0), X, entry);
+        BranchInst::Create(T, E, &*F->arg_begin(), entry);
+        new StoreInst(num(1), X, T);
+        BranchInst::Create(J, T);
+        new StoreInst(num(2), X, E);
+        BranchInst::Create(J, E);
+        PHINode *p = PHINode::Create(i32, 2, "p", J);
+        p->addIncoming(num(1), T);
+        p->addIncoming(num(2), E);
+        auto l = createLoad(i32, X, J);
+        auto r = BinaryOperator::CreateAdd(p, l, "r", J);
+        ReturnInst::Create(ctx, r, J);
+
+        return F;
+    }
+
+    static llvm::BasicBlock *getBlock(llvm::Function *F, const char *name)
+    {
+        for (llvm::BasicBlock& B : *F) {
+            if (B.getName() == name)
+                return &B;
+        }
+        return nullptr;
+    }
+
+    bool load(dg::analysis::ExecutionCoverage& cov,
+              llvm::Module& M, const char *text)
+    {
+        std::istringstream in(text);
+        return cov.load(&M, in, "test");
+    }
+
+    void testLoad()
+    {
+        using namespace llvm;
+        using dg::analysis::ExecutionCoverage;
+
+        Module M("coverage", ctx);
+        Function *F = createMain(M);
+        Function *G = createFunction(M, "foo",
+                                     FunctionType::get(Type::getVoidTy(ctx), false));
+        ReturnInst::Create(ctx, BasicBlock::Create(ctx, "entry", G));
+
+        ExecutionCoverage cov;
+        check(load(cov, M, "# the executed blocks\n\n"
+                           "main 1 3\n"
+                           "undefined 1 2\n"),
+              "failed loading a valid coverage");
+        check(!cov.empty(), "the coverage is empty");
+        check(cov.isCovered(&F->getEntryBlock()), "the entry is not covered");
+        check(cov.isCovered(getBlock(F, "T")), "T is not covered");
+        check(!cov.isCovered(getBlock(F, "E")), "E is covered");
+        check(cov.isCovered(getBlock(F, "J")), "J is not covered");
+        check(cov.isCovered(&G->getEntryBlock()),
+              "a function that is not in the file is not covered");
+
+        ExecutionCoverage invalid;
+        check(!load(invalid, M, "main 1 x\n"), "loaded an invalid index");
+        ExecutionCoverage outOfRange;
+        check(!load(outOfRange, M, "main 4\n"), "loaded a non-existing block");
+        ExecutionCoverage negative;
+        check(!load(negative, M, "main -1\n"), "loaded a negative index");
+        ExecutionCoverage missing;
+        check(!missing.load(&M, "/nonexistent/coverage/file"),
+              "loaded a non-existing file");
+    }
+
+    void testGraph()
+    {
+        using namespace llvm;
+        using dg::analysis::ExecutionCoverage;
+
+        Module M("coverage", ctx);
+        Function *F = createMain(M);
+        ExecutionCoverage cov;
+        check(load(cov, M, "main 1 3\n"), "failed loading the coverage");
+
+        BasicBlock *T = getBlock(F, "T");
+        BasicBlock *E = getBlock(F, "E");
+        BasicBlock *J = getBlock(F, "J");
+        Instruction *storeT = &T->front();
+        Instruction *storeE = &E->front();
+        PHINode *phi = cast<PHINode>(&J->front());
+        LoadInst *load = cast<LoadInst>(phi->getNextNode());
+
+        llvmdg::LLVMDependenceGraphOptions opts;
+        opts.coverage = &cov;
+        llvmdg::LLVMDependenceGraphBuilder builder(&M, opts);
+        std::unique_ptr<LLVMDependenceGraph> dg = std::move(builder.build());
+        check(dg != nullptr, "failed building the graph");
+        if (!dg)
+            return;
+
+        // only the covered blocks are built
+        check(dg->getBlocks().size() == 3, "the graph has %u blocks",
+              static_cast<unsigned>(dg->getBlocks().size()));
+        check(dg->findInstruction(storeE) == nullptr,
+              "built a node for an uncovered instruction");
+        check(dg->findInstruction(storeT) != nullptr,
+              "did not build a node for a covered instruction");
+
+        // the stores in the uncovered code do not reach the load
+        using DefsT = std::vector<llvm::Value *>;
+        check(builder.getRDA()->getLLVMReachingDefinitions(load) == DefsT{storeT},
+              "the uncovered store reaches the load");
+
+        // the edge to E is cut, so the entry block is post-dominated by T
+        LLVMBBlock *entryBB = dg->getBlocks()[&F->getEntryBlock()];
+        check(entryBB->getIPostDom() &&
+              entryBB->getIPostDom()->getKey() == T,
+              "T does not post-dominate the entry block");
+
+        // slicing removes the uncovered code from the module
+        LLVMSlicer slicer;
+        slicer.slice(dg.get(), dg->findInstruction(J->getTerminator()));
+
+        check(getBlock(F, "E") == nullptr, "the uncovered block was not removed");
+        check(phi->getNumIncomingValues() == 1,
+              "the phi still has the value from the uncovered block");
+        check(!verifyFunction(*F, &errs()), "the sliced function is broken");
+    }
+
+    void test()
+    {
+        testLoad();
+        testGraph();
+    }
+};
+
+struct TestPostDominators : public Test
+{
+    TestPostDominators() : Test("post-dominators on blocks test") {}
+
+    void test()
+    {
+        using namespace llvm;
+
+        LLVMContext ctx;
+        Module M("postdom", ctx);
+        Type *i32 = Type::getInt32Ty(ctx);
+        Type *args[] = {Type::getInt1Ty(ctx)};
+
+        // a loop and two returns:
+        //
+        // entry: br c, A, B
+        // A:     br L
+        // L:     br c, L2, X
+        // L2:    br L
+        // X:     ret 1
+        // B:     br c, R, X
+        // R:     ret 2
+        Function *F = createFunction(M, "main", FunctionType::get(i32, args, false));
+        Value *c = &*F->arg_begin();
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        BasicBlock *A = BasicBlock::Create(ctx, "A", F);
+        BasicBlock *L = BasicBlock::Create(ctx, "L", F);
+        BasicBlock *L2 = BasicBlock::Create(ctx, "L2", F);
+        BasicBlock *X = BasicBlock::Create(ctx, "X", F);
+        BasicBlock *B = BasicBlock::Create(ctx, "B", F);
+        BasicBlock *R = BasicBlock::Create(ctx, "R", F);
+        BranchInst::Create(A, B, c, entry);
+        BranchInst::Create(L, A);
+        BranchInst::Create(L2, X, c, L);
+        BranchInst::Create(L, L2);
+        ReturnInst::Create(ctx, ConstantInt::get(i32, 1), X);
+        BranchInst::Create(R, X, c, B);
+        ReturnInst::Create(ctx, ConstantInt::get(i32, 2), R);
+
+        // compute the post-dominators in two graphs
+        // of the function by the two algorithms
+        LLVMDependenceGraph fromLLVM;
+        check(fromLLVM.build(&M, F), "failed building the graph");
+        LLVMDependenceGraph onBlocks;
+        check(onBlocks.build(&M, F), "failed building the graph");
+
+        LLVMBBlock *root1 = nullptr;
+        LLVMBBlock *root2 = nullptr;
+        check(setIPostDomsFromLLVM(&fromLLVM, *F, root1),
+              "did not compute the post-dominators by LLVM");
+        check(setIPostDomsOnBlocks(&onBlocks, root2),
+              "did not compute the post-dominators on blocks");
+
+        auto& blocks = onBlocks.getBlocks();
+        check(blocks.size() == F->size(), "not all blocks were built");
+        for (auto& it : fromLLVM.getBlocks()) {
+            const char *name = it.first->getName().data();
+            auto blk = blocks.find(it.first);
+            check(blk != blocks.end(), "do not have the block %s", name);
+            if (blk == blocks.end())
+                continue;
+
+            LLVMBBlock *ipdom1 = it.second->getIPostDom();
+            LLVMBBlock *ipdom2 = blk->second->getIPostDom();
+            check(ipdom1 && ipdom2, "%s has no immediate post-dominator", name);
+            if (!ipdom1 || !ipdom2)
+                continue;
+
+            // the root has no key in both graphs
+            check(ipdom1->getKey() == ipdom2->getKey(),
+                  "the immediate post-dominators of %s differ", name);
+        }
+    }
+};
+
+struct TestAliasQueries : public Test
+{
+    TestAliasQueries() : Test("alias queries test") {}
+
+    using AliasResult = LLVMPointerAnalysis::AliasResult;
+
+#if LLVM_VERSION_MAJOR >= 4
+    // ask through the adapter for the alias analyses of LLVM
+    static llvm::AliasResult llvmAlias(DGAAResult& AA,
+                                       const llvm::Value *V1,
+                                       const llvm::Value *V2,
+                                       uint64_t size)
+    {
+        using namespace llvm;
+#if LLVM_VERSION_MAJOR < 8
+        MemoryLocation Loc1(V1, size), Loc2(V2, size);
+#else
+        MemoryLocation Loc1(V1, LocationSize::precise(size));
+        MemoryLocation Loc2(V2, LocationSize::precise(size));
+#endif
+#if LLVM_VERSION_MAJOR < 9
+        return AA.alias(Loc1, Loc2);
+#elif LLVM_VERSION_MAJOR < 14
+        AAQueryInfo AAQI;
+        return AA.alias(Loc1, Loc2, AAQI);
+#else
+        SimpleAAQueryInfo AAQI;
+        return AA.alias(Loc1, Loc2, AAQI);
+#endif
+    }
+#endif
+
+    void test()
+    {
+        using namespace llvm;
+        using namespace dg::analysis;
+
+        LLVMContext ctx;
+        Module M("alias", ctx);
+
+        Type *i32 = Type::getInt32Ty(ctx);
+        Type *i64 = Type::getInt64Ty(ctx);
+        ArrayType *arrTy = ArrayType::get(i32, 4);
+        GlobalVariable *A
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 0), "a");
+        GlobalVariable *B
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 0), "b");
+        GlobalVariable *Arr
+            = new GlobalVariable(M, arrTy, false, GlobalValue::ExternalLinkage,
+                                 ConstantAggregateZero::get(arrTy), "arr");
+        Constant *idx[] = {ConstantInt::get(i64, 0), ConstantInt::get(i64, 1)};
+        Constant *Arr0 = firstElement(Arr);
+        Constant *Arr1 = ConstantExpr::getGetElementPtr(arrTy, Arr, idx);
+
+        // entry: x = alloca; s = select c, a, b; store 1, s;
+        //        store 2, x; store 3, arr[0]; store 4, arr[1]
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        Function *F = createFunction(M, "main",
+                                     FunctionType::get(Type::getVoidTy(ctx),
+                                                       args, false));
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        AllocaInst *X = new AllocaInst(i32, 0, "x", entry);
+        SelectInst *S = SelectInst::Create(&*F->arg_begin(), A, B, "s", entry);
+        new StoreInst(ConstantInt::get(i32, 1), S, entry);
+        new StoreInst(ConstantInt::get(i32, 2), X, entry);
+        new StoreInst(ConstantInt::get(i32, 3), Arr0, entry);
+        new StoreInst(ConstantInt::get(i32, 4), Arr1, entry);
+        ReturnInst::Create(ctx, entry);
+
+        LLVMPointerAnalysis PTA(&M);
+        PTA.run<pta::PointerAnalysisFI>();
+
+        check(PTA.alias(A, 4, A, 4) == AliasResult::MustAlias,
+              "a does not must-alias with itself");
+        check(PTA.alias(A, 4, B, 4) == AliasResult::NoAlias,
+              "a aliases with b");
+        check(PTA.alias(S, 4, A, 4) == AliasResult::MayAlias,
+              "the select does not may-alias with a");
+        check(PTA.alias(S, 4, Arr0, 4) == AliasResult::NoAlias,
+              "the select aliases with arr");
+        // a local may have more instances (e.g. in recursion)
+        check(PTA.alias(X, 4, X, 4) == AliasResult::MayAlias,
+              "a local must-aliases with itself");
+        // the elements of the array overlap only with a bigger size
+        check(PTA.alias(Arr0, 4, Arr1, 4) == AliasResult::NoAlias,
+              "the elements of arr alias");
+        check(PTA.alias(Arr0, 8, Arr1, 4) == AliasResult::MayAlias,
+              "the 8 bytes at arr[0] do not alias with arr[1]");
+        check(PTA.alias(Arr0, Offset::UNKNOWN, Arr1, 4) == AliasResult::MayAlias,
+              "the unknown bytes at arr[0] do not alias with arr[1]");
+
+        // the repeated and the swapped queries are answered from the cache
+        size_t cached = PTA.getNumOfCachedAliasQueries();
+        check(cached == 8, "have %lu cached queries instead of 8",
+              static_cast<unsigned long>(cached));
+        check(PTA.alias(B, 4, A, 4) == AliasResult::NoAlias,
+              "the swapped query has a different result");
+        check(PTA.alias(S, 4, A, 4) == AliasResult::MayAlias,
+              "the repeated query has a different result");
+        check(PTA.alias(Arr1, 4, Arr0, 8) == AliasResult::MayAlias,
+              "the swapped query with the sizes has a different result");
+        cached = PTA.getNumOfCachedAliasQueries();
+        check(cached == 8, "the repeated queries were not cached");
+
+        // the same pointers with different sizes are different queries
+        PTA.alias(A, 1, B, 4);
+        cached = PTA.getNumOfCachedAliasQueries();
+        check(cached == 9, "the query with other sizes was cached");
+
+#if LLVM_VERSION_MAJOR >= 4
+        DGAAResult AA(&PTA);
+        check(llvmAlias(AA, A, A, 4) == llvm::AliasResult::MustAlias,
+              "the adapter does not answer must-alias");
+        check(llvmAlias(AA, S, B, 4) == llvm::AliasResult::MayAlias,
+              "the adapter does not answer may-alias");
+        check(llvmAlias(AA, Arr0, Arr1, 4) == llvm::AliasResult::NoAlias,
+              "the adapter does not answer no-alias");
+#endif
+    }
+};
+
+struct TestCoarsenedPointsTo : public Test
+{
+    TestCoarsenedPointsTo() : Test("points-to sets of merged allocations test") {}
+
+    using AllocCoarsening = LLVMPointerAnalysisOptions::AllocCoarsening;
+    using ValuesT = std::vector<llvm::Value *>;
+
+    static ValuesT getValues(const LLVMPointsToSet& S)
+    {
+        ValuesT values;
+        for (const auto& ptr : S) {
+            values.push_back(ptr.value);
+        }
+        return values;
+    }
+
+    void test()
+    {
+        using namespace llvm;
+        using namespace dg::analysis;
+
+        LLVMContext ctx;
+        Module M("coarsening", ctx);
+
+        Type *i32 = Type::getInt32Ty(ctx);
+        Type *i64 = Type::getInt64Ty(ctx);
+        GlobalVariable *G1
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 0), "g1");
+        GlobalVariable *G2
+            = new GlobalVariable(M, i32, false, GlobalValue::ExternalLinkage,
+                                 ConstantInt::get(i32, 0), "g2");
+
+        // entry: x, y, z = alloca i32; w = alloca i64;
+        //        s = select c, x, null; store 1, s
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        Function *F = createFunction(M, "main",
+                                     FunctionType::get(Type::getVoidTy(ctx),
+                                                       args, false));
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        AllocaInst *X = new AllocaInst(i32, 0, "x", entry);
+        AllocaInst *Y = new AllocaInst(i32, 0, "y", entry);
+        AllocaInst *Z = new AllocaInst(i32, 0, "z", entry);
+        AllocaInst *W = new AllocaInst(i64, 0, "w", entry);
+        Value *null = ConstantPointerNull::get(X->getType());
+        SelectInst *S = SelectInst::Create(&*F->arg_begin(), X, null, "s", entry);
+        new StoreInst(ConstantInt::get(i32, 1), S, entry);
+        ReturnInst::Create(ctx, entry);
+
+        ValuesT locals{X, Y, Z};
+        ValuesT onlyW{W};
+        ValuesT onlyG1{G1};
+        ValuesT globals{G1, G2};
+
+        for (auto policy : {AllocCoarsening::none,
+                            AllocCoarsening::function,
+                            AllocCoarsening::type}) {
+            LLVMPointerAnalysisOptions opts;
+            opts.allocCoarsening = policy;
+            LLVMPointerAnalysis PTA(&M, opts);
+            PTA.run<pta::PointerAnalysisFI>();
+
+            bool merged = policy != AllocCoarsening::none;
+
+            // x, y and z are one object, the summary
+            // yields all of them in the order of the module
+            auto ptsX = PTA.getLLVMPointsTo(X);
+            check(ptsX.size() == (merged ? 3 : 1),
+                  "x points to %lu objects",
+                  static_cast<unsigned long>(ptsX.size()));
+            check(ptsX.isKnownSingleton() == !merged,
+                  "wrong singleton property of the points-to set of x");
+            check(getValues(ptsX) == (merged ? locals : ValuesT{X}),
+                  "wrong values in the points-to set of x");
+
+            // w has another type and so it is not merged
+            auto ptsW = PTA.getLLVMPointsTo(W);
+            check(ptsW.size() == 1 && ptsW.isKnownSingleton(),
+                  "w is not a known singleton");
+            check(getValues(ptsW) == onlyW, "wrong values in the set of w");
+            check(ptsW.getKnownSingleton().value == W, "w does not point to w");
+
+            // the null is counted, but not yielded
+            auto ptsS = PTA.getLLVMPointsTo(S);
+            check(ptsS.hasNull(), "the select does not point to null");
+            check(ptsS.size() == (merged ? 4 : 2),
+                  "the select points to %lu objects",
+                  static_cast<unsigned long>(ptsS.size()));
+            check(!ptsS.isKnownSingleton(), "the select is a known singleton");
+            check(getValues(ptsS) == (merged ? locals : ValuesT{X}),
+                  "wrong values in the points-to set of the select");
+
+            // the globals are merged only in the whole module
+            bool mergedGlobals = policy == AllocCoarsening::type;
+            auto ptsG1 = PTA.getLLVMPointsTo(G1);
+            check(ptsG1.size() == (mergedGlobals ? 2 : 1),
+                  "g1 points to %lu objects",
+                  static_cast<unsigned long>(ptsG1.size()));
+            check(getValues(ptsG1) == (mergedGlobals ? globals : onlyG1),
+                  "wrong values in the points-to set of g1");
+        }
+    }
+};
+
+struct TestNoreturnDependencies : public Test
+{
+    TestNoreturnDependencies() : Test("reduced noreturn dependencies test") {}
+
+    using NodesT = std::set<LLVMNode *>;
+    using ExtraEdgesT = std::map<LLVMNode *, NodesT>;
+
+    // the nodes from which 'node' is reachable over the control
+    // and data dependencies and over the 'extra' reversed edges
+    static NodesT reachBackwards(LLVMNode *node, const ExtraEdgesT& extra)
+    {
+        NodesT visited{node};
+        std::vector<LLVMNode *> queue{node};
+        while (!queue.empty()) {
+            LLVMNode *cur = queue.back();
+            queue.pop_back();
+
+            std::vector<LLVMNode *> preds(cur->rev_control_begin(),
+                                          cur->rev_control_end());
+            preds.insert(preds.end(), cur->rev_data_begin(), cur->rev_data_end());
+            auto it = extra.find(cur);
+            if (it != extra.end())
+                preds.insert(preds.end(), it->second.begin(), it->second.end());
+
+            for (LLVMNode *pred : preds) {
+                if (visited.insert(pred).second)
+                    queue.push_back(pred);
+            }
+        }
+        return visited;
+    }
+
+    static LLVMNode *getNoReturn(LLVMNode *node)
+    {
+        if (auto params = node->getParameters())
+            return params->getNoReturn();
+        return nullptr;
+    }
+
+    // the dependencies that the unreduced algorithm adds: the noreturn
+    // node of a call to every following node in the block and to every
+    // node of the reachable blocks (as reversed edges)
+    static ExtraEdgesT unreducedDependencies(LLVMDependenceGraph *dg)
+    {
+        ExtraEdgesT edges;
+        for (auto& it : dg->getBlocks()) {
+            LLVMBBlock *B = it.second;
+            std::vector<LLVMNode *> noreturns;
+            for (auto node : B->getNodes()) {
+                edges[node].insert(noreturns.begin(), noreturns.end());
+                if (auto noret = getNoReturn(node))
+                    noreturns.push_back(noret);
+            }
+
+            if (noreturns.empty())
+                continue;
+
+            std::set<LLVMBBlock *> visited;
+            std::vector<LLVMBBlock *> queue;
+            for (auto& succ : B->successors()) {
+                if (visited.insert(succ.target).second)
+                    queue.push_back(succ.target);
+            }
+            while (!queue.empty()) {
+                LLVMBBlock *cur = queue.back();
+                queue.pop_back();
+                for (auto node : cur->getNodes())
+                    edges[node].insert(noreturns.begin(), noreturns.end());
+                for (auto& succ : cur->successors()) {
+                    if (visited.insert(succ.target).second)
+                        queue.push_back(succ.target);
+                }
+            }
+        }
+        return edges;
+    }
+
+    void test()
+    {
+        using namespace llvm;
+
+        LLVMContext ctx;
+        Module M("noreturn", ctx);
+
+        Type *voidTy = Type::getVoidTy(ctx);
+        Type *i32 = Type::getInt32Ty(ctx);
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        FunctionType *FTy = FunctionType::get(voidTy, args, false);
+        Function *abortF = createFunction(M, "abort", FunctionType::get(voidTy, false));
+
+        // mayexit(c): br c, A, R; A: call abort(); unreachable; R: ret
+        Function *mayexit = createFunction(M, "mayexit", FTy);
+        BasicBlock *mEntry = BasicBlock::Create(ctx, "entry", mayexit);
+        BasicBlock *mA = BasicBlock::Create(ctx, "A", mayexit);
+        BasicBlock *mR = BasicBlock::Create(ctx, "R", mayexit);
+        BranchInst::Create(mA, mR, &*mayexit->arg_begin(), mEntry);
+        CallInst::Create(abortF, "", mA);
+        new UnreachableInst(ctx, mA);
+        ReturnInst::Create(ctx, mR);
+
+        // entry: x = alloca; mayexit(c); store 1, x; br c, L, J
+        // L:     mayexit(c); store 2, x; br J
+        // J:     mayexit(c); store 3, x; mayexit(c); l = load x; br c, J, E
+        // E:     ret
+        Function *F = createFunction(M, "main", FTy);
+        Value *c = &*F->arg_begin();
+        Value *callArgs[] = {c};
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        BasicBlock *L = BasicBlock::Create(ctx, "L", F);
+        BasicBlock *J = BasicBlock::Create(ctx, "J", F);
+        BasicBlock *E = BasicBlock::Create(ctx, "E", F);
+        AllocaInst *X = new AllocaInst(i32, 0, "x", entry);
+        CallInst::Create(mayexit, callArgs, "", entry);
+        new StoreInst(ConstantInt::get(i32, 1), X, entry);
+        BranchInst::Create(L, J, c, entry);
+        CallInst::Create(mayexit, callArgs, "", L);
+        new StoreInst(ConstantInt::get(i32, 2), X, L);
+        BranchInst::Create(J, L);
+        CallInst::Create(mayexit, callArgs, "", J);
+        new StoreInst(ConstantInt::get(i32, 3), X, J);
+        CallInst::Create(mayexit, callArgs, "", J);
+        createLoad(i32, X, J);
+        BranchInst::Create(J, E, c, J);
+        ReturnInst::Create(ctx, E);
+
+        llvmdg::LLVMDependenceGraphOptions opts;
+        llvmdg::LLVMDependenceGraphBuilder builder(&M, opts);
+        std::unique_ptr<LLVMDependenceGraph> dg = std::move(builder.build());
+        check(dg != nullptr, "failed building the graph");
+        if (!dg)
+            return;
+
+        // the reduction must have left out some edges...
+        ExtraEdgesT unreduced = unreducedDependencies(dg.get());
+        unsigned reduced = 0;
+        for (auto& it : unreduced) {
+            for (LLVMNode *noret : it.second) {
+                NodesT deps(it.first->rev_control_begin(),
+                            it.first->rev_control_end());
+                if (deps.count(noret) == 0)
+                    ++reduced;
+            }
+        }
+        check(reduced > 0, "no dependence was left out");
+
+        // ...but the nodes that reach a node backwards must stay the same
+        for (auto& it : dg->getBlocks()) {
+            for (auto node : it.second->getNodes()) {
+                NodesT after = reachBackwards(node, {});
+                NodesT before = reachBackwards(node, unreduced);
+                check(after == before,
+                      "different nodes reach a node (%lu instead of %lu)",
+                      static_cast<unsigned long>(after.size()),
+                      static_cast<unsigned long>(before.size()));
+            }
+        }
+    }
+};
+
+struct TestRDOptimizedMapping : public Test
+{
+    TestRDOptimizedMapping() : Test("RD mapping after removing useless nodes test") {}
+
+    template <typename RDType>
+    void checkMapping(llvm::Module& M, llvm::LoadInst *load,
+                      const std::set<llvm::Value *>& expected)
+    {
+        using namespace dg::analysis;
+
+        LLVMPointerAnalysis PTA(&M);
+        PTA.run<pta::PointerAnalysisFI>();
+
+        rd::LLVMReachingDefinitions RD(&M, &PTA, {});
+        RD.run<RDType>();
+
+        std::set<const rd::RDNode *> nodes;
+        for (const auto& nd : RD.getGraph()->getNodes()) {
+            if (nd)
+                nodes.insert(nd.get());
+        }
+
+        // every node that the builder maps a value to is still in the graph
+        for (const auto& it : RD.getNodesMap()) {
+            check(nodes.count(it.second) > 0,
+                  "the builder maps a value to a removed node");
+        }
+
+        for (auto& F : M) {
+            for (auto& B : F) {
+                for (auto& I : B) {
+                    rd::RDNode *nd = RD.getNode(&I);
+                    check(!nd || nodes.count(nd) > 0,
+                          "an instruction has a removed node");
+                }
+            }
+        }
+
+        // the blocks are built only from the remaining nodes
+        for (const auto& block : RD.getGraph()->getBBlocks()) {
+            for (rd::RDNode *nd : block->getNodes()) {
+                check(nodes.count(nd) > 0, "a block has a removed node");
+            }
+        }
+
+        auto defs = RD.getLLVMReachingDefinitions(load);
+        check(std::set<llvm::Value *>(defs.begin(), defs.end()) == expected,
+              "wrong definitions of the load");
+    }
+
+    void test()
+    {
+        using namespace llvm;
+
+        LLVMContext ctx;
+        Module M("optimized", ctx);
+
+        Type *voidTy = Type::getVoidTy(ctx);
+        Type *i32 = Type::getInt32Ty(ctx);
+
+        // the calls of pure() have no definitions nor uses
+        Function *pure = createFunction(M, "pure", FunctionType::get(voidTy, false));
+        ReturnInst::Create(ctx, BasicBlock::Create(ctx, "entry", pure));
+
+        // entry: x = alloca; store 1, x; pure(); pure(); br c, T, J
+        // T:     pure(); store 2, x; br J
+        // J:     l = load x; ret
+        Type *args[] = {Type::getInt1Ty(ctx)};
+        Function *F = createFunction(M, "main",
+                                     FunctionType::get(voidTy, args, false));
+        BasicBlock *entry = BasicBlock::Create(ctx, "entry", F);
+        BasicBlock *T = BasicBlock::Create(ctx, "T", F);
+        BasicBlock *J = BasicBlock::Create(ctx, "J", F);
+        AllocaInst *X = new AllocaInst(i32, 0, "x", entry);
+        StoreInst *S1 = new StoreInst(ConstantInt::get(i32, 1), X, entry);
+        CallInst::Create(pure, "", entry);
+        CallInst::Create(pure, "", entry);
+        BranchInst::Create(T, J, &*F->arg_begin(), entry);
+        CallInst::Create(pure, "", T);
+        StoreInst *S2 = new StoreInst(ConstantInt::get(i32, 2), X, T);
+        BranchInst::Create(J, T);
+        LoadInst *L = createLoad(i32, X, J);
+        ReturnInst::Create(ctx, J);
+
+        std::set<Value *> expected{S1, S2};
+        checkMapping<dg::analysis::rd::ReachingDefinitionsAnalysis>(M, L, expected);
+        checkMapping<dg::analysis::rd::SSAReachingDefinitionsAnalysis>(M, L, expected);
+    }
+};
+
 }
 }
 
@@ -65,6 +1669,19 @@ int main(void)
     TestRunner Runner;
 
     Runner.add(new TestRefcount());
+    Runner.add(new TestConstantExprs());
+    Runner.add(new TestImmutableGlobals());
+    Runner.add(new TestGlobalsDefinitions());
+    Runner.add(new TestGlobalsInitializers());
+    Runner.add(new TestPromotedLocals());
+    Runner.add(new TestFindInstruction());
+    Runner.add(new TestCompactCFG());
+    Runner.add(new TestExecutionCoverage());
+    Runner.add(new TestPostDominators());
+    Runner.add(new TestAliasQueries());
+    Runner.add(new TestCoarsenedPointsTo());
+    Runner.add(new TestNoreturnDependencies());
+    Runner.add(new TestRDOptimizedMapping());
 
     return Runner();
 }
@@ -0,0 +1,123 @@
+#include <cassert>
+#include <vector>
+#include <iostream>
+
+#include "dg/analysis/PointsTo/PointerGraph.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "../tools/TimeMeasure.h"
+
+using namespace dg::analysis::pta;
+using dg::analysis::Offset;
+
+#define measure(func, msg) do { \
+    std::cout << "Running " << msg << "\n"; \
+    dg::debug::TimeMeasure tm; \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) \
+        func<PointerAnalysisFI>(); \
+    tm.stop(); \
+    tm.report(" -- flow-insensitive analysis took"); \
+    tm.start(); \
+    for (int i = 0; i < times; ++i) \
+        func<PointerAnalysisFS>(); \
+    tm.stop(); \
+    tm.report(" -- flow-sensitive analysis took"); \
+    } while(0);
+
+// Create 'num' structures of 'fields' pointer fields (8 bytes each)
+// and initialize every field of every structure to point
+// to a different object. Then copy the structures among each other
+// in a loop, both as a whole and by parts.
+template <typename PTAT>
+void copyStructsInLoop(unsigned num, unsigned fields, bool whole) {
+    PointerGraph PS;
+    std::vector<PSNode *> structs;
+    PSNode *root = PS.create(PSNodeType::NOOP);
+    PSNode *last = root;
+
+    auto append = [&last](PSNode *n) {
+        last->addSuccessor(n);
+        last = n;
+    };
+
+    for (unsigned i = 0; i < num; ++i) {
+        PSNode *S = PS.create(PSNodeType::ALLOC);
+        S->setSize(fields * 8);
+        append(S);
+        structs.push_back(S);
+
+        for (unsigned f = 0; f < fields; ++f) {
+            PSNode *obj = PS.create(PSNodeType::ALLOC);
+            PSNode *fld = PS.create(PSNodeType::GEP, S, f * 8);
+            append(obj);
+            append(fld);
+            append(PS.create(PSNodeType::STORE, obj, fld));
+        }
+    }
+
+    PSNode *header = PS.create(PSNodeType::NOOP);
+    append(header);
+
+    for (unsigned i = 0; i < num; ++i) {
+        PSNode *src = structs[i];
+        PSNode *dest = structs[(i + 1) % num];
+        if (whole) {
+            append(PS.create(PSNodeType::MEMCPY, src, dest, fields * 8));
+        } else {
+            // copy the second half of the source
+            // to the beginning of the destination
+            PSNode *G = PS.create(PSNodeType::GEP, src, (fields / 2) * 8);
+            append(G);
+            append(PS.create(PSNodeType::MEMCPY, G, dest,
+                             (fields - fields / 2) * 8));
+        }
+    }
+
+    // close the loop
+    last->addSuccessor(header);
+
+    PSNode *L = PS.create(PSNodeType::LOAD, structs[0]);
+    append(L);
+
+    auto subg = PS.createSubgraph(root);
+    PS.setEntry(subg);
+    PTAT PA(&PS);
+    PA.run();
+}
+
+template <typename PTAT>
+void test1() {
+    copyStructsInLoop<PTAT>(10, 16, true);
+}
+
+template <typename PTAT>
+void test2() {
+    copyStructsInLoop<PTAT>(10, 16, false);
+}
+
+template <typename PTAT>
+void test3() {
+    copyStructsInLoop<PTAT>(20, 32, true);
+}
+
+template <typename PTAT>
+void test4() {
+    copyStructsInLoop<PTAT>(20, 32, false);
+}
+
+int main()
+{
+    int times;
+    times = 100;
+    measure(test1, "Copying 10 structures with 16 fields in a loop");
+
+    times = 100;
+    measure(test2, "Copying halves of 10 structures with 16 fields in a loop");
+
+    times = 10;
+    measure(test3, "Copying 20 structures with 32 fields in a loop");
+
+    times = 10;
+    measure(test4, "Copying halves of 20 structures with 32 fields in a loop");
+}
@@ -179,6 +179,29 @@ void pointsToTest() {
     REQUIRE(S.mustPointTo(Pointer(A, 0)) == false);
 }
 
+// 'keepsStrided' is false for the sets that store
+// strided offsets as unknown offsets
+template<typename PTSetT>
+void stridedPointsToTest(bool keepsStrided) {
+    using dg::analysis::Offset;
+    PTSetT S;
+    PointerGraph PS;
+    PSNode* A = PS.create(PSNodeType::ALLOC);
+    PSNode* B = PS.create(PSNodeType::ALLOC);
+    // the offset 4 in any element of the size 8
+    S.add(Pointer(A, Offset::getStrided(8, 4)));
+    REQUIRE(S.mayPointTo(Pointer(A, 4)) == true);
+    REQUIRE(S.mayPointTo(Pointer(A, 20)) == true);
+    REQUIRE(S.mayPointTo(Pointer(A, 0)) == !keepsStrided);
+    REQUIRE(S.mayPointTo(Pointer(B, 4)) == false);
+    REQUIRE(S.mustPointTo(Pointer(A, 4)) == false);
+    S.add(Pointer(B, 16));
+    REQUIRE(S.mayPointTo(Pointer(B, Offset::getStrided(8, 0))) == true);
+    REQUIRE(S.mayPointTo(Pointer(B, Offset::getStrided(12, 4))) == true);
+    REQUIRE(S.mayPointTo(Pointer(B, Offset::getStrided(8, 4))) == false);
+    REQUIRE(S.mayPointTo(Pointer(A, Offset::getStrided(16, 12))) == true);
+}
+
 template<typename PTSetT>
 void testAlignedOverflowBehavior() { //only works for aligned PTSets using overflow Set
     PTSetT S;
@@ -343,6 +366,13 @@ TEST_CASE("Test various points-to functions", "PointsToSet") {
     pointsToTest<AlignedPointerIdPointsToSet>();
 }
 
+TEST_CASE("Test points-to functions with strided offsets", "PointsToSet") {
+    stridedPointsToTest<OffsetsSetPointsToSet>(true);
+    stridedPointsToTest<SimplePointsToSet>(true);
+    stridedPointsToTest<AlignedSmallOffsetsPointsToSet>(false);
+    stridedPointsToTest<AlignedPointerIdPointsToSet>(false);
+}
+
 TEST_CASE("Test small overflow set behavior", "PointsToSet") {
     testSmallOverflowBehavior<SmallOffsetsPointsToSet>();
 }
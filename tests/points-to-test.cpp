@@ -9,6 +9,8 @@
 #include "dg/analysis/PointsTo/PointerGraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisHybrid.h"
+#include "dg/analysis/PointsTo/PointerGraphOptimizations.h"
 
 namespace dg {
 namespace tests {
@@ -933,6 +935,136 @@ public:
         check(L3->doesPointsTo(NULLPTR), "L3 does not point to NULL");
     }
 
+    void gep_widening()
+    {
+        using namespace analysis;
+
+        PointerGraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        A->setSize(1000);
+        PSNode *P = PS.create(PSNodeType::ALLOC);
+        PSNode *G0 = PS.create(PSNodeType::GEP, A, 4);
+        PSNode *S1 = PS.create(PSNodeType::STORE, G0, P);
+        /* while (...) p = p + 1; */
+        PSNode *L1 = PS.create(PSNodeType::LOAD, P);
+        PSNode *G1 = PS.create(PSNodeType::GEP, L1, 1);
+        PSNode *S2 = PS.create(PSNodeType::STORE, G1, P);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, P);
+
+        A->addSuccessor(P);
+        P->addSuccessor(G0);
+        G0->addSuccessor(S1);
+        S1->addSuccessor(L1);
+        L1->addSuccessor(G1);
+        G1->addSuccessor(S2);
+        S2->addSuccessor(L1);
+        S2->addSuccessor(L2);
+
+        auto subg = PS.createSubgraph(A);
+        PS.setEntry(subg);
+        for (PSNode *n : {A, P, G0, S1, L1, G1, S2, L2})
+            n->setParent(subg);
+
+        PTStoT PA(&PS);
+        PA.run();
+
+        check(G0->doesPointsTo(A, 4), "G0 does not point to A + 4");
+        check(G1->doesPointsTo(A, Offset::UNKNOWN), "G1 does not point to A + ?");
+        check(L2->doesPointsTo(A, Offset::UNKNOWN), "L2 does not point to A + ?");
+    }
+
+    void global_initial_pointers()
+    {
+        using namespace analysis;
+
+        PointerGraph PS;
+        PSNodeAlloc *A = PSNodeAlloc::get(PS.createGlobal(PSNodeType::ALLOC));
+        PSNodeAlloc *G = PSNodeAlloc::get(PS.createGlobal(PSNodeType::ALLOC));
+        A->setIsGlobal();
+        G->setIsGlobal();
+        G->setSize(40);
+        /* G = { A + 4, A, A, A } (the last three elements as one entry) */
+        G->addInitialPointer(0, Pointer(A, 4));
+        G->addInitialPointer(8, Pointer(A, 0), 8, 3);
+
+        PSNode *E = PS.create(PSNodeType::NOOP);
+        PSNode *G1 = PS.create(PSNodeType::GEP, G, 0);
+        PSNode *G2 = PS.create(PSNodeType::GEP, G, 24);
+        PSNode *G3 = PS.create(PSNodeType::GEP, G, 32);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, G1);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, G2);
+        PSNode *L3 = PS.create(PSNodeType::LOAD, G3);
+
+        E->addSuccessor(G1);
+        G1->addSuccessor(G2);
+        G2->addSuccessor(G3);
+        G3->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(L3);
+
+        auto subg = PS.createSubgraph(E);
+        PS.setEntry(subg);
+        PTStoT PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(A, 4), "L1 does not point to A + 4");
+        check(L2->doesPointsTo(A, 0), "L2 does not point to A");
+        check(!L3->doesPointsTo(A, 0), "L3 points to A");
+    }
+
+    void strided_gep()
+    {
+        using namespace analysis;
+
+        PointerGraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNodeAlloc *ARR = PSNodeAlloc::get(PS.create(PSNodeType::ALLOC));
+        ARR->setSize(160);
+        /* struct { void *data; void *next; } ARR[10];
+         * ARR[i].data = &A; ARR[j].next = &B; */
+        PSNode *GD = PS.create(PSNodeType::GEP, ARR, Offset::getStrided(16, 0));
+        PSNode *GN = PS.create(PSNodeType::GEP, ARR, Offset::getStrided(16, 8));
+        PSNode *S1 = PS.create(PSNodeType::STORE, A, GD);
+        PSNode *S2 = PS.create(PSNodeType::STORE, B, GN);
+        /* ARR[k].next, ARR[1].next and ARR[2].data */
+        PSNode *G1 = PS.create(PSNodeType::GEP, ARR, Offset::getStrided(16, 8));
+        PSNode *G2 = PS.create(PSNodeType::GEP, ARR, 24);
+        PSNode *G3 = PS.create(PSNodeType::GEP, GD, 32);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, G1);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, G2);
+        PSNode *L3 = PS.create(PSNodeType::LOAD, G3);
+
+        A->addSuccessor(B);
+        B->addSuccessor(ARR);
+        ARR->addSuccessor(GD);
+        GD->addSuccessor(GN);
+        GN->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(G1);
+        G1->addSuccessor(G2);
+        G2->addSuccessor(G3);
+        G3->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(L3);
+
+        auto subg = PS.createSubgraph(A);
+        PS.setEntry(subg);
+        PTStoT PA(&PS);
+        PA.run();
+
+        check(GD->doesPointsTo(ARR, Offset::getStrided(16, 0)),
+              "GD does not point to the data field");
+        check(G3->doesPointsTo(ARR, Offset::getStrided(16, 0)),
+              "G3 does not point to the data field");
+        check(L1->doesPointsTo(B), "L1 does not point to B");
+        check(!L1->doesPointsTo(A), "L1 points to A");
+        check(L2->doesPointsTo(B), "L2 does not point to B");
+        check(!L2->doesPointsTo(A), "L2 points to A");
+        check(L3->doesPointsTo(A), "L3 does not point to A");
+        check(!L3->doesPointsTo(B), "L3 points to B");
+    }
+
     void test()
     {
         store_load();
@@ -959,6 +1091,9 @@ public:
         memcpy_test6();
         memcpy_test7();
         memcpy_test8();
+        gep_widening();
+        global_initial_pointers();
+        strided_gep();
     }
 };
 
@@ -980,6 +1115,223 @@ public:
           ("flow-sensitive points-to test") {}
 };
 
+class HybridPointsToTest : public Test
+{
+    struct Function {
+        PointerSubgraph *subg;
+        PSNode *entry;
+        PSNode *last;
+    };
+
+    static Function createFunction(PointerGraph& PS, const char *name) {
+        PSNode *entry = PS.create(PSNodeType::ENTRY);
+        PSNodeEntry::get(entry)->setFunctionName(name);
+        auto subg = PS.createSubgraph(entry);
+        entry->setParent(subg);
+        return {subg, entry, entry};
+    }
+
+    static void append(Function& F, PSNode *n) {
+        n->setParent(F.subg);
+        F.last->addSuccessor(n);
+        F.last = n;
+    }
+
+    // call 'callee' at the end of 'F', return the call-return node
+    static PSNode *appendCall(PointerGraph& PS, Function& F, Function& callee) {
+        PSNode *call = PS.create(PSNodeType::CALL);
+        PSNode *callRet = PS.create(PSNodeType::CALL_RETURN, nullptr);
+        call->setPairedNode(callRet);
+        callRet->setPairedNode(call);
+        PSNodeCall::get(call)->addCallee(callee.subg);
+        PSNodeEntry::get(callee.entry)->addCaller(call);
+        append(F, call);
+        append(F, callRet);
+
+        PSNode *ret = PS.create(PSNodeType::RETURN, nullptr);
+        append(callee, ret);
+        PSNodeRet::get(ret)->addReturnSite(callRet);
+        PSNodeCallRet::get(callRet)->addReturn(ret);
+        return callRet;
+    }
+
+public:
+    HybridPointsToTest()
+          : Test("hybrid points-to test") {}
+
+    // a flow-sensitive function called from the flow-insensitive part
+    void fs_callee()
+    {
+        PointerGraph PS;
+        Function main = createFunction(PS, "main");
+        Function foo = createFunction(PS, "foo");
+
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *P = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, A, P);
+        append(main, A);
+        append(main, B);
+        append(main, P);
+        append(main, S1);
+
+        PSNode *S2 = PS.create(PSNodeType::STORE, B, P);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, P);
+        append(foo, S2);
+        append(foo, L1);
+
+        appendCall(PS, main, foo);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, P);
+        append(main, L2);
+
+        PS.setEntry(main.subg);
+        PointerAnalysisHybrid PA(&PS, {"foo"});
+        PA.run();
+
+        // the store in foo is a strong update
+        check(L1->doesPointsTo(B), "L1 does not point to B");
+        check(!L1->doesPointsTo(A), "L1 points to A");
+        check(L2->doesPointsTo(A), "L2 does not point to A");
+        check(L2->doesPointsTo(B), "L2 does not point to B");
+    }
+
+    // a flow-insensitive function called from the flow-sensitive part
+    void fi_callee()
+    {
+        PointerGraph PS;
+        Function main = createFunction(PS, "main");
+        Function foo = createFunction(PS, "foo");
+
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *P = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, B, P);
+        PSNode *S2 = PS.create(PSNodeType::STORE, A, P);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, P);
+        append(main, A);
+        append(main, B);
+        append(main, P);
+        append(main, S1);
+        append(main, S2);
+        append(main, L1);
+
+        PSNode *L2 = PS.create(PSNodeType::LOAD, P);
+        PSNode *S3 = PS.create(PSNodeType::STORE, B, P);
+        append(foo, L2);
+        append(foo, S3);
+
+        appendCall(PS, main, foo);
+        PSNode *L3 = PS.create(PSNodeType::LOAD, P);
+        append(main, L3);
+
+        PS.setEntry(main.subg);
+        PointerAnalysisHybrid PA(&PS, {"main"});
+        PA.run();
+
+        check(L1->doesPointsTo(A), "L1 does not point to A");
+        check(!L1->doesPointsTo(B), "L1 points to B");
+        check(L2->doesPointsTo(A), "L2 does not point to A");
+        check(L3->doesPointsTo(A), "L3 does not point to A");
+        check(L3->doesPointsTo(B), "L3 does not point to B");
+    }
+
+    // a flow-sensitive thread function forked from the flow-insensitive part
+    void fs_forked()
+    {
+        PointerGraph PS;
+        Function main = createFunction(PS, "main");
+        Function thr = createFunction(PS, "thr");
+
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *P = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, A, P);
+        PSNode *F = PS.create(PSNodeType::FORK, A);
+        append(main, A);
+        append(main, B);
+        append(main, P);
+        append(main, S1);
+        append(main, F);
+        // the fork is the only predecessor of the thread's entry
+        F->addSuccessor(thr.entry);
+
+        PSNode *L1 = PS.create(PSNodeType::LOAD, P);
+        PSNode *S2 = PS.create(PSNodeType::STORE, B, P);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, P);
+        append(thr, L1);
+        append(thr, S2);
+        append(thr, L2);
+
+        PS.setEntry(main.subg);
+        PointerAnalysisHybrid PA(&PS, {"thr"});
+        PA.run();
+
+        check(L1->doesPointsTo(A), "L1 does not point to A");
+        check(L2->doesPointsTo(B), "L2 does not point to B");
+        check(!L2->doesPointsTo(A), "L2 points to A");
+    }
+
+    void test()
+    {
+        fs_callee();
+        fi_callee();
+        fs_forked();
+    }
+};
+
+class AllocationsMergerTest : public Test
+{
+public:
+    AllocationsMergerTest()
+          : Test("allocations merger test") {}
+
+    // the stores to the merged sites are weak updates
+    void merge_sites()
+    {
+        PointerGraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *C = PS.create(PSNodeType::ALLOC);
+        PSNode *D = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, C, A);
+        PSNode *S2 = PS.create(PSNodeType::STORE, D, B);
+        PSNode *L = PS.create(PSNodeType::LOAD, A);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(D);
+        D->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(L);
+
+        auto subg = PS.createSubgraph(A);
+        PS.setEntry(subg);
+
+        PointerGraphOptimizer optimizer(&PS);
+        check(optimizer.mergeAllocations({{PSNodeAlloc::get(A),
+                                           PSNodeAlloc::get(B)}}) == 2,
+              "A and B were not merged");
+
+        PSNode *summary = optimizer.getMapping().get(A);
+        check(summary && summary != A, "A is not mapped");
+        check(optimizer.getMapping().get(B) == summary,
+              "A and B are not mapped to the same node");
+        check(PSNodeAlloc::get(summary)->isSummary(), "Not a summary node");
+        check(L->getOperand(0) == summary, "The load does not use the summary");
+
+        PointerAnalysisFS PA(&PS);
+        PA.run();
+
+        check(L->doesPointsTo(C), "L does not point to C");
+        check(L->doesPointsTo(D), "L does not point to D");
+    }
+
+    void test()
+    {
+        merge_sites();
+    }
+};
+
 class PSNodeTest : public Test
 {
 
@@ -1019,6 +1371,8 @@ int main(void)
 
     Runner.add(new FlowInsensitivePointsToTest());
     Runner.add(new FlowSensitivePointsToTest());
+    Runner.add(new HybridPointsToTest());
+    Runner.add(new AllocationsMergerTest());
     Runner.add(new PSNodeTest());
 
     return Runner();
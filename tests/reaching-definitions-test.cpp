@@ -260,6 +260,134 @@ void basic4()
     CHECK(rd.size() == 0);
 }
 
+template <typename RDType>
+void removeUseless()
+{
+    ReachingDefinitionsGraph graph;
+    RDNode *AL = graph.create(RDNodeType::ALLOC);
+    RDNode *N1 = graph.create(RDNodeType::PHI);
+    RDNode *N2 = graph.create(RDNodeType::PHI);
+    RDNode *S = graph.create(RDNodeType::STORE);
+    RDNode *N3 = graph.create(RDNodeType::CALL);
+    RDNode *N4 = graph.create(RDNodeType::CALL_RETURN);
+    RDNode *U = graph.create(RDNodeType::LOAD);
+
+    S->addDef(AL, 0, 4, true /* strong update */);
+    U->addUse(AL, 0, 4);
+
+    AL->addSuccessor(N1);
+    N1->addSuccessor(N2);
+    N2->addSuccessor(S);
+    // a diamond of nodes without definitions and uses
+    S->addSuccessor(N3);
+    S->addSuccessor(N4);
+    N3->addSuccessor(U);
+    N4->addSuccessor(U);
+
+    graph.setRoot(AL);
+    CHECK(graph.optimize() == 4);
+    CHECK(graph.size() == 3);
+
+    CHECK(AL->getSuccessors().size() == 1);
+    CHECK(*AL->getSuccessors().begin() == S);
+    // the diamond collapsed into a single edge
+    CHECK(S->getSuccessors().size() == 1);
+    CHECK(*S->getSuccessors().begin() == U);
+
+    RDType RD(std::move(graph));
+    RD.run();
+
+    auto rd = RD.getReachingDefinitions(U);
+    CHECK(rd.size() == 1);
+    CHECK(*(rd.begin()) == S);
+}
+
+template <typename RDType>
+void loop()
+{
+    ReachingDefinitionsGraph graph;
+    RDNode *AL = graph.create(RDNodeType::ALLOC);
+    RDNode *S1 = graph.create(RDNodeType::STORE);
+    RDNode *H = graph.create(RDNodeType::NOOP);
+    RDNode *U1 = graph.create(RDNodeType::LOAD);
+    RDNode *B1 = graph.create(RDNodeType::NOOP);
+    RDNode *S2 = graph.create(RDNodeType::STORE);
+    RDNode *B2 = graph.create(RDNodeType::NOOP);
+    RDNode *M = graph.create(RDNodeType::NOOP);
+    RDNode *E = graph.create(RDNodeType::NOOP);
+    RDNode *U2 = graph.create(RDNodeType::LOAD);
+
+    S1->addDef(AL, 0, 4, true /* strong update */);
+    S2->addDef(AL, 0, 4, true /* strong update */);
+    U1->addUse(AL, 0, 4);
+    U2->addUse(AL, 0, 4);
+
+    // S1; while (...) { U1; if (...) S2; } U2
+    AL->addSuccessor(S1);
+    S1->addSuccessor(H);
+    H->addSuccessor(U1);
+    H->addSuccessor(E);
+    U1->addSuccessor(B1);
+    U1->addSuccessor(B2);
+    B1->addSuccessor(S2);
+    S2->addSuccessor(M);
+    B2->addSuccessor(M);
+    M->addSuccessor(H);
+    E->addSuccessor(U2);
+
+    graph.setRoot(AL);
+    RDType RD(std::move(graph));
+    RD.run();
+
+    auto rd = RD.getReachingDefinitions(U1);
+    CHECK(rd.size() == 2);
+    CHECK(std::find(rd.begin(), rd.end(), S1) != rd.end());
+    CHECK(std::find(rd.begin(), rd.end(), S2) != rd.end());
+
+    rd = RD.getReachingDefinitions(U2);
+    CHECK(rd.size() == 2);
+    CHECK(std::find(rd.begin(), rd.end(), S1) != rd.end());
+    CHECK(std::find(rd.begin(), rd.end(), S2) != rd.end());
+}
+
+template <typename RDType>
+void unknownUse()
+{
+    ReachingDefinitionsGraph graph;
+    RDNode *AL1 = graph.create(RDNodeType::ALLOC);
+    RDNode *AL2 = graph.create(RDNodeType::ALLOC);
+    RDNode *S1 = graph.create(RDNodeType::STORE);
+    RDNode *S2 = graph.create(RDNodeType::STORE);
+    RDNode *S3 = graph.create(RDNodeType::STORE);
+    RDNode *M = graph.create(RDNodeType::NOOP);
+    RDNode *U = graph.create(RDNodeType::LOAD);
+
+    S1->addDef(AL1, 0, 4, true /* strong update */);
+    S2->addDef(AL2, 0, 4, true /* strong update */);
+    S3->addDef(AL1, 0, 4, true /* strong update */);
+    U->addUse(UNKNOWN_MEMORY);
+
+    // S1; if (...) S2; else S3; U
+    AL1->addSuccessor(AL2);
+    AL2->addSuccessor(S1);
+    S1->addSuccessor(S2);
+    S1->addSuccessor(S3);
+    S2->addSuccessor(M);
+    S3->addSuccessor(M);
+    M->addSuccessor(U);
+
+    graph.setRoot(AL1);
+    RDType RD(std::move(graph));
+    RD.run();
+
+    // S1 reaches U through the branch with S2
+    auto rd = RD.getReachingDefinitions(U);
+    CHECK(rd.size() == 3);
+    CHECK(std::find(rd.begin(), rd.end(), S1) != rd.end());
+    CHECK(std::find(rd.begin(), rd.end(), S2) != rd.end());
+    CHECK(std::find(rd.begin(), rd.end(), S3) != rd.end());
+}
+
 TEST_CASE("Basic1 data-flow", "[data-flow]") {
     basic1<ReachingDefinitionsAnalysis>();
 }
@@ -276,6 +404,61 @@ TEST_CASE("Basic4 data-flow", "[data-flow]") {
     basic4<ReachingDefinitionsAnalysis>();
 }
 
+TEST_CASE("Remove useless nodes data-flow", "[data-flow]") {
+    removeUseless<ReachingDefinitionsAnalysis>();
+}
+
+TEST_CASE("Loop data-flow", "[data-flow]") {
+    loop<ReachingDefinitionsAnalysis>();
+}
+
+TEST_CASE("Loop memory-ssa", "[memory-ssa]") {
+    loop<SSAReachingDefinitionsAnalysis>();
+}
+
+TEST_CASE("Unknown use data-flow", "[data-flow]") {
+    unknownUse<ReachingDefinitionsAnalysis>();
+}
+
+TEST_CASE("Unknown use memory-ssa", "[memory-ssa]") {
+    unknownUse<SSAReachingDefinitionsAnalysis>();
+}
+
+TEST_CASE("Trivial phi memory-ssa", "[memory-ssa]") {
+    ReachingDefinitionsGraph graph;
+    RDNode *AL = graph.create(RDNodeType::ALLOC);
+    RDNode *S = graph.create(RDNodeType::STORE);
+    RDNode *B1 = graph.create(RDNodeType::NOOP);
+    RDNode *B2 = graph.create(RDNodeType::NOOP);
+    RDNode *M = graph.create(RDNodeType::NOOP);
+    RDNode *U = graph.create(RDNodeType::LOAD);
+
+    S->addDef(AL, 0, 4, true /* strong update */);
+    U->addUse(AL, 0, 4);
+
+    // the branches do not define anything, so the phi
+    // in the merge block has the only definition S
+    AL->addSuccessor(S);
+    S->addSuccessor(B1);
+    S->addSuccessor(B2);
+    B1->addSuccessor(M);
+    B2->addSuccessor(M);
+    M->addSuccessor(U);
+
+    graph.setRoot(AL);
+    SSAReachingDefinitionsAnalysis RD(std::move(graph));
+    RD.run();
+
+    // the phi was replaced by its definition
+    std::vector<RDNode *> defuse(U->defuse.begin(), U->defuse.end());
+    REQUIRE(defuse.size() == 1);
+    CHECK(defuse[0] == S);
+
+    auto rd = RD.getReachingDefinitions(U);
+    REQUIRE(rd.size() == 1);
+    CHECK(rd[0] == S);
+}
+
 /*
 TEST_CASE("Basic1 memory-ssa", "[memory-ssa]") {
     basic1<SSAReachingDefinitionsAnalysis>();
@@ -10,6 +10,9 @@ DG_TESTS_PTA=fi DG_TESTS_RDA=dataflow ./$TEST
 echo "Test with PTA FS & RDA data-flow"
 DG_TESTS_PTA=fs DG_TESTS_RDA=dataflow ./$TEST
 
+echo "Test with hybrid PTA (main flow-sensitive) & RDA data-flow"
+DG_TESTS_PTA=hybrid DG_TESTS_PTA_FS_FUNCTIONS=main DG_TESTS_RDA=dataflow ./$TEST
+
 echo "Test with PTA FI & RDA ssa"
 DG_TESTS_PTA=fi DG_TESTS_RDA=ssa ./$TEST
 
@@ -22,8 +22,12 @@ if [ ! -z "$DG_TESTS_PTA" ]; then
 	export DG_TESTS_PTA="-pta $DG_TESTS_PTA"
 fi
 
+if [ ! -z "$DG_TESTS_PTA_FS_FUNCTIONS" ]; then
+	export DG_TESTS_PTA_FS_FUNCTIONS="-pta-fs-functions=$DG_TESTS_PTA_FS_FUNCTIONS"
+fi
+
 # slice the code
-llvm-slicer $DG_TESTS_PTA -c test_assert "$BCFILE" || exit 1
+llvm-slicer $DG_TESTS_PTA $DG_TESTS_PTA_FS_FUNCTIONS -c test_assert "$BCFILE" || exit 1
 
 # compile additional definitions
 clang -emit-llvm -c -Wall -Wextra "$LIB" -o "$LIBBCFILE"
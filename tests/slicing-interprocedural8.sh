@@ -19,10 +19,14 @@ if [ ! -z "$DG_TESTS_PTA" ]; then
     export DG_TESTS_PTA="-pta $DG_TESTS_PTA"
 fi
 
+if [ ! -z "$DG_TESTS_PTA_FS_FUNCTIONS" ]; then
+    export DG_TESTS_PTA_FS_FUNCTIONS="-pta-fs-functions=$DG_TESTS_PTA_FS_FUNCTIONS"
+fi
+
 if [ ! -z "$DG_TESTS_RDA" ]; then
     export DG_TESTS_RDA="-rda $DG_TESTS_RDA"
 fi
-llvm-slicer $DG_TESTS_RDA $DG_TESTS_PTA -c test_assert "$BCFILE"
+llvm-slicer $DG_TESTS_RDA $DG_TESTS_PTA $DG_TESTS_PTA_FS_FUNCTIONS -c test_assert "$BCFILE"
 
 # link assert to the code
 link_with_assert "$SLICEDFILE" "$LINKEDFILE" -DASSERT_NO_ABORT
@@ -29,9 +29,13 @@ if [ ! -z "$DG_TESTS_PTA" ]; then
 	export DG_TESTS_PTA="-pta $DG_TESTS_PTA"
 fi
 
+if [ ! -z "$DG_TESTS_PTA_FS_FUNCTIONS" ]; then
+	export DG_TESTS_PTA_FS_FUNCTIONS="-pta-fs-functions=$DG_TESTS_PTA_FS_FUNCTIONS"
+fi
+
 # slice the code without definitions,
 # the definitions will be added afterwards
-llvm-slicer  $DG_TESTS_PTA -c test_assert "$NAME.bc" || exit 1
+llvm-slicer  $DG_TESTS_PTA $DG_TESTS_PTA_FS_FUNCTIONS -c test_assert "$NAME.bc" || exit 1
 
 llvm-link "$SLICEDFILE" "$LIBBCFILE" -o "$NAME-withdefs.sliced"
 
@@ -0,0 +1,142 @@
+#include <vector>
+#include <string>
+
+#include "dg/analysis/ReachingDefinitions/ReachingDefinitions.h"
+#include "../tools/TimeMeasure.h"
+
+using namespace dg::analysis::rd;
+
+// Create a "ladder" of 'depth' blocks, each of them with a single
+// predecessor (the previous block), that fans out into 'fan' blocks
+// joined pairwise by merge blocks. Every merge block uses 'fields'
+// fields of the memory, so every phi node created there must search
+// the definitions up the whole ladder.
+static ReachingDefinitionsGraph createLadder(int depth, int fan, int fields)
+{
+    ReachingDefinitionsGraph graph;
+
+    RDNode *root = graph.create(RDNodeType::ALLOC);
+    RDNode *exit = graph.create(RDNodeType::NOOP);
+
+    // define the fields at the beginning
+    RDNode *last = root;
+    for (int f = 0; f < fields; ++f) {
+        RDNode *store = graph.create(RDNodeType::STORE);
+        store->addDef(root, 4*f, 4, true /* strong update */);
+        last->addSuccessor(store);
+        last = store;
+    }
+
+    // the ladder, every rung may jump to the exit
+    for (int i = 0; i < depth; ++i) {
+        RDNode *rung = graph.create(RDNodeType::NOOP);
+        last->addSuccessor(rung);
+        last->addSuccessor(exit);
+        last = rung;
+    }
+
+    // the fan with merges
+    std::vector<RDNode *> branches;
+    for (int j = 0; j < fan; ++j) {
+        RDNode *branch = graph.create(RDNodeType::NOOP);
+        last->addSuccessor(branch);
+        branches.push_back(branch);
+    }
+
+    for (int j = 0; j + 1 < fan; ++j) {
+        RDNode *merge = graph.create(RDNodeType::NOOP);
+        branches[j]->addSuccessor(merge);
+        branches[j + 1]->addSuccessor(merge);
+
+        RDNode *prev = merge;
+        for (int f = 0; f < fields; ++f) {
+            RDNode *load = graph.create(RDNodeType::LOAD);
+            load->addUse(root, 4*f, 4);
+            prev->addSuccessor(load);
+            prev = load;
+        }
+        prev->addSuccessor(exit);
+    }
+
+    graph.setRoot(root);
+    return graph;
+}
+
+// Create the same ladder as above, but join all the blocks
+// of the fan in one merge block. The merge block defines every other
+// field and then reads the whole memory, so there are many phi nodes
+// created in a block with many predecessors.
+static ReachingDefinitionsGraph createWideMerge(int depth, int fan, int fields)
+{
+    ReachingDefinitionsGraph graph;
+
+    RDNode *root = graph.create(RDNodeType::ALLOC);
+    RDNode *exit = graph.create(RDNodeType::NOOP);
+
+    RDNode *last = root;
+    for (int f = 0; f < fields; ++f) {
+        RDNode *store = graph.create(RDNodeType::STORE);
+        store->addDef(root, 4*f, 4, true /* strong update */);
+        last->addSuccessor(store);
+        last = store;
+    }
+
+    for (int i = 0; i < depth; ++i) {
+        RDNode *rung = graph.create(RDNodeType::NOOP);
+        last->addSuccessor(rung);
+        last->addSuccessor(exit);
+        last = rung;
+    }
+
+    RDNode *merge = graph.create(RDNodeType::NOOP);
+    for (int j = 0; j < fan; ++j) {
+        RDNode *branch = graph.create(RDNodeType::NOOP);
+        last->addSuccessor(branch);
+        branch->addSuccessor(merge);
+    }
+
+    RDNode *prev = merge;
+    for (int f = 1; f < fields; f += 2) {
+        RDNode *store = graph.create(RDNodeType::STORE);
+        store->addDef(root, 4*f, 4, true /* strong update */);
+        prev->addSuccessor(store);
+        prev = store;
+    }
+
+    RDNode *load = graph.create(RDNodeType::LOAD);
+    load->addUse(root, 0, 4*fields);
+    prev->addSuccessor(load);
+    load->addSuccessor(exit);
+
+    graph.setRoot(root);
+    return graph;
+}
+
+void test(int depth, int fan, int fields, bool wide = false)
+{
+    dg::debug::TimeMeasure tm;
+    std::string msg = wide ? "Wide merge, ladder of depth " : "Ladder of depth ";
+    msg += std::to_string(depth);
+    msg += ", fan " + std::to_string(fan);
+    msg += ", fields " + std::to_string(fields);
+    msg += " -- ";
+
+    SSAReachingDefinitionsAnalysis RD(wide ? createWideMerge(depth, fan, fields)
+                                           : createLadder(depth, fan, fields));
+
+    tm.start();
+    RD.run();
+    tm.stop();
+    tm.report(msg.c_str());
+}
+
+int main()
+{
+    test(100, 10, 10);
+    test(1000, 10, 10);
+    test(1000, 50, 10);
+    test(1000, 10, 50);
+    test(5000, 20, 20);
+    test(1000, 100, 100, true);
+    test(1000, 1000, 200, true);
+}
@@ -95,6 +95,10 @@ slice()
 		export DG_TESTS_PTA="-pta $DG_TESTS_PTA"
 	fi
 
+	if [ ! -z "$DG_TESTS_PTA_FS_FUNCTIONS" ]; then
+		export DG_TESTS_PTA_FS_FUNCTIONS="-pta-fs-functions=$DG_TESTS_PTA_FS_FUNCTIONS"
+	fi
+
 	if [ ! -z "$DG_TESTS_RDA" ]; then
 		export DG_TESTS_RDA="-rda $DG_TESTS_RDA"
 	fi
@@ -104,7 +108,8 @@ slice()
 	fi
 
 	llvm-slicer $DG_TESTS_PARAMS $DG_TESTS_CDA\
-	            $DG_TESTS_RDA $DG_TESTS_PTA $DG_TESTS_SLICER_FLAGS\
+	            $DG_TESTS_RDA $DG_TESTS_PTA $DG_TESTS_PTA_FS_FUNCTIONS\
+	            $DG_TESTS_SLICER_FLAGS\
 		     -c test_assert "$BCFILE" -o "$OUTPUT"
 }
 
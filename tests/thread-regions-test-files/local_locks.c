@@ -0,0 +1,40 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+struct data {
+	pthread_mutex_t mutex;
+	int counter;
+};
+
+void *func(void *ptr) {
+	struct data *d = ptr;
+
+	pthread_mutex_lock(&d->mutex);
+	++d->counter;
+	pthread_mutex_unlock(&d->mutex);
+
+	return NULL;
+}
+
+int main() {
+	pthread_mutex_t mutex;
+	int counter = 0;
+	pthread_t thread;
+	struct data *d = malloc(sizeof(struct data));
+
+	pthread_mutex_init(&mutex, NULL);
+	pthread_mutex_init(&d->mutex, NULL);
+
+	pthread_create(&thread, NULL, func, d);
+
+	pthread_mutex_lock(&mutex);
+	++counter;
+	pthread_mutex_unlock(&mutex);
+
+	pthread_mutex_lock(&d->mutex);
+	--d->counter;
+	pthread_mutex_unlock(&d->mutex);
+
+	pthread_join(thread, NULL);
+	return counter;
+}
@@ -0,0 +1,43 @@
+#include <pthread.h>
+
+pthread_mutex_t mutex1;
+pthread_mutex_t mutex2;
+
+int counter;
+
+pthread_mutex_t *choose(int which) {
+	if (which)
+		return &mutex1;
+	return &mutex2;
+}
+
+void *func(void *ptr) {
+	int which = *(int *) ptr;
+
+	pthread_mutex_lock(&mutex1);
+	++counter;
+	pthread_mutex_unlock(&mutex1);
+
+	pthread_mutex_lock(choose(which));
+	++counter;
+	pthread_mutex_unlock(&mutex2);
+
+	return NULL;
+}
+
+int main() {
+	int which = 1;
+	pthread_t thread;
+
+	pthread_mutex_init(&mutex1, NULL);
+	pthread_mutex_init(&mutex2, NULL);
+
+	pthread_create(&thread, NULL, func, &which);
+
+	pthread_mutex_lock(&mutex2);
+	--counter;
+	pthread_mutex_unlock(&mutex2);
+
+	pthread_join(thread, NULL);
+	return 0;
+}
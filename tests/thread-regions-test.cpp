@@ -32,7 +32,10 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <algorithm>
+#include <map>
 #include <queue>
+#include <set>
 #include <string>
 
 TEST_CASE("Test of node class methods", "[node]") {
@@ -590,3 +593,274 @@ TEST_CASE("GraphBuilder build tests", "[GraphBuilder]") {
         REQUIRE(i == 2);
     }
 }
+
+TEST_CASE("Matching of locks and unlocks", "[GraphBuilder]") {
+    using namespace llvm;
+    LLVMContext context;
+    SMDiagnostic SMD;
+    std::unique_ptr<Module> M = parseIRFile(LOCKS_FILE, SMD, context);
+    dg::LLVMPointerAnalysis pointsToAnalysis(M.get(), "main", dg::analysis::Offset::UNKNOWN, true);
+    pointsToAnalysis.run<dg::analysis::pta::PointerAnalysisFI>();
+    std::unique_ptr<GraphBuilder> graphBuilder(new GraphBuilder(&pointsToAnalysis));
+
+    graphBuilder->buildFunction(M->getFunction("main"));
+    graphBuilder->matchForksAndJoins();
+    graphBuilder->matchLocksAndUnlocks();
+
+    std::set<LockNode *> locks;
+    std::set<UnlockNode *> unlocks;
+    for (auto & function : *M) {
+        for (auto & block : function) {
+            for (auto & instruction : block) {
+                auto node = graphBuilder->findInstruction(&instruction);
+                if (auto lock = castNode<NodeType::LOCK>(node)) {
+                    locks.insert(lock);
+                } else if (auto unlock = castNode<NodeType::UNLOCK>(node)) {
+                    unlocks.insert(unlock);
+                }
+            }
+        }
+    }
+
+    REQUIRE(locks.size() == 3);
+    REQUIRE(unlocks.size() == 3);
+
+    // the matching must be the same as if we compared
+    // the mutex points-to sets of every lock and every unlock
+    auto mayAlias = [&pointsToAnalysis](const llvm::CallInst *lhs,
+                                        const llvm::CallInst *rhs) {
+        auto lhsPtr = pointsToAnalysis.getPointsTo(lhs->getArgOperand(0));
+        auto rhsPtr = pointsToAnalysis.getPointsTo(rhs->getArgOperand(0));
+        if (!lhsPtr || !rhsPtr) {
+            return true;
+        }
+        for (const auto lhsPointsTo : lhsPtr->pointsTo) {
+            for (const auto rhsPointsTo : rhsPtr->pointsTo) {
+                if (lhsPointsTo.isUnknown() || rhsPointsTo.isUnknown() ||
+                    lhsPointsTo.target == rhsPointsTo.target) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    unsigned matched = 0;
+    unsigned unmatched = 0;
+    for (auto lock : locks) {
+        for (auto unlock : unlocks) {
+            bool expected = mayAlias(lock->callInstruction(), unlock->callInstruction());
+            bool found = lock->correspondingUnlocks().count(unlock) > 0;
+            REQUIRE(expected == found);
+            if (found) {
+                ++matched;
+            } else {
+                ++unmatched;
+            }
+        }
+    }
+
+    // the lock of choose() may be both mutexes, the other
+    // locks correspond only to the unlocks of the same mutex
+    REQUIRE(matched == 6);
+    REQUIRE(unmatched == 3);
+}
+
+TEST_CASE("Parallel build gives the same graph", "[GraphBuilder]") {
+    using namespace llvm;
+
+    // the edges of the graph reachable from 'entry', the ids are relative
+    // to the id of 'entry' so that graphs built one after another compare
+    auto edges = [](Node *entry) {
+        std::map<int, std::set<int>> result;
+        std::queue<Node *> queue;
+        queue.push(entry);
+        result[0];
+        while (!queue.empty()) {
+            auto node = queue.front();
+            queue.pop();
+            std::set<Node *> successors = node->successors();
+            if (auto fork = castNode<NodeType::FORK>(node)) {
+                successors.insert(fork->forkSuccessors().begin(),
+                                  fork->forkSuccessors().end());
+            }
+            auto & nodeEdges = result[node->id() - entry->id()];
+            for (auto successor : successors) {
+                nodeEdges.insert(successor->id() - entry->id());
+                if (result.find(successor->id() - entry->id()) == result.end()) {
+                    result[successor->id() - entry->id()];
+                    queue.push(successor);
+                }
+            }
+        }
+        return result;
+    };
+
+    for (auto file : {SIMPLE_FILE, PTHREAD_EXIT_FILE, LOCKS_FILE}) {
+        LLVMContext context;
+        SMDiagnostic SMD;
+        std::unique_ptr<Module> M = parseIRFile(file, SMD, context);
+        dg::LLVMPointerAnalysis pointsToAnalysis(M.get(), "main", dg::analysis::Offset::UNKNOWN, true);
+        pointsToAnalysis.run<dg::analysis::pta::PointerAnalysisFI>();
+
+        GraphBuilder sequential(&pointsToAnalysis);
+        GraphBuilder parallel(&pointsToAnalysis, 4);
+        auto sequentialMain = sequential.buildFunction(M->getFunction("main"));
+        auto parallelMain = parallel.buildFunction(M->getFunction("main"));
+        REQUIRE(sequentialMain.first);
+        REQUIRE(parallelMain.first);
+
+        REQUIRE(sequential.matchForksAndJoins() == parallel.matchForksAndJoins());
+        REQUIRE(sequential.matchLocksAndUnlocks() == parallel.matchLocksAndUnlocks());
+
+        REQUIRE(sequential.size() == parallel.size());
+        REQUIRE(sequential.getJoins() == parallel.getJoins());
+        REQUIRE(sequential.getLocks().size() == parallel.getLocks().size());
+        REQUIRE(edges(sequentialMain.first) == edges(parallelMain.first));
+
+        for (auto & function : *M) {
+            for (auto & block : function) {
+                for (auto & instruction : block) {
+                    auto sequentialNode = sequential.findInstruction(&instruction);
+                    auto parallelNode = parallel.findInstruction(&instruction);
+                    REQUIRE((sequentialNode == nullptr) == (parallelNode == nullptr));
+                    if (!sequentialNode) {
+                        continue;
+                    }
+                    REQUIRE(sequentialNode->getType() == parallelNode->getType());
+                    REQUIRE(sequentialNode->id() - sequentialMain.first->id() ==
+                            parallelNode->id() - parallelMain.first->id());
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Critical sections", "[ControlFlowGraph]") {
+    using namespace llvm;
+    LLVMContext context;
+    SMDiagnostic SMD;
+    std::unique_ptr<Module> M = parseIRFile(LOCKS_FILE, SMD, context);
+    dg::LLVMPointerAnalysis pointsToAnalysis(M.get(), "main", dg::analysis::Offset::UNKNOWN, true);
+    pointsToAnalysis.run<dg::analysis::pta::PointerAnalysisFI>();
+    ControlFlowGraph controlFlowGraph(&pointsToAnalysis);
+    controlFlowGraph.buildFunction(M->getFunction("main"));
+
+    auto locks = controlFlowGraph.getLocks();
+    REQUIRE(locks.size() == 3);
+
+    const llvm::CallInst * mutex1Lock = nullptr;
+    for (auto lock : locks) {
+        if (lock->getArgOperand(0) == M->getGlobalVariable("mutex1")) {
+            mutex1Lock = lock;
+        }
+    }
+    REQUIRE(mutex1Lock != nullptr);
+
+    const auto & criticalSection = controlFlowGraph.getCorrespondingCriticalSection(mutex1Lock);
+    REQUIRE_FALSE(criticalSection.empty());
+    REQUIRE(criticalSection.count(mutex1Lock) == 0);
+
+    // the critical section ends with the unlock of mutex1,
+    // so the call of choose() is not in it
+    bool hasCounterStore = false;
+    bool hasUnlock = false;
+    for (auto instruction : criticalSection) {
+        REQUIRE(instruction->getParent()->getParent() == mutex1Lock->getParent()->getParent());
+        if (auto store = dyn_cast<llvm::StoreInst>(instruction)) {
+            hasCounterStore |= store->getPointerOperand() == M->getGlobalVariable("counter");
+        }
+        if (auto callInst = dyn_cast<llvm::CallInst>(instruction)) {
+            auto function = callInst->getCalledFunction();
+            REQUIRE(function != nullptr);
+            REQUIRE_FALSE(function->getName().equals("choose"));
+            hasUnlock |= function->getName().equals("pthread_mutex_unlock");
+        }
+    }
+    REQUIRE(hasCounterStore);
+    REQUIRE(hasUnlock);
+    REQUIRE(controlFlowGraph.getCorrespongingUnlocks(mutex1Lock).size() == 1);
+}
+
+TEST_CASE("Critical sections end only at unlocks of the same mutex", "[ControlFlowGraph]") {
+    using namespace llvm;
+    LLVMContext context;
+    SMDiagnostic SMD;
+    std::unique_ptr<Module> M = parseIRFile(LOCKS_FILE, SMD, context);
+    dg::LLVMPointerAnalysis pointsToAnalysis(M.get(), "main", dg::analysis::Offset::UNKNOWN, true);
+    pointsToAnalysis.run<dg::analysis::pta::PointerAnalysisFI>();
+    ControlFlowGraph controlFlowGraph(&pointsToAnalysis);
+    controlFlowGraph.buildFunction(M->getFunction("main"));
+
+    // the lock of choose() may lock mutex1 or mutex2,
+    // the lock in main() locks mutex2
+    const llvm::CallInst * chooseLock = nullptr;
+    const llvm::CallInst * mutex2Lock = nullptr;
+    for (auto lock : controlFlowGraph.getLocks()) {
+        if (lock->getArgOperand(0) == M->getGlobalVariable("mutex2")) {
+            mutex2Lock = lock;
+        } else if (isa<llvm::CallInst>(lock->getArgOperand(0))) {
+            chooseLock = lock;
+        }
+    }
+    REQUIRE(chooseLock != nullptr);
+    REQUIRE(mutex2Lock != nullptr);
+
+    auto isReturn = [](const llvm::Instruction * instruction) {
+        return isa<llvm::ReturnInst>(instruction);
+    };
+    auto isJoin = [](const llvm::Instruction * instruction) {
+        auto callInst = dyn_cast<llvm::CallInst>(instruction);
+        return callInst && callInst->getCalledFunction() &&
+               callInst->getCalledFunction()->getName().equals("pthread_join");
+    };
+
+    // the unlock of mutex2 may not release the lock of choose(),
+    // so the critical section goes on to the return from func()
+    const auto & chooseSection = controlFlowGraph.getCorrespondingCriticalSection(chooseLock);
+    REQUIRE(controlFlowGraph.getCorrespongingUnlocks(chooseLock).size() == 3);
+    REQUIRE(std::any_of(chooseSection.begin(), chooseSection.end(), isReturn));
+
+    // the unlock of mutex2 in main() must release the lock of mutex2
+    const auto & mutex2Section = controlFlowGraph.getCorrespondingCriticalSection(mutex2Lock);
+    REQUIRE_FALSE(mutex2Section.empty());
+    REQUIRE_FALSE(std::any_of(mutex2Section.begin(), mutex2Section.end(), isJoin));
+    REQUIRE_FALSE(std::any_of(mutex2Section.begin(), mutex2Section.end(), isReturn));
+}
+
+TEST_CASE("Critical sections of local and heap mutexes", "[ControlFlowGraph]") {
+    using namespace llvm;
+    LLVMContext context;
+    SMDiagnostic SMD;
+    std::unique_ptr<Module> M = parseIRFile(LOCAL_LOCKS_FILE, SMD, context);
+    dg::LLVMPointerAnalysis pointsToAnalysis(M.get(), "main", dg::analysis::Offset::UNKNOWN, true);
+    pointsToAnalysis.run<dg::analysis::pta::PointerAnalysisFI>();
+    ControlFlowGraph controlFlowGraph(&pointsToAnalysis);
+    controlFlowGraph.buildFunction(M->getFunction("main"));
+
+    auto isCallOf = [](const llvm::Instruction * instruction, const char * name) {
+        auto callInst = dyn_cast<llvm::CallInst>(instruction);
+        return callInst && callInst->getCalledFunction() &&
+               callInst->getCalledFunction()->getName().equals(name);
+    };
+
+    // the lock of the local mutex and the locks of the mutex
+    // in the allocated memory in main() and in func()
+    auto locks = controlFlowGraph.getLocks();
+    REQUIRE(locks.size() == 3);
+
+    // the mutexes are single objects, so every section
+    // ends at the unlock that follows the lock
+    for (auto lock : locks) {
+        const auto & criticalSection = controlFlowGraph.getCorrespondingCriticalSection(lock);
+        bool hasUnlock = false;
+        for (auto instruction : criticalSection) {
+            REQUIRE(instruction->getParent()->getParent() == lock->getParent()->getParent());
+            REQUIRE_FALSE(isa<llvm::ReturnInst>(instruction));
+            REQUIRE_FALSE(isCallOf(instruction, "pthread_join"));
+            REQUIRE_FALSE(isCallOf(instruction, "pthread_mutex_lock"));
+            hasUnlock |= isCallOf(instruction, "pthread_mutex_unlock");
+        }
+        REQUIRE(hasUnlock);
+    }
+}
@@ -4,6 +4,10 @@
 #include <chrono>
 #include <iostream>
 
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
 namespace dg {
 namespace debug {
 
@@ -47,6 +51,21 @@ public:
         out << sec << " sec " << msec << " ms" << std::endl;
     }
 };
+
+///
+// Get the peak resident set size of this process in kilobytes
+// (0 if we cannot find out). The number never decreases, so to get
+// the memory consumption of a single computation, run it in its own process.
+inline long getPeakRSS()
+{
+#ifdef __unix__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return 0;
+}
+
 } // namespace debug
 } // namespace dg
 
@@ -3,6 +3,10 @@
 #endif
 
 #include <set>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -40,6 +44,7 @@
 
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 
 #include "TimeMeasure.h"
@@ -49,8 +54,54 @@ using namespace dg::analysis::pta;
 using llvm::errs;
 
 enum PTType {
-    FLOW_SENSITIVE = 1,
     FLOW_INSENSITIVE,
+    FLOW_SENSITIVE,
+    WITH_INVALIDATE,
+};
+
+static const char *ptTypeName(PTType type)
+{
+    switch (type) {
+        case FLOW_INSENSITIVE: return "fi";
+        case FLOW_SENSITIVE: return "fs";
+        case WITH_INVALIDATE: return "inv";
+    }
+
+    return "?";
+}
+
+enum OutputFormat {
+    TEXT,
+    CSV,
+    JSON,
+};
+
+// one run of pointer analysis with the measured data
+struct PTARun {
+    PTType type;
+    uint64_t field_sensitivity;
+    std::unique_ptr<LLVMPointerAnalysis> PTA;
+
+    // performance
+    long time_ms{0};
+    unsigned iterations{0};
+    size_t processed_nodes{0};
+    size_t nodes{0};
+    long peak_rss_kb{0};
+
+    // precision (on the pointer operands of loads and stores)
+    size_t accesses{0};
+    size_t pointers{0};
+    size_t unknown{0};
+    size_t singletons{0};
+    size_t empty{0};
+
+    PTARun(PTType t, uint64_t fs) : type(t), field_sensitivity(fs) {}
+
+    double avgPointsToSize() const {
+        return accesses == 0 ? 0.0
+                             : static_cast<double>(pointers) / accesses;
+    }
 };
 
 static std::string
@@ -200,38 +251,203 @@ static bool verify_ptsets(llvm::Module *M,
     return ret;
 }
 
+static void computePrecision(llvm::Module *M, PTARun& run)
+{
+    using namespace llvm;
+
+    for (Function& F : *M) {
+        for (BasicBlock& B : F) {
+            for (Instruction& I : B) {
+                const Value *ptr = nullptr;
+                if (auto LI = dyn_cast<LoadInst>(&I))
+                    ptr = LI->getPointerOperand();
+                else if (auto SI = dyn_cast<StoreInst>(&I))
+                    ptr = SI->getPointerOperand();
+                else
+                    continue;
+
+                // no node - the instruction is not reachable from the entry
+                PSNode *node = run.PTA->getPointsTo(ptr);
+                if (!node)
+                    continue;
+
+                ++run.accesses;
+                run.pointers += node->pointsTo.size();
+                if (node->pointsTo.empty())
+                    ++run.empty;
+                else if (node->pointsTo.hasUnknown())
+                    ++run.unknown;
+                else if (node->pointsTo.size() == 1)
+                    ++run.singletons;
+            }
+        }
+    }
+}
+
+template <typename PTType>
+static void runPTA(llvm::Module *M, const char *entry_func, PTARun& run)
+{
+    LLVMPointerAnalysisOptions opts;
+    opts.threads = false;
+    opts.setFieldSensitivity(run.field_sensitivity);
+    opts.setEntryFunction(entry_func);
+    if (run.type == FLOW_SENSITIVE)
+        opts.analysisType = LLVMPointerAnalysisOptions::AnalysisType::fs;
+    else if (run.type == WITH_INVALIDATE)
+        opts.analysisType = LLVMPointerAnalysisOptions::AnalysisType::inv;
+
+    run.PTA.reset(new LLVMPointerAnalysis(M, opts));
+
+    dg::debug::TimeMeasure tm;
+    tm.start();
+    std::unique_ptr<PointerAnalysis> PTA(run.PTA->createPTA<PTType>());
+    PTA->run();
+    tm.stop();
+
+    run.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        tm.duration()).count();
+    run.iterations = PTA->getIterationsNum();
+    run.processed_nodes = PTA->getProcessedNodesNum();
+    run.nodes = run.PTA->getNodes().size();
+    // memory objects of the analysis are still alive here
+    run.peak_rss_kb = dg::debug::getPeakRSS();
+
+    computePrecision(M, run);
+}
+
+static std::string fieldSensitivityStr(uint64_t fs)
+{
+    return fs == Offset::UNKNOWN ? std::string("inf") : std::to_string(fs);
+}
+
+static void printRuns(const std::vector<PTARun>& runs, OutputFormat format)
+{
+    if (format == CSV) {
+        printf("pta,field_sensitivity,time_ms,iterations,processed_nodes,"
+               "nodes,peak_rss_kb,accesses,avg_ptset_size,unknown,"
+               "singletons,empty\n");
+        for (const PTARun& run : runs) {
+            printf("%s,%s,%ld,%u,%lu,%lu,%ld,%lu,%.3f,%lu,%lu,%lu\n",
+                   ptTypeName(run.type),
+                   fieldSensitivityStr(run.field_sensitivity).c_str(),
+                   run.time_ms, run.iterations,
+                   static_cast<unsigned long>(run.processed_nodes),
+                   static_cast<unsigned long>(run.nodes),
+                   run.peak_rss_kb,
+                   static_cast<unsigned long>(run.accesses),
+                   run.avgPointsToSize(),
+                   static_cast<unsigned long>(run.unknown),
+                   static_cast<unsigned long>(run.singletons),
+                   static_cast<unsigned long>(run.empty));
+        }
+    } else if (format == JSON) {
+        printf("[\n");
+        for (size_t i = 0; i < runs.size(); ++i) {
+            const PTARun& run = runs[i];
+            printf("  {\"pta\": \"%s\", \"field_sensitivity\": \"%s\", "
+                   "\"time_ms\": %ld, \"iterations\": %u, "
+                   "\"processed_nodes\": %lu, \"nodes\": %lu, "
+                   "\"peak_rss_kb\": %ld, \"accesses\": %lu, "
+                   "\"avg_ptset_size\": %.3f, \"unknown\": %lu, "
+                   "\"singletons\": %lu, \"empty\": %lu}%s\n",
+                   ptTypeName(run.type),
+                   fieldSensitivityStr(run.field_sensitivity).c_str(),
+                   run.time_ms, run.iterations,
+                   static_cast<unsigned long>(run.processed_nodes),
+                   static_cast<unsigned long>(run.nodes),
+                   run.peak_rss_kb,
+                   static_cast<unsigned long>(run.accesses),
+                   run.avgPointsToSize(),
+                   static_cast<unsigned long>(run.unknown),
+                   static_cast<unsigned long>(run.singletons),
+                   static_cast<unsigned long>(run.empty),
+                   i + 1 < runs.size() ? "," : "");
+        }
+        printf("]\n");
+    } else {
+        for (const PTARun& run : runs) {
+            printf("%s (field sensitivity %s):\n", ptTypeName(run.type),
+                   fieldSensitivityStr(run.field_sensitivity).c_str());
+            printf("  time: %ld ms, iterations: %u, processed nodes: %lu, "
+                   "nodes: %lu, peak RSS: %ld kB\n",
+                   run.time_ms, run.iterations,
+                   static_cast<unsigned long>(run.processed_nodes),
+                   static_cast<unsigned long>(run.nodes),
+                   run.peak_rss_kb);
+            printf("  loads/stores: %lu, avg. points-to size: %.3f, "
+                   "unknown: %lu, singletons: %lu, empty: %lu\n",
+                   static_cast<unsigned long>(run.accesses),
+                   run.avgPointsToSize(),
+                   static_cast<unsigned long>(run.unknown),
+                   static_cast<unsigned long>(run.singletons),
+                   static_cast<unsigned long>(run.empty));
+        }
+    }
+}
+
+static void usage()
+{
+    errs() << "Usage: % llvm-pta-compare [-pta fi|fs|inv]... "
+              "[-pta-field-sensitive N]... [-entry FUNC] "
+              "[-csv|-json] [-no-verify] IR_module\n"
+              "  Every combination of the given analyses and field\n"
+              "  sensitivities is run (by default fi and fs with unlimited\n"
+              "  field sensitivity). The peak RSS is the peak of the whole\n"
+              "  process, run one analysis at a time to measure memory.\n";
+}
+
 int main(int argc, char *argv[])
 {
     llvm::Module *M;
     llvm::LLVMContext context;
     llvm::SMDiagnostic SMD;
     const char *module = nullptr;
-    unsigned type = FLOW_SENSITIVE | FLOW_INSENSITIVE;
+    const char *entry_func = "main";
+    std::vector<PTType> types;
+    std::vector<uint64_t> field_sensitivities;
+    OutputFormat format = TEXT;
+    bool verify = true;
 
     // parse options
     for (int i = 1; i < argc; ++i) {
-        // run only given points-to analysis
-        if (strcmp(argv[i], "-pta") == 0) {
-            if (strcmp(argv[i+1], "fs") == 0)
-                type = FLOW_SENSITIVE;
-            else if (strcmp(argv[i+1], "fi") == 0)
-                type = FLOW_INSENSITIVE;
+        // run given points-to analysis
+        if (strcmp(argv[i], "-pta") == 0 && i + 1 < argc) {
+            ++i;
+            if (strcmp(argv[i], "fs") == 0)
+                types.push_back(FLOW_SENSITIVE);
+            else if (strcmp(argv[i], "fi") == 0)
+                types.push_back(FLOW_INSENSITIVE);
+            else if (strcmp(argv[i], "inv") == 0)
+                types.push_back(WITH_INVALIDATE);
             else {
-                errs() << "Unknown PTA type" << argv[i + 1] << "\n";
+                errs() << "Unknown PTA type " << argv[i] << "\n";
                 abort();
             }
-        /*} else if (strcmp(argv[i], "-v") == 0) {
-            verbose = true;*/
+        } else if (strcmp(argv[i], "-pta-field-sensitive") == 0 && i + 1 < argc) {
+            field_sensitivities.push_back(static_cast<uint64_t>(atoll(argv[++i])));
+        } else if (strcmp(argv[i], "-entry") == 0 && i + 1 < argc) {
+            entry_func = argv[++i];
+        } else if (strcmp(argv[i], "-csv") == 0) {
+            format = CSV;
+        } else if (strcmp(argv[i], "-json") == 0) {
+            format = JSON;
+        } else if (strcmp(argv[i], "-no-verify") == 0) {
+            verify = false;
         } else {
             module = argv[i];
         }
     }
 
     if (!module) {
-        errs() << "Usage: % llvm-pta-compare [-pta fs|fi] IR_module\n";
+        usage();
         return 1;
     }
 
+    if (types.empty())
+        types = {FLOW_INSENSITIVE, FLOW_SENSITIVE};
+    if (field_sensitivities.empty())
+        field_sensitivities.push_back(Offset::UNKNOWN);
+
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR <= 5))
     M = llvm::ParseIRFile(module, SMD, context);
 #else
@@ -246,38 +462,49 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    dg::debug::TimeMeasure tm;
-
-    LLVMPointerAnalysis *PTAfs = nullptr;
-    LLVMPointerAnalysis *PTAfi = nullptr;
-
-    if (type & FLOW_INSENSITIVE) {
-        PTAfi = new LLVMPointerAnalysis(M);
+    std::vector<PTARun> runs;
+    for (uint64_t fs : field_sensitivities) {
+        for (PTType type : types) {
+            runs.emplace_back(type, fs);
+            PTARun& run = runs.back();
+            switch (type) {
+                case FLOW_INSENSITIVE:
+                    runPTA<PointerAnalysisFI>(M, entry_func, run);
+                    break;
+                case FLOW_SENSITIVE:
+                    runPTA<PointerAnalysisFS>(M, entry_func, run);
+                    break;
+                case WITH_INVALIDATE:
+                    runPTA<PointerAnalysisFSInv>(M, entry_func, run);
+                    break;
+            }
 
-        tm.start();
-        PTAfi->run<analysis::pta::PointerAnalysisFI>();
-        tm.stop();
-        tm.report("INFO: Points-to flow-insensitive analysis took");
+            // we need the results only for the verification
+            if (!verify)
+                run.PTA.reset();
+        }
     }
 
-    if (type & FLOW_SENSITIVE) {
-        PTAfs = new LLVMPointerAnalysis(M);
-
-        tm.start();
-        PTAfs->run<analysis::pta::PointerAnalysisFS>();
-        tm.stop();
-        tm.report("INFO: Points-to flow-sensitive analysis took");
-    }
+    printRuns(runs, format);
 
+    // check that FS is a subset of FI with the same field sensitivity
     int ret = 0;
-    if (type == (FLOW_SENSITIVE | FLOW_INSENSITIVE)) {
-        ret = !verify_ptsets(M, PTAfi, PTAfs);
-        if (ret == 0)
-            llvm::errs() << "FS is a subset of FI, all OK\n";
+    for (size_t i = 0; verify && i < runs.size(); ++i) {
+        if (runs[i].type != FLOW_INSENSITIVE)
+            continue;
+        for (size_t j = 0; j < runs.size(); ++j) {
+            if (runs[j].type != FLOW_SENSITIVE ||
+                runs[j].field_sensitivity != runs[i].field_sensitivity)
+                continue;
+
+            if (!verify_ptsets(M, runs[i].PTA.get(), runs[j].PTA.get()))
+                ret = 1;
+            else
+                llvm::errs() << "FS is a subset of FI (field sensitivity "
+                             << fieldSensitivityStr(runs[i].field_sensitivity)
+                             << "), all OK\n";
+        }
     }
 
-    delete PTAfi;
-    delete PTAfs;
-
     return ret;
 }
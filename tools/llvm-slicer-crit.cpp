@@ -55,11 +55,14 @@ static bool usesTheVariable(LLVMDependenceGraph& dg,
     if (!ptrNode)
         return true; // it may be a definition of the variable, we do not know
 
-    for (const auto& ptr : ptrNode->pointsTo) {
-        if (ptr.isUnknown())
-            return true; // it may be a definition of the variable, we do not know
+    // NOTE: use the LLVM points-to set, so that we get
+    // all the variables from merged allocation sites
+    dg::LLVMPointsToSet pts(ptrNode->pointsTo);
+    if (pts.hasUnknown())
+        return true; // it may be a definition of the variable, we do not know
 
-        auto value = ptr.target->getUserData<llvm::Value>();
+    for (const auto& ptr : pts) {
+        auto value = ptr.value;
         if (!value)
             continue;
 
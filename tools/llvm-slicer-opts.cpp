@@ -128,6 +128,13 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
                        "the whole memory. May be unsound for out-of-bound access\n"),
                        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<bool> promoteLocals("promote-locals",
+        llvm::cl::desc("Do not model local variables whose address is not taken\n"
+                       "as memory in pointer analysis and reaching definitions,\n"
+                       "connect their loads directly to the reaching stores.\n"
+                       "Default: off\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<bool> undefinedArePure("undefined-are-pure",
         llvm::cl::desc("Assume that undefined functions have no side-effects\n"),
                        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
@@ -136,6 +143,16 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
         llvm::cl::desc("Entry function of the program\n"),
                        llvm::cl::init("main"), llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<std::string> coverageFile("coverage",
+        llvm::cl::desc("Build the dependence graph only from the code that\n"
+                       "was executed. The file has a line for every executed\n"
+                       "function with the name of the function and the indices\n"
+                       "of its executed basic blocks (0 is the entry block),\n"
+                       "e.g. 'foo 0 1 3'. The code that was not executed\n"
+                       "is removed from the sliced program.\n"),
+                       llvm::cl::value_desc("file"),
+                       llvm::cl::init(""), llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<bool> forwardSlicing("forward",
         llvm::cl::desc("Perform forward slicing\n"),
                        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
@@ -157,13 +174,55 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
         llvm::cl::values(
             clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fi, "fi", "Flow-insensitive PTA (default)"),
             clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fs, "fs", "Flow-sensitive PTA"),
-            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv, "inv", "PTA with invalidate nodes")
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv, "inv", "PTA with invalidate nodes"),
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::hybrid, "hybrid",
+                       "Flow-sensitive PTA only in selected functions (see -pta-fs-*)")
     #if LLVM_VERSION_MAJOR < 4
             , nullptr
     #endif
             ),
         llvm::cl::init(LLVMPointerAnalysisOptions::AnalysisType::fi), llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<std::string> ptaFSFunctions("pta-fs-functions",
+        llvm::cl::desc("Hybrid PTA: analyze these functions flow-sensitively.\n"
+                       "The argument is a comma-separated list of functions.\n"),
+                       llvm::cl::value_desc("f1,f2,..."), llvm::cl::init(""),
+                       llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaFSCriteriaDistance("pta-fs-criteria-distance",
+        llvm::cl::desc("Hybrid PTA: analyze flow-sensitively the functions that are\n"
+                       "at most N calls far from a call of the slicing criteria.\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(0),
+                       llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaFSStores("pta-fs-stores",
+        llvm::cl::desc("Hybrid PTA: analyze flow-sensitively the functions that store\n"
+                       "a pointer at least N times. Default: off (N = 0).\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(0),
+                       llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<LLVMPointerAnalysisOptions::AllocCoarsening> ptaCoarsening("pta-coarsening",
+        llvm::cl::desc("Merge allocation sites into coarser abstract objects:"),
+        llvm::cl::values(
+            clEnumValN(LLVMPointerAnalysisOptions::AllocCoarsening::none, "none",
+                       "Every allocation site is an object (default)"),
+            clEnumValN(LLVMPointerAnalysisOptions::AllocCoarsening::function, "function",
+                       "Merge the sites with the same type in a function (not globals)"),
+            clEnumValN(LLVMPointerAnalysisOptions::AllocCoarsening::type, "type",
+                       "Merge the sites with the same type in the module")
+    #if LLVM_VERSION_MAJOR < 4
+            , nullptr
+    #endif
+            ),
+        llvm::cl::init(LLVMPointerAnalysisOptions::AllocCoarsening::none),
+        llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaCoarseningThreshold("pta-coarsening-threshold",
+        llvm::cl::desc("Merge only the groups of more than N allocation sites.\n"
+                       "Default: 1.\n"),
+                       llvm::cl::value_desc("N"), llvm::cl::init(1),
+                       llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<LLVMReachingDefinitionsAnalysisOptions::AnalysisType> rdaType("rda",
         llvm::cl::desc("Choose reaching definitions analysis to use:"),
         llvm::cl::values(
@@ -223,6 +282,21 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
     options.dgOptions.PTAOptions.fieldSensitivity
                                     = dg::analysis::Offset(ptaFieldSensitivity);
     options.dgOptions.PTAOptions.analysisType = ptaType;
+    options.dgOptions.PTAOptions.promoteLocals = promoteLocals;
+
+    for (auto& fun : splitList(ptaFSFunctions))
+        options.dgOptions.PTAOptions.fsFunctions.insert(fun);
+    if (ptaFSCriteriaDistance.getNumOccurrences() > 0) {
+        // the criteria given as a call of a function
+        for (auto& crit : splitList(slicingCriteria)) {
+            if (crit != "ret" && crit.find(':') == std::string::npos)
+                options.dgOptions.PTAOptions.fsCriteria.insert(crit);
+        }
+        options.dgOptions.PTAOptions.fsCriteriaDistance = ptaFSCriteriaDistance;
+    }
+    options.dgOptions.PTAOptions.fsStoresThreshold = ptaFSStores;
+    options.dgOptions.PTAOptions.allocCoarsening = ptaCoarsening;
+    options.dgOptions.PTAOptions.coarseningThreshold = ptaCoarseningThreshold;
 
     options.dgOptions.threads = threads;
     options.dgOptions.PTAOptions.threads = threads;
@@ -232,6 +306,9 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
     options.dgOptions.RDAOptions.strongUpdateUnknown = rdaStrongUpdateUnknown;
     options.dgOptions.RDAOptions.undefinedArePure = undefinedArePure;
     options.dgOptions.RDAOptions.analysisType = rdaType;
+    options.dgOptions.RDAOptions.promoteLocals = promoteLocals;
+
+    options.coverageFile = coverageFile;
 
     addAllocationFuns(options.dgOptions, allocationFuns);
 
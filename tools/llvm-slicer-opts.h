@@ -30,6 +30,10 @@ struct SlicerOptions {
     std::string secondarySlicingCriteria{};
     std::string inputFile{};
     std::string outputFile{};
+
+    // the file with the executed code (see ExecutionCoverage),
+    // the coverage is loaded once the module is loaded
+    std::string coverageFile{};
 };
 
 ///
@@ -95,6 +95,12 @@ llvm::cl::opt<bool> dump_bb_only("dump-bb-only",
                    " (default=false)."),
     llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> compact_cfg("compact-cfg",
+    llvm::cl::desc("Simplify the CFG of the sliced functions: merge straight-line\n"
+                   "blocks, remove empty blocks and fold trivial phi nodes\n"
+                   "(default=false)."),
+    llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 llvm::cl::opt<std::string> annotationOpts("annotate",
     llvm::cl::desc("Save annotated version of module as a text (.ll).\n"
                    "(dd: data dependencies, cd:control dependencies,\n"
@@ -137,11 +143,54 @@ public:
 
     void removeUnusedFromModule()
     {
-        bool fixpoint;
+        using namespace llvm;
+        // do not slice away these functions no matter what
+        // FIXME do it a vector and fill it dynamically according
+        // to what is the setup (like for sv-comp or general..)
+        const char *keep[] = {options.dgOptions.entryFunction.c_str()};
+
+        // Erase the unused globals and queue the globals that they used,
+        // because these may have become unused. This way we do not need
+        // to scan the whole module again after erasing something.
+        ADT::QueueLIFO<GlobalValue *> queue;
+        std::set<GlobalValue *> queued;
+
+        auto enqueueIfUnused = [&](GlobalValue *gv) {
+            if (isa<Function>(gv) && array_match(gv->getName(), keep))
+                return;
+
+            // constant expressions that are not used anymore
+            // still use the global
+            gv->removeDeadConstantUsers();
+            if (gv->hasNUses(0) && queued.insert(gv).second)
+                queue.push(gv);
+        };
+
+        for (Function& F : *M)
+            enqueueIfUnused(&F);
+        for (GlobalVariable& G : M->globals())
+            enqueueIfUnused(&G);
+        for (GlobalAlias& GA : M->getAliasList())
+            enqueueIfUnused(&GA);
+
+        while (!queue.empty()) {
+            GlobalValue *gv = queue.pop();
+
+            std::set<GlobalValue *> operands;
+            getUsedGlobals(gv, operands);
+
+            if (isa<Function>(gv))
+                ++removedFunctions;
+            else if (isa<GlobalVariable>(gv))
+                ++removedGlobals;
+            gv->eraseFromParent();
 
-        do {
-            fixpoint = _removeUnusedFromModule();
-        } while (fixpoint);
+            for (GlobalValue *op : operands) {
+                // the global may have used itself
+                if (op != gv)
+                    enqueueIfUnused(op);
+            }
+        }
     }
 
     // after we slice the LLVM, we somethimes have troubles
@@ -222,87 +271,115 @@ private:
         return 0;
     }
 
-    bool _removeUnusedFromModule()
+    // get the globals that are used (directly or through
+    // constant expressions) by the body or the initializer of the global
+    static void getUsedGlobals(llvm::GlobalValue *gv,
+                               std::set<llvm::GlobalValue *>& globals)
     {
         using namespace llvm;
-        // do not slice away these functions no matter what
-        // FIXME do it a vector and fill it dynamically according
-        // to what is the setup (like for sv-comp or general..)
-        const char *keep[] = {options.dgOptions.entryFunction.c_str()};
 
-        // when erasing while iterating the slicer crashes
-        // so set the to be erased values into container
-        // and then erase them
-        std::set<Function *> funs;
-        std::set<GlobalVariable *> globals;
-        std::set<GlobalAlias *> aliases;
+        std::set<const Constant *> visited;
+        std::vector<const Constant *> constants;
 
-        for (auto I = M->begin(), E = M->end(); I != E; ++I) {
-            Function *func = &*I;
-            if (array_match(func->getName(), keep))
-                continue;
-
-            // if the function is unused or we haven't constructed it
-            // at all in dependence graph, we can remove it
-            // (it may have some uses though - like when one
-            // unused func calls the other unused func
-            if (func->hasNUses(0))
-                funs.insert(func);
+        auto addOperand = [&](const Value *op) {
+            if (auto C = dyn_cast<Constant>(op)) {
+                if (visited.insert(C).second)
+                    constants.push_back(C);
+            }
+        };
+
+        if (auto F = dyn_cast<Function>(gv)) {
+            for (const BasicBlock& B : *F)
+                for (const Instruction& I : B)
+                    for (const Value *op : I.operands())
+                        addOperand(op);
+        } else if (auto G = dyn_cast<GlobalVariable>(gv)) {
+            if (G->hasInitializer())
+                addOperand(G->getInitializer());
+        } else if (auto GA = dyn_cast<GlobalAlias>(gv)) {
+            addOperand(GA->getAliasee());
         }
 
-        for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I) {
-            GlobalVariable *gv = &*I;
-            if (gv->hasNUses(0))
-                globals.insert(gv);
-        }
+        while (!constants.empty()) {
+            const Constant *C = constants.back();
+            constants.pop_back();
 
-        for (GlobalAlias& ga : M->getAliasList()) {
-            if (ga.hasNUses(0))
-                aliases.insert(&ga);
+            if (auto G = dyn_cast<GlobalValue>(C)) {
+                globals.insert(const_cast<GlobalValue *>(G));
+                continue;
+            }
+
+            for (const Value *op : C->operands())
+                addOperand(op);
         }
+    }
 
-        for (Function *f : funs)
-            f->eraseFromParent();
-        for (GlobalVariable *gv : globals)
-            gv->eraseFromParent();
-        for (GlobalAlias *ga : aliases)
-            ga->eraseFromParent();
+    // the number of erased unused functions and global variables
+    uint64_t removedFunctions{0};
+    uint64_t removedGlobals{0};
 
-        return (!funs.empty() || !globals.empty() || !aliases.empty());
-    }
+public:
+    uint64_t getRemovedFunctionsNum() const { return removedFunctions; }
+    uint64_t getRemovedGlobalsNum() const { return removedGlobals; }
+};
 
+struct ModuleStatistics {
+    uint64_t globals{0};
+    uint64_t functions{0};
+    uint64_t blocks{0};
+    uint64_t instructions{0};
 };
 
-static void maybe_print_statistics(llvm::Module *M, const char *prefix = nullptr)
+static ModuleStatistics maybe_print_statistics(llvm::Module *M,
+                                               const char *prefix = nullptr)
 {
+    ModuleStatistics st;
     if (!statistics)
-        return;
+        return st;
 
     using namespace llvm;
-    uint64_t inum, bnum, fnum, gnum;
-    inum = bnum = fnum = gnum = 0;
 
     for (auto I = M->begin(), E = M->end(); I != E; ++I) {
         // don't count in declarations
         if (I->size() == 0)
             continue;
 
-        ++fnum;
+        ++st.functions;
 
         for (const BasicBlock& B : *I) {
-            ++bnum;
-            inum += B.size();
+            ++st.blocks;
+            st.instructions += B.size();
         }
     }
 
     for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I)
-        ++gnum;
+        ++st.globals;
 
     if (prefix)
         errs() << prefix;
 
     errs() << "Globals/Functions/Blocks/Instr.: "
-           << gnum << " " << fnum << " " << bnum << " " << inum << "\n";
+           << st.globals << " " << st.functions << " "
+           << st.blocks << " " << st.instructions << "\n";
+
+    return st;
+}
+
+static void maybe_print_reduction(const ModuleStatistics& before,
+                                  const ModuleStatistics& after)
+{
+    if (!statistics)
+        return;
+
+    auto percent = [](uint64_t b, uint64_t a) {
+        return b == 0 ? 0.0 : 100.0 * (b - a) / b;
+    };
+
+    errs() << "Reduction of Globals/Functions/Blocks/Instr. (%): "
+           << percent(before.globals, after.globals) << " "
+           << percent(before.functions, after.functions) << " "
+           << percent(before.blocks, after.blocks) << " "
+           << percent(before.instructions, after.instructions) << "\n";
 }
 
 class DGDumper {
@@ -501,7 +578,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    maybe_print_statistics(M.get(), "Statistics before ");
+    auto statsBefore = maybe_print_statistics(M.get(), "Statistics before ");
 
     // remove unused from module, we don't need that
     ModuleWriter writer(options, M.get());
@@ -509,10 +586,21 @@ int main(int argc, char *argv[])
 
     if (remove_unused_only) {
         errs() << "[llvm-slicer] removed unused parts of module, exiting...\n";
-        maybe_print_statistics(M.get(), "Statistics after ");
+        maybe_print_reduction(statsBefore,
+                              maybe_print_statistics(M.get(), "Statistics after "));
         return writer.saveModule(should_verify_module);
     }
 
+    // load the executed code once for all the analyses
+    dg::analysis::ExecutionCoverage coverage;
+    if (!options.coverageFile.empty()) {
+        if (!coverage.load(M.get(), options.coverageFile)) {
+            errs() << "ERROR: Failed loading the coverage\n";
+            return 1;
+        }
+        options.dgOptions.coverage = &coverage;
+    }
+
     /// ---------------
     // slice the code
     /// ---------------
@@ -539,7 +627,9 @@ int main(int argc, char *argv[])
         if (!slicer.createEmptyMain())
             return 1;
 
-        maybe_print_statistics(M.get(), "Statistics after ");
+        writer.removeUnusedFromModule();
+        maybe_print_reduction(statsBefore,
+                              maybe_print_statistics(M.get(), "Statistics after "));
         return writer.cleanAndSaveModule(should_verify_module);
     }
 
@@ -584,8 +674,28 @@ int main(int argc, char *argv[])
         dumper.dumpToDot(".sliced.dot");
     }
 
+    // the dependence graph is not needed anymore,
+    // so we can simplify the CFG of the sliced functions
+    if (compact_cfg) {
+        slicer.compactCFG();
+        if (statistics) {
+            const auto& st = slicer.getCompactionStatistics();
+            errs() << "[llvm-slicer] CFG compaction merged " << st.blocksMerged
+                   << " and removed " << st.blocksRemoved << " blocks, folded "
+                   << st.phisFolded << " phi nodes\n";
+        }
+    }
+
     // remove unused from module again, since slicing
     // could and probably did make some other parts unused
-    maybe_print_statistics(M.get(), "Statistics after ");
+    writer.removeUnusedFromModule();
+    if (statistics) {
+        errs() << "[llvm-slicer] Removed " << writer.getRemovedFunctionsNum()
+               << " unused functions and " << writer.getRemovedGlobalsNum()
+               << " unused globals\n";
+    }
+
+    maybe_print_reduction(statsBefore,
+                          maybe_print_statistics(M.get(), "Statistics after "));
     return writer.cleanAndSaveModule(should_verify_module);
 }
@@ -173,6 +173,16 @@ public:
         return true;
     }
 
+    ///
+    // Simplify the CFG of the sliced functions (merge straight-line
+    // blocks, remove empty blocks, fold trivial phi nodes).
+    // The dependence graph must not be used after calling this method.
+    void compactCFG() { slicer.compactCFG(); }
+
+    const dg::LLVMSlicer::CompactionStatistics& getCompactionStatistics() const {
+        return slicer.getCompactionStatistics();
+    }
+
     ///
     // Create new empty main in the module. If 'call_entry' is set to true,
     // then call the entry function from the new main (if entry is not main),
@@ -52,6 +52,11 @@ int main(int argc, const char *argv[])
                                    cl::desc("<input file>"),
                                    cl::init(""));
 
+    cl::opt<unsigned> workers("workers",
+                              cl::desc("Number of threads that build the graphs of functions"),
+                              cl::value_desc("number"),
+                              cl::init(1));
+
     cl::ParseCommandLineOptions(argc, argv);
 
     std::string module = inputFile;
@@ -71,7 +76,7 @@ int main(int argc, const char *argv[])
     dg::LLVMPointerAnalysis pointsToAnalysis(M.get(), "main", dg::analysis::Offset::UNKNOWN, true);
     pointsToAnalysis.run<dg::analysis::pta::PointerAnalysisFI>();
 
-    ControlFlowGraph controlFlowGraph(&pointsToAnalysis);
+    ControlFlowGraph controlFlowGraph(&pointsToAnalysis, workers);
     controlFlowGraph.buildFunction(M->getFunction("main"));
 
     if (graphvizFileName == "") {